@@ -358,6 +358,12 @@ public:
                         OnResize(e.window.data1, e.window.data2);
                     }
 
+                    if (e.window.event == SDL_WINDOWEVENT_EXPOSED)
+                    {
+                        // The software engine only presents what changed, so have everything redrawn
+                        gfx_invalidate_screen();
+                    }
+
                     switch (e.window.event)
                     {
                         case SDL_WINDOWEVENT_SIZE_CHANGED:
@@ -11,13 +11,17 @@
 
 #include <SDL.h>
 #include <algorithm>
+#include <cstring>
 #include <openrct2/Game.h>
+#include <openrct2/Intro.h>
 #include <openrct2/common.h>
 #include <openrct2/config/Config.h>
 #include <openrct2/core/Guard.hpp>
+#include <openrct2/drawing/Drawing.h>
 #include <openrct2/drawing/IDrawingEngine.h>
 #include <openrct2/drawing/X8DrawingEngine.h>
 #include <openrct2/ui/UiContext.h>
+#include <vector>
 
 using namespace OpenRCT2;
 using namespace OpenRCT2::Drawing;
@@ -32,6 +36,14 @@ private:
     SDL_Surface* _RGBASurface = nullptr;
     SDL_Palette* _palette = nullptr;
 
+    // Regions of the screen buffer that changed since the last frame was presented
+    std::vector<SDL_Rect> _changedRects;
+    bool _allChanged = true;
+
+    // The palette in the pixel format of the surface being presented to
+    uint32_t _paletteLookup[256] = {};
+    uint32_t _paletteLookupFormat = SDL_PIXELFORMAT_UNKNOWN;
+
 public:
     explicit SoftwareDrawingEngine(const std::shared_ptr<IUiContext>& uiContext)
         : X8DrawingEngine(uiContext)
@@ -75,6 +87,8 @@ public:
         }
 
         ConfigureBits(width, height, _surface->pitch);
+        _paletteLookupFormat = SDL_PIXELFORMAT_UNKNOWN;
+        _allChanged = true;
     }
 
     void SetPalette(const GamePalette& palette) override
@@ -90,69 +104,233 @@ public:
                 colours[i].b = palette[i].Blue;
                 colours[i].a = palette[i].Alpha;
             }
-            SDL_SetPaletteColors(_palette, colours, 0, 256);
+
+            // The palette is set every frame for the animated colours, which only change every few frames
+            if (std::memcmp(colours, _palette->colors, sizeof(colours)) != 0)
+            {
+                SDL_SetPaletteColors(_palette, colours, 0, 256);
+                _paletteLookupFormat = SDL_PIXELFORMAT_UNKNOWN;
+                _allChanged = true;
+            }
+        }
+    }
+
+    void BeginDraw() override
+    {
+        // Restoring the pixels under the weather touches the whole screen, as does the intro
+        if (_weatherDrawer.HasPixels() || gIntroState != IntroState::None)
+        {
+            _allChanged = true;
         }
+        X8DrawingEngine::BeginDraw();
     }
 
     void EndDraw() override
     {
+        if (_weatherDrawer.HasPixels())
+        {
+            _allChanged = true;
+        }
+        else
+        {
+            AddDirtyBlocksToChangedRects();
+        }
         Display();
+        _changedRects.clear();
+        _allChanged = false;
+    }
+
+    void CopyRect(int32_t x, int32_t y, int32_t width, int32_t height, int32_t dx, int32_t dy) override
+    {
+        X8DrawingEngine::CopyRect(x, y, width, height, dx, dy);
+        AddChangedRect(x, y, width, height);
+    }
+
+protected:
+    void OnDrawDirtyBlock(uint32_t left, uint32_t top, uint32_t columns, uint32_t rows) override
+    {
+        AddChangedRect(
+            left * _dirtyGrid.BlockWidth, top * _dirtyGrid.BlockHeight, columns * _dirtyGrid.BlockWidth,
+            rows * _dirtyGrid.BlockHeight);
     }
 
 private:
-    void Display()
+    void AddChangedRect(int32_t x, int32_t y, int32_t width, int32_t height)
     {
-        // Lock the surface before setting its pixels
-        if (SDL_MUSTLOCK(_surface))
+        int32_t left = std::max(x, 0);
+        int32_t top = std::max(y, 0);
+        int32_t right = std::min(x + width, static_cast<int32_t>(_width));
+        int32_t bottom = std::min(y + height, static_cast<int32_t>(_height));
+        if (!_allChanged && right > left && bottom > top)
         {
-            if (SDL_LockSurface(_surface) < 0)
+            _changedRects.push_back({ left, top, right - left, bottom - top });
+        }
+    }
+
+    /**
+     * Anything drawn over the windows, such as the chat and the FPS counter, invalidates its area after
+     * drawing so that it is cleaned up next frame. Those blocks have to be presented this frame as well.
+     */
+    void AddDirtyBlocksToChangedRects()
+    {
+        for (uint32_t y = 0; y < _dirtyGrid.BlockRows; y++)
+        {
+            const uint8_t* blocks = &_dirtyGrid.Blocks[y * _dirtyGrid.BlockColumns];
+            for (uint32_t x = 0; x < _dirtyGrid.BlockColumns; x++)
             {
-                log_error("locking failed %s", SDL_GetError());
-                return;
+                if (blocks[x] == 0)
+                {
+                    continue;
+                }
+
+                uint32_t xx = x;
+                while (xx < _dirtyGrid.BlockColumns && blocks[xx] != 0)
+                {
+                    xx++;
+                }
+                AddChangedRect(
+                    x * _dirtyGrid.BlockWidth, y * _dirtyGrid.BlockHeight, (xx - x) * _dirtyGrid.BlockWidth,
+                    _dirtyGrid.BlockHeight);
+                x = xx;
             }
         }
+    }
 
-        // Copy pixels from the virtual screen buffer to the surface
-        std::copy_n(_bits, _surface->pitch * _surface->h, static_cast<uint8_t*>(_surface->pixels));
-
-        // Unlock the surface
-        if (SDL_MUSTLOCK(_surface))
+    void Display()
+    {
+        if (_allChanged)
         {
-            SDL_UnlockSurface(_surface);
+            _changedRects.clear();
+            _changedRects.push_back({ 0, 0, static_cast<int32_t>(_width), static_cast<int32_t>(_height) });
+        }
+        else if (_changedRects.empty())
+        {
+            return;
         }
 
-        // Copy the surface to the window
-        if (gConfigGeneral.window_scale == 1 || gConfigGeneral.window_scale <= 0)
+        // Convert the changed pixels straight into the window, or into the rgba surface when it needs to be scaled
+        bool scaled = gConfigGeneral.window_scale != 1 && gConfigGeneral.window_scale > 0;
+        SDL_Surface* windowSurface = SDL_GetWindowSurface(_window);
+        SDL_Surface* target = scaled ? _RGBASurface : windowSurface;
+        if (target->format->BytesPerPixel == 4)
         {
-            SDL_Surface* windowSurface = SDL_GetWindowSurface(_window);
-            if (SDL_BlitSurface(_surface, nullptr, windowSurface, nullptr))
+            if (!ConvertChangedRects(target))
             {
-                log_fatal("SDL_BlitSurface %s", SDL_GetError());
-                exit(1);
+                return;
             }
         }
-        else
+        else if (!BlitChangedRects(target))
         {
-            // first blit to rgba surface to change the pixel format
-            if (SDL_BlitSurface(_surface, nullptr, _RGBASurface, nullptr))
+            return;
+        }
+
+        if (!scaled)
+        {
+            if (SDL_UpdateWindowSurfaceRects(_window, _changedRects.data(), static_cast<int32_t>(_changedRects.size())))
             {
-                log_fatal("SDL_BlitSurface %s", SDL_GetError());
+                log_fatal("SDL_UpdateWindowSurfaceRects %s", SDL_GetError());
                 exit(1);
             }
-
+        }
+        else
+        {
             // then scale to window size. Without changing to RGBA first, SDL complains
             // about blit configurations being incompatible.
-            if (SDL_BlitScaled(_RGBASurface, nullptr, SDL_GetWindowSurface(_window), nullptr))
+            if (SDL_BlitScaled(_RGBASurface, nullptr, windowSurface, nullptr))
             {
                 log_fatal("SDL_BlitScaled %s", SDL_GetError());
                 exit(1);
             }
+            if (SDL_UpdateWindowSurface(_window))
+            {
+                log_fatal("SDL_UpdateWindowSurface %s", SDL_GetError());
+                exit(1);
+            }
+        }
+    }
+
+    /**
+     * Looks up the colour of each changed pixel, using a table already in the pixel format of the target.
+     */
+    bool ConvertChangedRects(SDL_Surface* target)
+    {
+        if (_paletteLookupFormat != target->format->format)
+        {
+            for (int32_t i = 0; i < 256; i++)
+            {
+                const auto& colour = _palette->colors[i];
+                _paletteLookup[i] = SDL_MapRGB(target->format, colour.r, colour.g, colour.b);
+            }
+            _paletteLookupFormat = target->format->format;
         }
-        if (SDL_UpdateWindowSurface(_window))
+
+        if (SDL_MUSTLOCK(target))
         {
-            log_fatal("SDL_UpdateWindowSurface %s", SDL_GetError());
-            exit(1);
+            if (SDL_LockSurface(target) < 0)
+            {
+                log_error("locking failed %s", SDL_GetError());
+                return false;
+            }
+        }
+
+        auto targetPixels = static_cast<uint8_t*>(target->pixels);
+        int32_t targetStride = target->pitch / 4;
+        for (const auto& rect : _changedRects)
+        {
+            const uint8_t* src = _bits + rect.y * _pitch + rect.x;
+            uint32_t* dst = reinterpret_cast<uint32_t*>(targetPixels + rect.y * target->pitch) + rect.x;
+            palette_lookup_fn(rect.w, rect.h, src, dst, _paletteLookup, _pitch - rect.w, targetStride - rect.w);
+        }
+
+        if (SDL_MUSTLOCK(target))
+        {
+            SDL_UnlockSurface(target);
+        }
+        return true;
+    }
+
+    /**
+     * Lets SDL convert the changed pixels, for targets that are not 32 bits per pixel.
+     */
+    bool BlitChangedRects(SDL_Surface* target)
+    {
+        // Lock the surface before setting its pixels
+        if (SDL_MUSTLOCK(_surface))
+        {
+            if (SDL_LockSurface(_surface) < 0)
+            {
+                log_error("locking failed %s", SDL_GetError());
+                return false;
+            }
+        }
+
+        // Copy pixels from the virtual screen buffer to the surface
+        for (const auto& rect : _changedRects)
+        {
+            for (int32_t y = rect.y; y < rect.y + rect.h; y++)
+            {
+                size_t offset = y * _surface->pitch + rect.x;
+                std::copy_n(_bits + offset, rect.w, static_cast<uint8_t*>(_surface->pixels) + offset);
+            }
+        }
+
+        // Unlock the surface
+        if (SDL_MUSTLOCK(_surface))
+        {
+            SDL_UnlockSurface(_surface);
+        }
+
+        for (const auto& rect : _changedRects)
+        {
+            SDL_Rect srcRect = rect;
+            SDL_Rect dstRect = rect;
+            if (SDL_BlitSurface(_surface, &srcRect, target, &dstRect))
+            {
+                log_fatal("SDL_BlitSurface %s", SDL_GetError());
+                exit(1);
+            }
         }
+        return true;
     }
 };
 
@@ -20,6 +20,7 @@
 #include "Input.h"
 #include "Intro.h"
 #include "OpenRCT2.h"
+#include "ParkFile.h"
 #include "ParkImporter.h"
 #include "PlatformEnvironment.h"
 #include "ReplayManager.h"
@@ -34,6 +35,7 @@
 #include "core/FileStream.h"
 #include "core/Guard.hpp"
 #include "core/Http.h"
+#include "core/MemoryMappedFile.h"
 #include "core/MemoryStream.h"
 #include "core/Path.hpp"
 #include "core/String.hpp"
@@ -165,6 +167,7 @@ namespace OpenRCT2
 
             GameActions::ClearQueue();
             network_close();
+            game_autosave_wait();
             window_close_all();
 
             // Unload objects after closing all windows, this is to overcome windows like
@@ -571,6 +574,13 @@ namespace OpenRCT2
                     }
                     return true;
                 }
+                else if (ParkFileReader::ExtensionIsParkFile(path))
+                {
+                    // Read in place from the mapped file, so only the sections that are read get loaded from disk
+                    auto file = MemoryMappedFile(path);
+                    auto ms = MemoryStream(file.GetData(), file.GetLength());
+                    return LoadParkFromStream(&ms, path, loadTitleScreenOnFail);
+                }
                 else
                 {
                     auto fs = FileStream(path, FILE_MODE_OPEN);
@@ -610,7 +620,7 @@ namespace OpenRCT2
                 }
 
                 std::unique_ptr<IParkImporter> parkImporter;
-                if (info.Version <= FILE_TYPE_S4_CUTOFF)
+                if (!info.IsParkFile && info.Version <= FILE_TYPE_S4_CUTOFF)
                 {
                     // Save is an S4 (RCT1 format)
                     parkImporter = ParkImporter::CreateS4();
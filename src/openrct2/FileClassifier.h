@@ -21,6 +21,7 @@ enum
     FILE_EXTENSION_SC6,
     FILE_EXTENSION_SV6,
     FILE_EXTENSION_TD6,
+    FILE_EXTENSION_PARK,
 };
 
 #include <string>
@@ -43,6 +44,8 @@ struct ClassifiedFileInfo
 {
     FILE_TYPE Type = FILE_TYPE::UNDEFINED;
     uint32_t Version = 0;
+    // The native park format, where Version is the park file version rather than an RCT1 or RCT2 one
+    bool IsParkFile = false;
 };
 
 #define FILE_TYPE_S4_CUTOFF 2
@@ -41,6 +41,7 @@
 #include "peep/Staff.h"
 #include "platform/Platform2.h"
 #include "rct1/RCT1.h"
+#include "rct2/S6Exporter.h"
 #include "ride/Ride.h"
 #include "ride/RideRatings.h"
 #include "ride/Station.h"
@@ -64,11 +65,14 @@
 #include "world/Park.h"
 #include "world/Scenery.h"
 #include "world/Sprite.h"
+#include "world/StateHash.h"
 #include "world/Surface.h"
 #include "world/Water.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cstdio>
+#include <future>
 #include <iterator>
 #include <memory>
 
@@ -86,6 +90,8 @@ bool gLoadKeepWindowsOpen = false;
 uint32_t gCurrentTicks;
 uint32_t gCurrentRealTimeTicks;
 
+static std::future<bool> _autosaveFuture;
+
 rct_string_id gGameCommandErrorTitle;
 rct_string_id gGameCommandErrorText;
 
@@ -523,6 +529,7 @@ void game_load_init()
 
     IGameStateSnapshots* snapshots = GetContext()->GetGameStateSnapshots();
     snapshots->Reset();
+    state_hash_reset();
 
     gScreenFlags = SCREEN_FLAGS_PLAYING;
     OpenRCT2::Audio::StopAll();
@@ -657,17 +664,14 @@ void save_game_as()
     delete intent;
 }
 
-static void limit_autosave_count(const size_t numberOfFilesToKeep, bool processLandscapeFolder)
+static void limit_autosave_count(const std::string& folderDirectory, const size_t numberOfFilesToKeep, bool processLandscapeFolder)
 {
     size_t autosavesCount = 0;
     size_t numAutosavesToDelete = 0;
 
-    auto environment = GetContext()->GetPlatformEnvironment();
-    auto folderDirectory = environment->GetDirectoryPath(DIRBASE::USER, DIRID::SAVE);
     char const* fileFilter = "autosave_*.sv6";
     if (processLandscapeFolder)
     {
-        folderDirectory = environment->GetDirectoryPath(DIRBASE::USER, DIRID::LANDSCAPE);
         fileFilter = "autosave_*.sc6";
     }
 
@@ -726,12 +730,12 @@ void game_autosave()
 {
     const char* subDirectory = "save";
     const char* fileExtension = ".sv6";
-    uint32_t saveFlags = 0x80000000;
+    bool isLandscape = false;
     if (gScreenFlags & SCREEN_FLAGS_EDITOR)
     {
         subDirectory = "landscape";
         fileExtension = ".sc6";
-        saveFlags |= 2;
+        isLandscape = true;
     }
 
     // Retrieve current time
@@ -743,8 +747,9 @@ void game_autosave()
         timeName, sizeof(timeName), "autosave_%04u-%02u-%02u_%02u-%02u-%02u%s", currentDate.year, currentDate.month,
         currentDate.day, currentTime.hour, currentTime.minute, currentTime.second, fileExtension);
 
+    auto environment = GetContext()->GetPlatformEnvironment();
+    auto folderDirectory = environment->GetDirectoryPath(DIRBASE::USER, isLandscape ? DIRID::LANDSCAPE : DIRID::SAVE);
     int32_t autosavesToKeep = gConfigGeneral.autosave_amount;
-    limit_autosave_count(autosavesToKeep - 1, (gScreenFlags & SCREEN_FLAGS_EDITOR));
 
     utf8 path[MAX_PATH];
     utf8 backupPath[MAX_PATH];
@@ -757,13 +762,77 @@ void game_autosave()
     safe_strcat(backupPath, fileExtension, sizeof(backupPath));
     safe_strcat(backupPath, ".bak", sizeof(backupPath));
 
-    if (Platform::FileExists(path))
+    // Autosaves are written one at a time, so the old files are pruned in the right order
+    game_autosave_wait();
+
+    // Only copying the park into the exporter happens on this thread, encoding and writing the file is left to the
+    // autosave thread so the game does not stall on large parks. Anything that needs the object repository is done
+    // here as well, as the repository is not thread safe.
+    viewport_set_saved_view();
+    auto exporter = std::make_shared<S6Exporter>();
+    try
+    {
+        exporter->RemoveTracklessRides = true;
+        exporter->Export();
+        exporter->ExportPackedObjects();
+    }
+    catch (const std::exception& e)
+    {
+        log_error("Unable to save park: '%s'", e.what());
+        Console::Error::WriteLine("Could not autosave the scenario. Is the save folder writeable?");
+        return;
+    }
+    gfx_invalidate_screen();
+
+    _autosaveFuture = std::async(
+        std::launch::async,
+        [exporter = std::move(exporter), folderDirectory = std::move(folderDirectory), path = std::string(path),
+         backupPath = std::string(backupPath), autosavesToKeep, isLandscape]() -> bool {
+            limit_autosave_count(folderDirectory, autosavesToKeep - 1, isLandscape);
+
+            if (Platform::FileExists(path))
+            {
+                platform_file_copy(path.c_str(), backupPath.c_str(), true);
+            }
+
+            try
+            {
+                if (isLandscape)
+                {
+                    exporter->SaveScenario(path.c_str());
+                }
+                else
+                {
+                    exporter->SaveGame(path.c_str());
+                }
+                log_verbose("Autosaved to %s", path.c_str());
+                return true;
+            }
+            catch (const std::exception& e)
+            {
+                log_error("Unable to save park: '%s'", e.what());
+                return false;
+            }
+        });
+}
+
+/**
+ * Reports the result of the autosave running in the background once it has finished.
+ */
+void game_autosave_update()
+{
+    if (_autosaveFuture.valid() && _autosaveFuture.wait_for(std::chrono::seconds::zero()) == std::future_status::ready)
     {
-        platform_file_copy(path, backupPath, true);
+        game_autosave_wait();
     }
+}
 
-    if (!scenario_save(path, saveFlags))
+void game_autosave_wait()
+{
+    if (_autosaveFuture.valid() && !_autosaveFuture.get())
+    {
         Console::Error::WriteLine("Could not autosave the scenario. Is the save folder writeable?");
+    }
 }
 
 static void game_load_or_quit_no_save_prompt_callback(int32_t result, const utf8* path)
@@ -38,6 +38,7 @@
 #include "world/Park.h"
 #include "world/Scenery.h"
 #include "world/Sprite.h"
+#include "world/StateHash.h"
 
 #include <algorithm>
 #include <chrono>
@@ -245,10 +246,13 @@ void GameState::UpdateLogic(LogicTimings* timings)
 {
     auto start_time = std::chrono::high_resolution_clock::now();
 
-    auto report_time = [timings, start_time](LogicTimePart part) {
+    // Records the time spent in each part since the previous part was reported
+    auto report_time = [timings, &start_time](LogicTimePart part) {
         if (timings != nullptr)
         {
-            timings->TimingInfo[part][timings->CurrentIdx] = std::chrono::high_resolution_clock::now() - start_time;
+            auto now = std::chrono::high_resolution_clock::now();
+            timings->TimingInfo[part][timings->CurrentIdx] = now - start_time;
+            start_time = now;
         }
     };
 
@@ -283,6 +287,12 @@ void GameState::UpdateLogic(LogicTimings* timings)
         bool desynced = network_check_desynchronisation();
         if (desynced)
         {
+            // Find out which entities and map regions differ from the server's
+            if (network_get_status() == NETWORK_STATUS_CONNECTED)
+            {
+                network_request_state_hash();
+            }
+
             // If desync debugging is enabled and we are still connected request the specific game state from server.
             if (network_gamestate_snapshots_enabled() && network_get_status() == NETWORK_STATUS_CONNECTED)
             {
@@ -316,6 +326,12 @@ void GameState::UpdateLogic(LogicTimings* timings)
     report_time(LogicTimePart::MapStashProvisionalElements);
     map_update_path_wide_flags();
     report_time(LogicTimePart::MapPathWideFlags);
+    // Hashed while the provisional elements are removed, so every peer hashes the same state
+    if (network_get_mode() != NETWORK_MODE_NONE || GetContext()->GetReplayManager()->UsesStateHash())
+    {
+        state_hash_update();
+    }
+    report_time(LogicTimePart::StateHash);
     peep_update_all();
     report_time(LogicTimePart::Peep);
     map_restore_provisional_elements();
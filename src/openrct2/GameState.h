@@ -30,6 +30,7 @@ namespace OpenRCT2
         MapTiles,
         MapStashProvisionalElements,
         MapPathWideFlags,
+        StateHash,
         Peep,
         MapRestoreProvisionalElements,
         Vehicle,
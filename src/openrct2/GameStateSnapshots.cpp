@@ -21,9 +21,60 @@
 #include "world/Particle.h"
 #include "world/Sprite.h"
 
+#include <cstring>
+
 static constexpr size_t MaximumGameStateSnapshots = 32;
 static constexpr uint32_t InvalidTick = 0xFFFFFFFF;
 
+static void SerialiseSprite(rct_sprite& sprite, DataSerialiser& ds)
+{
+    ds << sprite.base.Type;
+
+    switch (sprite.base.Type)
+    {
+        case EntityType::Vehicle:
+            reinterpret_cast<Vehicle&>(sprite).Serialise(ds);
+            break;
+        case EntityType::Guest:
+            reinterpret_cast<Guest&>(sprite).Serialise(ds);
+            break;
+        case EntityType::Staff:
+            reinterpret_cast<Staff&>(sprite).Serialise(ds);
+            break;
+        case EntityType::Litter:
+            reinterpret_cast<Litter&>(sprite).Serialise(ds);
+            break;
+        case EntityType::MoneyEffect:
+            reinterpret_cast<MoneyEffect&>(sprite).Serialise(ds);
+            break;
+        case EntityType::Balloon:
+            reinterpret_cast<Balloon&>(sprite).Serialise(ds);
+            break;
+        case EntityType::Duck:
+            reinterpret_cast<Duck&>(sprite).Serialise(ds);
+            break;
+        case EntityType::JumpingFountain:
+            reinterpret_cast<JumpingFountain&>(sprite).Serialise(ds);
+            break;
+        case EntityType::SteamParticle:
+            reinterpret_cast<SteamParticle&>(sprite).Serialise(ds);
+            break;
+        case EntityType::Null:
+            break;
+        default:
+            break;
+    }
+}
+
+// Where the serialised data of a sprite is within a snapshot
+struct GameStateSnapshotSprite_t
+{
+    uint32_t spriteIndex;
+    EntityType type;
+    uint32_t offset;
+    uint32_t length;
+};
+
 struct GameStateSnapshot_t
 {
     GameStateSnapshot_t& operator=(GameStateSnapshot_t&& mv) noexcept
@@ -40,10 +91,16 @@ struct GameStateSnapshot_t
     OpenRCT2::MemoryStream parkParameters;
 
     // Must pass a function that can access the sprite.
-    void SerialiseSprites(std::function<rct_sprite*(const size_t)> getEntity, const size_t numSprites, bool saving)
+    void SerialiseSprites(
+        std::function<rct_sprite*(const size_t)> getEntity, const size_t numSprites, bool saving,
+        std::vector<GameStateSnapshotSprite_t>* spriteTable = nullptr)
     {
         const bool loading = !saving;
 
+        if (saving)
+        {
+            storedSprites.Clear();
+        }
         storedSprites.SetPosition(0);
         DataSerialiser ds(saving, storedSprites);
 
@@ -82,46 +139,36 @@ struct GameStateSnapshot_t
                 log_error("Entity index corrupted!");
                 return;
             }
-            auto& sprite = *entity;
-
-            ds << sprite.base.Type;
 
-            switch (sprite.base.Type)
+            const auto offset = static_cast<uint32_t>(storedSprites.GetPosition());
+            SerialiseSprite(*entity, ds);
+            if (spriteTable != nullptr)
             {
-                case EntityType::Vehicle:
-                    reinterpret_cast<Vehicle&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::Guest:
-                    reinterpret_cast<Guest&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::Staff:
-                    reinterpret_cast<Staff&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::Litter:
-                    reinterpret_cast<Litter&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::MoneyEffect:
-                    reinterpret_cast<MoneyEffect&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::Balloon:
-                    reinterpret_cast<Balloon&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::Duck:
-                    reinterpret_cast<Duck&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::JumpingFountain:
-                    reinterpret_cast<JumpingFountain&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::SteamParticle:
-                    reinterpret_cast<SteamParticle&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::Null:
-                    break;
-                default:
-                    break;
+                const auto length = static_cast<uint32_t>(storedSprites.GetPosition()) - offset;
+                spriteTable->push_back({ spriteIdx, entity->base.Type, offset, length });
             }
         }
     }
+
+    // Reads the sprite that was stored at the given position back into sprite
+    void LoadSprite(const GameStateSnapshotSprite_t& entry, rct_sprite& sprite)
+    {
+        storedSprites.SetPosition(entry.offset);
+        DataSerialiser ds(false, storedSprites);
+        SerialiseSprite(sprite, ds);
+    }
+
+    bool SpriteDataEquals(
+        const GameStateSnapshotSprite_t& entry, const GameStateSnapshot_t& other,
+        const GameStateSnapshotSprite_t& otherEntry) const
+    {
+        if (entry.length != otherEntry.length)
+            return false;
+
+        const auto* data = static_cast<const uint8_t*>(storedSprites.GetData());
+        const auto* otherData = static_cast<const uint8_t*>(other.storedSprites.GetData());
+        return std::memcmp(data + entry.offset, otherData + otherEntry.offset, entry.length) == 0;
+    }
 };
 
 struct GameStateSnapshots final : public IGameStateSnapshots
@@ -133,7 +180,20 @@ struct GameStateSnapshots final : public IGameStateSnapshots
 
     virtual GameStateSnapshot_t& CreateSnapshot() override final
     {
-        auto snapshot = std::make_unique<GameStateSnapshot_t>();
+        std::unique_ptr<GameStateSnapshot_t> snapshot;
+        if (_snapshots.size() == _snapshots.capacity())
+        {
+            // The oldest snapshot is about to be dropped, reuse it along with the memory its streams have allocated.
+            snapshot = std::move(_snapshots.front());
+            snapshot->tick = InvalidTick;
+            snapshot->srand0 = 0;
+            snapshot->storedSprites.Clear();
+            snapshot->parkParameters.Clear();
+        }
+        else
+        {
+            snapshot = std::make_unique<GameStateSnapshot_t>();
+        }
         _snapshots.push_back(std::move(snapshot));
 
         return *_snapshots.back();
@@ -171,20 +231,15 @@ struct GameStateSnapshots final : public IGameStateSnapshots
         ds << snapshot.parkParameters;
     }
 
-    std::vector<rct_sprite> BuildSpriteList(GameStateSnapshot_t& snapshot) const
+    std::vector<GameStateSnapshotSprite_t> BuildSpriteTable(GameStateSnapshot_t& snapshot) const
     {
-        std::vector<rct_sprite> spriteList;
-        spriteList.resize(MAX_ENTITIES);
-
-        for (auto& sprite : spriteList)
-        {
-            // By default they don't exist.
-            sprite.base.Type = EntityType::Null;
-        }
+        std::vector<GameStateSnapshotSprite_t> spriteTable;
 
-        snapshot.SerialiseSprites([&spriteList](const size_t index) { return &spriteList[index]; }, MAX_ENTITIES, false);
+        // Only the layout of the stored data is wanted, so every sprite can be read into the same scratch sprite.
+        auto scratch = std::make_unique<rct_sprite>();
+        snapshot.SerialiseSprites([&scratch](const size_t) { return scratch.get(); }, MAX_ENTITIES, false, &spriteTable);
 
-        return spriteList;
+        return spriteTable;
     }
 
 #define COMPARE_FIELD(struc, field)                                                                                            \
@@ -576,39 +631,66 @@ struct GameStateSnapshots final : public IGameStateSnapshots
         res.srand0Left = base.srand0;
         res.srand0Right = cmp.srand0;
 
-        std::vector<rct_sprite> spritesBase = BuildSpriteList(const_cast<GameStateSnapshot_t&>(base));
-        std::vector<rct_sprite> spritesCmp = BuildSpriteList(const_cast<GameStateSnapshot_t&>(cmp));
+        auto& snapshotBase = const_cast<GameStateSnapshot_t&>(base);
+        auto& snapshotCmp = const_cast<GameStateSnapshot_t&>(cmp);
+        const auto spritesBase = BuildSpriteTable(snapshotBase);
+        const auto spritesCmp = BuildSpriteTable(snapshotCmp);
 
-        for (uint32_t i = 0; i < static_cast<uint32_t>(spritesBase.size()); i++)
+        // Both tables are ordered by sprite index
+        auto itBase = spritesBase.begin();
+        auto itCmp = spritesCmp.begin();
+        res.spriteChanges.reserve(MAX_ENTITIES);
+        for (uint32_t i = 0; i < MAX_ENTITIES; i++)
         {
             GameStateSpriteChange_t changeData;
             changeData.spriteIndex = i;
 
-            const rct_sprite& spriteBase = spritesBase[i];
-            const rct_sprite& spriteCmp = spritesCmp[i];
+            const GameStateSnapshotSprite_t* entryBase = nullptr;
+            if (itBase != spritesBase.end() && itBase->spriteIndex == i)
+            {
+                entryBase = &*itBase++;
+            }
+            const GameStateSnapshotSprite_t* entryCmp = nullptr;
+            if (itCmp != spritesCmp.end() && itCmp->spriteIndex == i)
+            {
+                entryCmp = &*itCmp++;
+            }
 
-            changeData.entityType = spriteBase.base.Type;
+            const auto typeBase = entryBase != nullptr ? entryBase->type : EntityType::Null;
+            const auto typeCmp = entryCmp != nullptr ? entryCmp->type : EntityType::Null;
 
-            if (spriteBase.base.Type == EntityType::Null && spriteCmp.base.Type != EntityType::Null)
+            changeData.entityType = typeBase;
+
+            if (typeBase == EntityType::Null && typeCmp != EntityType::Null)
             {
                 // Sprite was added.
                 changeData.changeType = GameStateSpriteChange_t::ADDED;
-                changeData.entityType = spriteCmp.base.Type;
+                changeData.entityType = typeCmp;
             }
-            else if (spriteBase.base.Type != EntityType::Null && spriteCmp.base.Type == EntityType::Null)
+            else if (typeBase != EntityType::Null && typeCmp == EntityType::Null)
             {
                 // Sprite was removed.
                 changeData.changeType = GameStateSpriteChange_t::REMOVED;
-                changeData.entityType = spriteBase.base.Type;
+                changeData.entityType = typeBase;
             }
-            else if (spriteBase.base.Type == EntityType::Null && spriteCmp.base.Type == EntityType::Null)
+            else if (typeBase == EntityType::Null && typeCmp == EntityType::Null)
             {
                 // Do nothing.
                 changeData.changeType = GameStateSpriteChange_t::EQUAL;
             }
+            else if (snapshotBase.SpriteDataEquals(*entryBase, snapshotCmp, *entryCmp))
+            {
+                // Identical data can not produce any differences, so there is no need to load and compare it.
+                changeData.changeType = GameStateSpriteChange_t::EQUAL;
+            }
             else
             {
-                CompareSpriteData(spriteBase, spriteCmp, changeData);
+                auto spriteBase = std::make_unique<rct_sprite>();
+                auto spriteCmp = std::make_unique<rct_sprite>();
+                snapshotBase.LoadSprite(*entryBase, *spriteBase);
+                snapshotCmp.LoadSprite(*entryCmp, *spriteCmp);
+
+                CompareSpriteData(*spriteBase, *spriteCmp, changeData);
                 if (changeData.diffs.size() == 0)
                 {
                     changeData.changeType = GameStateSpriteChange_t::EQUAL;
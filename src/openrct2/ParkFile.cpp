@@ -0,0 +1,423 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "ParkFile.h"
+
+#include "core/DataSerialiser.h"
+#include "core/IStream.hpp"
+#include "core/JobPool.h"
+#include "core/MemoryMappedFile.h"
+#include "core/MemoryStream.h"
+#include "core/Path.hpp"
+#include "core/String.hpp"
+#include "scenario/Scenario.h"
+#include "zlib.h"
+
+#include <array>
+#include <cstring>
+#include <exception>
+
+// Most of the park is the same few bytes over and over, where higher levels compress little better but much slower
+constexpr int32_t ParkFileCompressionLevel = Z_BEST_SPEED;
+
+struct ParkFileS6Range
+{
+    ParkFileSection Section;
+    size_t Offset;
+    size_t Length;
+};
+
+using ParkFileS6Ranges = std::array<ParkFileS6Range, 5>;
+
+/**
+ * Returns the parts of rct_s6_data with their own section, in the order they are in rct_s6_data.
+ */
+static ParkFileS6Ranges GetS6Ranges(const rct_s6_data& s6)
+{
+    const auto* s6Data = reinterpret_cast<const uint8_t*>(&s6);
+    auto offsetOf = [s6Data](const void* field) { return static_cast<size_t>(static_cast<const uint8_t*>(field) - s6Data); };
+    return { {
+        { ParkFileSection::Objects, offsetOf(s6.objects), sizeof(s6.objects) },
+        { ParkFileSection::Tiles, offsetOf(s6.tile_elements), sizeof(s6.tile_elements) },
+        { ParkFileSection::Entities, offsetOf(s6.sprites), offsetOf(&s6.park_name) - offsetOf(s6.sprites) },
+        // The banner texts are in the user strings that follow the banners
+        { ParkFileSection::Banners, offsetOf(s6.banners), offsetOf(&s6.game_ticks_1) - offsetOf(s6.banners) },
+        { ParkFileSection::Rides, offsetOf(s6.rides), sizeof(s6.rides) },
+    } };
+}
+
+static size_t GetParkSectionLength(const ParkFileS6Ranges& ranges)
+{
+    size_t length = sizeof(rct_s6_data);
+    for (const auto& range : ranges)
+    {
+        length -= range.Length;
+    }
+    return length;
+}
+
+/**
+ * Calls copyFn for each part of rct_s6_data between the ranges with their own section, with where the part is in
+ * rct_s6_data and in the park section.
+ */
+template<typename TCopyFn> static void ForEachParkSectionPart(const ParkFileS6Ranges& ranges, TCopyFn&& copyFn)
+{
+    size_t s6Offset = 0;
+    size_t parkOffset = 0;
+    for (const auto& range : ranges)
+    {
+        copyFn(s6Offset, parkOffset, range.Offset - s6Offset);
+        parkOffset += range.Offset - s6Offset;
+        s6Offset = range.Offset + range.Length;
+    }
+    copyFn(s6Offset, parkOffset, sizeof(rct_s6_data) - s6Offset);
+}
+
+static void SerialisePreview(DataSerialiser& ds, ParkPreview& preview)
+{
+    ds << preview.Type;
+    ds << preview.ParkName;
+    ds << preview.ScenarioName;
+    ds << preview.ScenarioDetails;
+    ds << preview.Category;
+    ds << preview.ObjectiveType;
+    ds << preview.ObjectiveArg1;
+    ds << preview.ObjectiveArg2;
+    ds << preview.ObjectiveArg3;
+    ds << preview.MonthsElapsed;
+    ds << preview.Cash;
+    ds << preview.NumGuests;
+    ds << preview.ParkRating;
+    ds << preview.MapSize;
+}
+
+ParkFileWriter::ParkFileWriter(uint8_t type)
+    : _type(type)
+{
+}
+
+void ParkFileWriter::AddSection(ParkFileSection id, std::vector<uint8_t>&& data, bool compress)
+{
+    auto& section = _sections.emplace_back();
+    section.Id = id;
+    section.Compress = compress;
+    section.OwnedData = std::move(data);
+    section.Data = section.OwnedData.data();
+    section.Length = section.OwnedData.size();
+}
+
+void ParkFileWriter::AddSection(ParkFileSection id, const void* data, size_t length, bool compress)
+{
+    auto& section = _sections.emplace_back();
+    section.Id = id;
+    section.Compress = compress;
+    section.Data = static_cast<const uint8_t*>(data);
+    section.Length = length;
+}
+
+void ParkFileWriter::AddPreview(const ParkPreview& preview)
+{
+    OpenRCT2::MemoryStream ms;
+    DataSerialiser ds(true, ms);
+    auto copy = preview;
+    SerialisePreview(ds, copy);
+
+    // Not compressed, so reading the preview only touches the start of the file
+    const auto* data = static_cast<const uint8_t*>(ms.GetData());
+    AddSection(ParkFileSection::Preview, std::vector<uint8_t>(data, data + ms.GetLength()), false);
+}
+
+void ParkFileWriter::AddS6Data(const rct_s6_data& s6)
+{
+    const auto* s6Data = reinterpret_cast<const uint8_t*>(&s6);
+    const auto ranges = GetS6Ranges(s6);
+    for (const auto& range : ranges)
+    {
+        AddSection(range.Section, s6Data + range.Offset, range.Length);
+    }
+
+    std::vector<uint8_t> park(GetParkSectionLength(ranges));
+    ForEachParkSectionPart(ranges, [s6Data, &park](size_t s6Offset, size_t parkOffset, size_t length) {
+        std::memcpy(park.data() + parkOffset, s6Data + s6Offset, length);
+    });
+    AddSection(ParkFileSection::Park, std::move(park));
+}
+
+void ParkFileWriter::Write(OpenRCT2::IStream* stream) const
+{
+    struct EncodedSection
+    {
+        ParkFileSectionEntry Entry;
+        std::unique_ptr<uint8_t[]> Buffer;
+        const uint8_t* Data;
+    };
+
+    // The sections are compressed independently, so compress them all at once
+    std::vector<EncodedSection> encodedSections(_sections.size());
+    JobPool jobPool;
+    jobPool.ParallelFor(
+        0, _sections.size(),
+        [this, &encodedSections](size_t i) {
+            const auto& section = _sections[i];
+            auto& encoded = encodedSections[i];
+            encoded.Entry = {};
+            encoded.Entry.Id = section.Id;
+            encoded.Entry.Compression = ParkFileCompression::None;
+            encoded.Entry.Length = section.Length;
+            encoded.Entry.UncompressedLength = section.Length;
+            encoded.Data = section.Data;
+            if (section.Compress && section.Length != 0)
+            {
+                auto compressedLength = compressBound(static_cast<uLong>(section.Length));
+                // Not value initialised, zlib writes every byte it returns
+                auto buffer = std::unique_ptr<uint8_t[]>(new uint8_t[compressedLength]);
+                auto result = compress2(
+                    buffer.get(), &compressedLength, section.Data, static_cast<uLong>(section.Length),
+                    ParkFileCompressionLevel);
+                // Sections that do not get smaller are stored as they are
+                if (result == Z_OK && compressedLength < section.Length)
+                {
+                    encoded.Entry.Compression = ParkFileCompression::Zlib;
+                    encoded.Entry.Length = compressedLength;
+                    encoded.Buffer = std::move(buffer);
+                    encoded.Data = encoded.Buffer.get();
+                }
+            }
+            encoded.Entry.Checksum = static_cast<uint32_t>(
+                crc32(0, encoded.Data, static_cast<uInt>(encoded.Entry.Length)));
+        },
+        1);
+
+    ParkFileHeader header{};
+    header.Magic = PARK_FILE_MAGIC;
+    header.Version = PARK_FILE_CURRENT_VERSION;
+    header.MinVersion = PARK_FILE_MIN_VERSION;
+    header.Type = _type;
+    header.NumSections = static_cast<uint32_t>(encodedSections.size());
+    stream->WriteValue(header);
+
+    uint64_t offset = sizeof(ParkFileHeader) + encodedSections.size() * sizeof(ParkFileSectionEntry);
+    for (auto& encoded : encodedSections)
+    {
+        encoded.Entry.Offset = offset;
+        offset += encoded.Entry.Length;
+        stream->WriteValue(encoded.Entry);
+    }
+    for (const auto& encoded : encodedSections)
+    {
+        stream->Write(encoded.Data, encoded.Entry.Length);
+    }
+}
+
+ParkFileReader::ParkFileReader(const std::string& path)
+    : _file(std::make_unique<OpenRCT2::MemoryMappedFile>(path))
+{
+    _data = _file->GetData();
+    _length = _file->GetLength();
+    ReadTable();
+}
+
+ParkFileReader::ParkFileReader(OpenRCT2::IStream* stream)
+{
+    const auto position = stream->GetPosition();
+    const auto length = static_cast<size_t>(stream->GetLength() - position);
+    const auto* streamData = static_cast<const uint8_t*>(stream->GetData());
+    if (streamData != nullptr)
+    {
+        _data = streamData + position;
+    }
+    else
+    {
+        _buffer.resize(length);
+        stream->Read(_buffer.data(), length);
+        _data = _buffer.data();
+    }
+    _length = length;
+    stream->SetPosition(position + length);
+    ReadTable();
+}
+
+ParkFileReader::~ParkFileReader() = default;
+
+bool ParkFileReader::IsParkFile(OpenRCT2::IStream* stream)
+{
+    const auto position = stream->GetPosition();
+    uint32_t magic = 0;
+    const bool isParkFile = stream->TryRead(&magic, sizeof(magic)) == sizeof(magic) && magic == PARK_FILE_MAGIC;
+    stream->SetPosition(position);
+    return isParkFile;
+}
+
+bool ParkFileReader::ExtensionIsParkFile(const std::string& path)
+{
+    return String::Equals(Path::GetExtension(path), ".park", true);
+}
+
+void ParkFileReader::ReadTable()
+{
+    if (_length < sizeof(ParkFileHeader))
+    {
+        throw IOException("Park file is truncated.");
+    }
+    std::memcpy(&_header, _data, sizeof(ParkFileHeader));
+    if (_header.Magic != PARK_FILE_MAGIC)
+    {
+        throw IOException("Not a park file.");
+    }
+    if (_header.MinVersion > PARK_FILE_CURRENT_VERSION)
+    {
+        throw IOException("Park file is from a newer version of OpenRCT2.");
+    }
+
+    const size_t tableOffset = sizeof(ParkFileHeader);
+    if (_header.NumSections > (_length - tableOffset) / sizeof(ParkFileSectionEntry))
+    {
+        throw IOException("Park file is truncated.");
+    }
+    _sections.resize(_header.NumSections);
+    std::memcpy(_sections.data(), _data + tableOffset, _sections.size() * sizeof(ParkFileSectionEntry));
+    for (const auto& entry : _sections)
+    {
+        if (entry.Offset > _length || entry.Length > _length - entry.Offset)
+        {
+            throw IOException("Park file is truncated.");
+        }
+    }
+}
+
+const ParkFileSectionEntry* ParkFileReader::FindSection(ParkFileSection id) const
+{
+    for (const auto& entry : _sections)
+    {
+        if (entry.Id == id)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool ParkFileReader::HasSection(ParkFileSection id) const
+{
+    return FindSection(id) != nullptr;
+}
+
+const uint8_t* ParkFileReader::GetCheckedSectionData(const ParkFileSectionEntry& entry) const
+{
+    const auto* data = _data + entry.Offset;
+    if (crc32(0, data, static_cast<uInt>(entry.Length)) != entry.Checksum)
+    {
+        throw IOException(String::StdFormat("Park file section %u is damaged.", static_cast<uint32_t>(entry.Id)));
+    }
+    return data;
+}
+
+std::vector<uint8_t> ParkFileReader::ReadSection(ParkFileSection id) const
+{
+    const auto* entry = FindSection(id);
+    if (entry == nullptr)
+    {
+        throw IOException(String::StdFormat("Park file has no section %u.", static_cast<uint32_t>(id)));
+    }
+    std::vector<uint8_t> result(static_cast<size_t>(entry->UncompressedLength));
+    ReadSection(id, result.data(), result.size());
+    return result;
+}
+
+void ParkFileReader::ReadSection(ParkFileSection id, void* dst, size_t length) const
+{
+    const auto* entry = FindSection(id);
+    if (entry == nullptr)
+    {
+        throw IOException(String::StdFormat("Park file has no section %u.", static_cast<uint32_t>(id)));
+    }
+    if (entry->UncompressedLength != length)
+    {
+        throw IOException(String::StdFormat("Park file section %u has the wrong length.", static_cast<uint32_t>(id)));
+    }
+
+    const auto* data = GetCheckedSectionData(*entry);
+    switch (entry->Compression)
+    {
+        case ParkFileCompression::None:
+            std::memcpy(dst, data, length);
+            break;
+        case ParkFileCompression::Zlib:
+        {
+            auto uncompressedLength = static_cast<uLongf>(length);
+            auto result = uncompress(
+                static_cast<Bytef*>(dst), &uncompressedLength, data, static_cast<uLong>(entry->Length));
+            if (result != Z_OK || uncompressedLength != length)
+            {
+                throw IOException(String::StdFormat("Park file section %u is damaged.", static_cast<uint32_t>(id)));
+            }
+            break;
+        }
+        default:
+            throw IOException(
+                String::StdFormat("Park file section %u uses an unknown compression.", static_cast<uint32_t>(id)));
+    }
+}
+
+ParkPreview ParkFileReader::ReadPreview() const
+{
+    auto data = ReadSection(ParkFileSection::Preview);
+    OpenRCT2::MemoryStream ms(data.data(), data.size());
+    DataSerialiser ds(false, ms);
+    ParkPreview preview;
+    SerialisePreview(ds, preview);
+    return preview;
+}
+
+void ParkFileReader::ReadS6Data(rct_s6_data& s6) const
+{
+    auto* s6Data = reinterpret_cast<uint8_t*>(&s6);
+    const auto ranges = GetS6Ranges(s6);
+
+    // Each section is decompressed into its own part of the S6 data, so all of them can be read at once. The jobs
+    // can not throw, so the first error is thrown once they are done.
+    std::array<std::exception_ptr, std::tuple_size_v<ParkFileS6Ranges> + 1> errors;
+    JobPool jobPool;
+    jobPool.ParallelFor(
+        0, errors.size(),
+        [this, s6Data, &ranges, &errors](size_t i) {
+            try
+            {
+                if (i < ranges.size())
+                {
+                    const auto& range = ranges[i];
+                    ReadSection(range.Section, s6Data + range.Offset, range.Length);
+                }
+                else
+                {
+                    auto park = ReadSection(ParkFileSection::Park);
+                    if (park.size() != GetParkSectionLength(ranges))
+                    {
+                        throw IOException("Park file section has the wrong length.");
+                    }
+                    ForEachParkSectionPart(ranges, [s6Data, &park](size_t s6Offset, size_t parkOffset, size_t length) {
+                        std::memcpy(s6Data + s6Offset, park.data() + parkOffset, length);
+                    });
+                }
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        },
+        1);
+
+    for (const auto& error : errors)
+    {
+        if (error != nullptr)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+}
@@ -0,0 +1,213 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "common.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace OpenRCT2
+{
+    struct IStream;
+    class MemoryMappedFile;
+} // namespace OpenRCT2
+
+struct rct_s6_data;
+
+/**
+ * The native park format (*.park). The file starts with a header and a table of sections, each of which is compressed
+ * and checksummed on its own. Loaders can therefore read just the preview, or only the sections they need, without
+ * decompressing the rest of the file.
+ *
+ * Layout:
+ *   ParkFileHeader
+ *   ParkFileSectionEntry[NumSections]
+ *   section data, at the offsets given in the table
+ */
+constexpr uint32_t PARK_FILE_MAGIC = 0x4B524150; // "PARK"
+constexpr uint16_t PARK_FILE_CURRENT_VERSION = 1;
+// The oldest version of the reader that can still read files written by this version
+constexpr uint16_t PARK_FILE_MIN_VERSION = 1;
+
+enum class ParkFileSection : uint32_t
+{
+    Preview,
+    Objects,
+    PackedObjects,
+    Tiles,
+    Entities,
+    Rides,
+    Banners,
+    // Everything in rct_s6_data that is not in one of the sections above
+    Park,
+};
+
+enum class ParkFileCompression : uint32_t
+{
+    None,
+    Zlib,
+};
+
+#pragma pack(push, 1)
+struct ParkFileHeader
+{
+    uint32_t Magic;
+    uint16_t Version;
+    uint16_t MinVersion;
+    uint8_t Type; // S6_TYPE_SAVEDGAME or S6_TYPE_SCENARIO
+    uint8_t Pad[3];
+    uint32_t NumSections;
+};
+assert_struct_size(ParkFileHeader, 16);
+
+struct ParkFileSectionEntry
+{
+    ParkFileSection Id;
+    ParkFileCompression Compression;
+    uint64_t Offset;
+    // Length of the data as stored in the file
+    uint64_t Length;
+    uint64_t UncompressedLength;
+    // CRC-32 of the data as stored in the file
+    uint32_t Checksum;
+    uint32_t Pad;
+};
+assert_struct_size(ParkFileSectionEntry, 40);
+#pragma pack(pop)
+
+/**
+ * What the scenario list and the load dialogs show about a park, stored uncompressed so it can be read without
+ * touching the rest of the file.
+ */
+struct ParkPreview
+{
+    uint8_t Type{};
+    std::string ParkName;
+    std::string ScenarioName;
+    std::string ScenarioDetails;
+    uint8_t Category{};
+    uint8_t ObjectiveType{};
+    uint8_t ObjectiveArg1{};
+    int32_t ObjectiveArg2{};
+    int16_t ObjectiveArg3{};
+    int32_t MonthsElapsed{};
+    money32 Cash{};
+    uint32_t NumGuests{};
+    uint16_t ParkRating{};
+    int32_t MapSize{};
+};
+
+/**
+ * Collects the sections of a park file and writes them, compressing all sections at the same time.
+ */
+class ParkFileWriter final
+{
+private:
+    struct Section
+    {
+        ParkFileSection Id;
+        bool Compress;
+        std::vector<uint8_t> OwnedData;
+        const uint8_t* Data;
+        size_t Length;
+    };
+
+    uint8_t _type;
+    std::vector<Section> _sections;
+
+public:
+    explicit ParkFileWriter(uint8_t type);
+
+    /**
+     * Adds a section with a copy of the given data.
+     */
+    void AddSection(ParkFileSection id, std::vector<uint8_t>&& data, bool compress = true);
+
+    /**
+     * Adds a section that refers to the given data, which must stay valid until the file has been written.
+     */
+    void AddSection(ParkFileSection id, const void* data, size_t length, bool compress = true);
+
+    void AddPreview(const ParkPreview& preview);
+
+    /**
+     * Adds the objects, tiles, entities, rides, banners and park sections from the given S6 data, which must stay valid
+     * until the file has been written.
+     */
+    void AddS6Data(const rct_s6_data& s6);
+
+    void Write(OpenRCT2::IStream* stream) const;
+};
+
+/**
+ * Reads a park file from a memory mapped file or from memory. Sections are only decompressed and checked when they
+ * are read.
+ */
+class ParkFileReader final
+{
+private:
+    std::unique_ptr<OpenRCT2::MemoryMappedFile> _file;
+    std::vector<uint8_t> _buffer;
+    const uint8_t* _data = nullptr;
+    size_t _length = 0;
+    ParkFileHeader _header{};
+    std::vector<ParkFileSectionEntry> _sections;
+
+public:
+    /**
+     * Maps the given file, so only the pages of the sections that are read get loaded.
+     */
+    explicit ParkFileReader(const std::string& path);
+
+    /**
+     * Reads the park file at the stream's position. Streams backed by memory are read in place.
+     */
+    explicit ParkFileReader(OpenRCT2::IStream* stream);
+
+    ~ParkFileReader();
+
+    /**
+     * Returns whether the stream is at the start of a park file, without moving it.
+     */
+    static bool IsParkFile(OpenRCT2::IStream* stream);
+    static bool ExtensionIsParkFile(const std::string& path);
+
+    const ParkFileHeader& GetHeader() const
+    {
+        return _header;
+    }
+
+    bool HasSection(ParkFileSection id) const;
+
+    /**
+     * Returns the uncompressed data of the given section. Throws if the section is missing or damaged.
+     */
+    std::vector<uint8_t> ReadSection(ParkFileSection id) const;
+
+    /**
+     * Decompresses the given section straight into dst, which must be the section's uncompressed length.
+     */
+    void ReadSection(ParkFileSection id, void* dst, size_t length) const;
+
+    ParkPreview ReadPreview() const;
+
+    /**
+     * Reads all the sections written by ParkFileWriter::AddS6Data back into the given S6 data, decompressing them at the
+     * same time.
+     */
+    void ReadS6Data(rct_s6_data& s6) const;
+
+private:
+    void ReadTable();
+    const ParkFileSectionEntry* FindSection(ParkFileSection id) const;
+    const uint8_t* GetCheckedSectionData(const ParkFileSectionEntry& entry) const;
+};
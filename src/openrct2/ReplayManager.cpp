@@ -32,6 +32,7 @@
 #include "world/EntityTweener.h"
 #include "world/Park.h"
 #include "world/Sprite.h"
+#include "world/StateHash.h"
 #include "zlib.h"
 
 #include <chrono>
@@ -77,6 +78,16 @@ namespace OpenRCT2
         OpenRCT2::MemoryStream data;
     };
 
+    struct ReplayCheckpoint
+    {
+        uint32_t tick = 0;
+        // Commands with a lower index were executed before the checkpoint was taken, some of them on the same tick
+        uint32_t commandIndex = 0;
+        OpenRCT2::MemoryStream parkData;
+        OpenRCT2::MemoryStream parkParams;
+        OpenRCT2::MemoryStream cheatData;
+    };
+
     struct ReplayRecordData
     {
         uint32_t magic;
@@ -93,15 +104,22 @@ namespace OpenRCT2
         std::multiset<ReplayCommand> commands;
         std::vector<std::pair<uint32_t, rct_sprite_checksum>> checksums;
         uint32_t checksumIndex;
+        std::vector<std::pair<uint32_t, uint64_t>> stateHashes;
+        uint32_t stateHashIndex;
         OpenRCT2::MemoryStream gameStateSnapshots;
+        std::vector<ReplayCheckpoint> checkpoints;
     };
 
     class ReplayManager final : public IReplayManager
     {
-        static constexpr uint16_t ReplayVersion = 4;
+        static constexpr uint16_t ReplayVersion = 7;
+        static constexpr uint16_t ReplayVersionCheckpoints = 5;
+        static constexpr uint16_t ReplayVersionStateHashes = 6;
+        static constexpr uint16_t ReplayVersionCheckpointCommands = 7;
         static constexpr uint32_t ReplayMagic = 0x5243524F; // ORCR.
         static constexpr int ReplayCompressionLevel = 9;
-        static constexpr int NormalRecordingChecksumTicks = 1;
+        // The state hash is recorded every tick, so the much slower sprite checksum is only needed now and then
+        static constexpr int NormalRecordingChecksumTicks = 40;
         static constexpr int SilentRecordingChecksumTicks = 40; // Same as network server
 
         enum class ReplayMode
@@ -137,6 +155,11 @@ namespace OpenRCT2
             return IsRecording() && _recordType == RecordType::NORMAL;
         }
 
+        virtual bool UsesStateHash() const override
+        {
+            return IsReplaying() || IsNormalising() || (IsRecording() && _recordType == RecordType::NORMAL);
+        }
+
         virtual void AddGameAction(uint32_t tick, const GameAction* action) override
         {
             if (_currentRecording == nullptr)
@@ -152,12 +175,27 @@ namespace OpenRCT2
             _currentRecording->checksums.emplace_back(std::make_pair(tick, std::move(checksum)));
         }
 
+        void AddStateHash(uint32_t tick, uint64_t stateHash)
+        {
+            _currentRecording->stateHashes.emplace_back(tick, stateHash);
+        }
+
         // Function runs each Tick.
         virtual void Update() override
         {
             if (_mode == ReplayMode::NONE)
                 return;
 
+            if (_mode == ReplayMode::RECORDING || _mode == ReplayMode::NORMALISATION)
+            {
+                // The state is hashed part way through each tick, so the previous tick is the latest one available
+                const auto* stateHash = state_hash_get(gCurrentTicks - 1);
+                if (stateHash != nullptr && stateHash->Tick >= _currentRecording->tickStart)
+                {
+                    AddStateHash(stateHash->Tick, stateHash->Root);
+                }
+            }
+
             if ((_mode == ReplayMode::RECORDING || _mode == ReplayMode::NORMALISATION) && gCurrentTicks == _nextChecksumTick)
             {
                 rct_sprite_checksum checksum = sprite_checksum();
@@ -166,6 +204,15 @@ namespace OpenRCT2
                 _nextChecksumTick = gCurrentTicks + ChecksumTicksDelta();
             }
 
+            // Silent recordings are only kept in case of a crash, so they are not worth the memory
+            if ((_mode == ReplayMode::RECORDING || _mode == ReplayMode::NORMALISATION) && _recordType == RecordType::NORMAL
+                && gCurrentTicks == _nextCheckpointTick)
+            {
+                AddCheckpoint();
+
+                _nextCheckpointTick = gCurrentTicks + k_ReplayCheckpointTicks;
+            }
+
             if (_mode == ReplayMode::RECORDING)
             {
                 if (gCurrentTicks >= _currentRecording->tickEnd)
@@ -218,6 +265,32 @@ namespace OpenRCT2
             snapshots->SerialiseSnapshot(snapshot, snapShotDs);
         }
 
+        void CaptureParkState(MemoryStream& parkData, MemoryStream& parkParams, MemoryStream& cheatData)
+        {
+            auto context = GetContext();
+            auto& objManager = context->GetObjectManager();
+            auto objects = objManager.GetPackableObjects();
+
+            auto s6exporter = std::make_unique<S6Exporter>();
+            s6exporter->ExportObjectsList = objects;
+            s6exporter->Export();
+            s6exporter->SaveGame(&parkData);
+
+            DataSerialiser parkParamsDs(true, parkParams);
+            SerialiseParkParameters(parkParamsDs);
+
+            DataSerialiser cheatDataDs(true, cheatData);
+            SerialiseCheats(cheatDataDs);
+        }
+
+        void AddCheckpoint()
+        {
+            auto& checkpoint = _currentRecording->checkpoints.emplace_back();
+            checkpoint.tick = gCurrentTicks;
+            checkpoint.commandIndex = _commandId;
+            CaptureParkState(checkpoint.parkData, checkpoint.parkParams, checkpoint.cheatData);
+        }
+
         virtual bool StartRecording(
             const std::string& name, uint32_t maxTicks /*= k_MaxReplayTicks*/, RecordType rt /*= RecordType::NORMAL*/) override
         {
@@ -242,23 +315,10 @@ namespace OpenRCT2
 
             replayData->filePath = name;
 
-            auto context = GetContext();
-            auto& objManager = context->GetObjectManager();
-            auto objects = objManager.GetPackableObjects();
-
-            auto s6exporter = std::make_unique<S6Exporter>();
-            s6exporter->ExportObjectsList = objects;
-            s6exporter->Export();
-            s6exporter->SaveGame(&replayData->parkData);
+            CaptureParkState(replayData->parkData, replayData->parkParams, replayData->cheatData);
 
             replayData->timeRecorded = std::chrono::seconds(std::time(nullptr)).count();
 
-            DataSerialiser parkParamsDs(true, replayData->parkParams);
-            SerialiseParkParameters(parkParamsDs);
-
-            DataSerialiser cheatDataDs(true, replayData->cheatData);
-            SerialiseCheats(cheatDataDs);
-
             TakeGameStateSnapshot(replayData->gameStateSnapshots);
 
             if (_mode != ReplayMode::NORMALISATION)
@@ -267,6 +327,7 @@ namespace OpenRCT2
             _currentRecording = std::move(replayData);
             _recordType = rt;
             _nextChecksumTick = gCurrentTicks + 1;
+            _nextCheckpointTick = gCurrentTicks + k_ReplayCheckpointTicks;
 
             return true;
         }
@@ -371,6 +432,7 @@ namespace OpenRCT2
                 info.Ticks = data->tickEnd - data->tickStart;
             info.NumCommands = static_cast<uint32_t>(data->commands.size());
             info.NumChecksums = static_cast<uint32_t>(data->checksums.size());
+            info.NumCheckpoints = static_cast<uint32_t>(data->checkpoints.size());
 
             return true;
         }
@@ -414,7 +476,7 @@ namespace OpenRCT2
             }
         }
 
-        virtual bool StartPlayback(const std::string& file) override
+        virtual bool StartPlayback(const std::string& file, uint32_t seekTick /*= 0*/) override
         {
             if (_mode != ReplayMode::NONE && _mode != ReplayMode::NORMALISATION)
                 return false;
@@ -427,19 +489,38 @@ namespace OpenRCT2
                 return false;
             }
 
-            if (!LoadReplayDataMap(*replayData))
+            replayData->checksumIndex = 0;
+            replayData->stateHashIndex = 0;
+
+            const ReplayCheckpoint* checkpoint = FindCheckpoint(*replayData, seekTick);
+            if (checkpoint != nullptr)
             {
-                log_error("Unable to load map.");
-                return false;
+                if (!LoadParkState(checkpoint->parkData, checkpoint->parkParams, checkpoint->cheatData))
+                {
+                    log_error("Unable to load checkpoint at tick %u.", checkpoint->tick);
+                    return false;
+                }
+
+                gCurrentTicks = checkpoint->tick;
+
+                SkipToCheckpoint(*replayData, *checkpoint);
             }
+            else
+            {
+                if (!LoadReplayDataMap(*replayData))
+                {
+                    log_error("Unable to load map.");
+                    return false;
+                }
 
-            gCurrentTicks = replayData->tickStart;
+                gCurrentTicks = replayData->tickStart;
 
-            LoadAndCompareSnapshot(replayData->gameStateSnapshots);
+                LoadAndCompareSnapshot(replayData->gameStateSnapshots);
+            }
 
             _currentReplay = std::move(replayData);
-            _currentReplay->checksumIndex = 0;
             _faultyChecksumIndex = -1;
+            _faultyStateHashIndex = -1;
 
             // Make sure game is not paused.
             gGamePaused = 0;
@@ -452,7 +533,7 @@ namespace OpenRCT2
 
         virtual bool IsPlaybackStateMismatching() const override
         {
-            return _faultyChecksumIndex != -1;
+            return _faultyChecksumIndex != -1 || _faultyStateHashIndex != -1;
         }
 
         virtual bool StopPlayback() override
@@ -484,7 +565,7 @@ namespace OpenRCT2
         {
             _mode = ReplayMode::NORMALISATION;
 
-            if (!StartPlayback(file))
+            if (!StartPlayback(file, 0))
             {
                 return false;
             }
@@ -513,17 +594,68 @@ namespace OpenRCT2
             }
         }
 
+        /**
+         * Returns the last checkpoint at or before the given tick, or nullptr if playback has to start from the beginning.
+         */
+        const ReplayCheckpoint* FindCheckpoint(const ReplayRecordData& data, uint32_t tick) const
+        {
+            const ReplayCheckpoint* result = nullptr;
+            for (const auto& checkpoint : data.checkpoints)
+            {
+                if (checkpoint.tick > tick)
+                    break;
+                result = &checkpoint;
+            }
+            return result;
+        }
+
+        /**
+         * Drops the commands, checksums and state hashes that are already part of the checkpoint. Commands are dropped by
+         * their index rather than their tick, as actions issued between two ticks are recorded with the upcoming tick
+         * before the checkpoint for that tick is taken.
+         */
+        void SkipToCheckpoint(ReplayRecordData& data, const ReplayCheckpoint& checkpoint)
+        {
+            const uint32_t tick = checkpoint.tick;
+            auto& commands = data.commands;
+            for (auto it = commands.begin(); it != commands.end();)
+            {
+                if (it->commandIndex < checkpoint.commandIndex)
+                    it = commands.erase(it);
+                else
+                    ++it;
+            }
+
+            while (data.checksumIndex < data.checksums.size() && data.checksums[data.checksumIndex].first < tick)
+            {
+                data.checksumIndex++;
+            }
+
+            while (data.stateHashIndex < data.stateHashes.size() && data.stateHashes[data.stateHashIndex].first < tick)
+            {
+                data.stateHashIndex++;
+            }
+        }
+
         bool LoadReplayDataMap(ReplayRecordData& data)
+        {
+            return LoadParkState(data.parkData, data.parkParams, data.cheatData);
+        }
+
+        bool LoadParkState(const MemoryStream& parkData, const MemoryStream& parkParams, const MemoryStream& cheatData)
         {
             try
             {
-                data.parkData.SetPosition(0);
+                // Read from copies so the same checkpoint can be loaded more than once.
+                MemoryStream parkDataStream(parkData.GetData(), static_cast<size_t>(parkData.GetLength()));
+                MemoryStream parkParamsStream(parkParams.GetData(), static_cast<size_t>(parkParams.GetLength()));
+                MemoryStream cheatDataStream(cheatData.GetData(), static_cast<size_t>(cheatData.GetLength()));
 
                 auto context = GetContext();
                 auto& objManager = context->GetObjectManager();
                 auto importer = ParkImporter::CreateS6(context->GetObjectRepository());
 
-                auto loadResult = importer->LoadFromStream(&data.parkData, false);
+                auto loadResult = importer->LoadFromStream(&parkDataStream, false);
                 objManager.LoadObjects(loadResult.RequiredObjects.data(), loadResult.RequiredObjects.size());
 
                 importer->Import();
@@ -531,13 +663,13 @@ namespace OpenRCT2
                 EntityTweener::Get().Reset();
 
                 // Load all map global variables.
-                DataSerialiser parkParamsDs(false, data.parkParams);
+                DataSerialiser parkParamsDs(false, parkParamsStream);
                 SerialiseParkParameters(parkParamsDs);
 
                 // New cheats might not be serialised, make sure they are using their defaults.
                 CheatsReset();
 
-                DataSerialiser cheatDataDs(false, data.cheatData);
+                DataSerialiser cheatDataDs(false, cheatDataStream);
                 SerialiseCheats(cheatDataDs);
 
                 game_load_init();
@@ -710,7 +842,8 @@ namespace OpenRCT2
 
         bool Compatible(ReplayRecordData& data)
         {
-            return data.version == ReplayVersion;
+            // Version 4 only lacks the checkpoints, version 5 the state hashes and version 6 the checkpoint command indices.
+            return data.version == 4 || data.version == 5 || data.version == 6 || data.version == ReplayVersion;
         }
 
         bool Serialise(DataSerialiser& serialiser, ReplayRecordData& data)
@@ -783,12 +916,61 @@ namespace OpenRCT2
             }
 
             serialiser << data.gameStateSnapshots;
+
+            if (data.version >= ReplayVersionCheckpoints)
+            {
+                uint32_t countCheckpoints = static_cast<uint32_t>(data.checkpoints.size());
+                serialiser << countCheckpoints;
+
+                if (serialiser.IsLoading())
+                {
+                    data.checkpoints.resize(countCheckpoints);
+                }
+
+                for (auto& checkpoint : data.checkpoints)
+                {
+                    serialiser << checkpoint.tick;
+                    if (data.version >= ReplayVersionCheckpointCommands)
+                    {
+                        serialiser << checkpoint.commandIndex;
+                    }
+                    serialiser << checkpoint.parkData;
+                    serialiser << checkpoint.parkParams;
+                    serialiser << checkpoint.cheatData;
+                }
+
+                // Without the command index it is unknown which commands of the checkpoint's tick it already contains,
+                // so these replays can only be played from the start
+                if (serialiser.IsLoading() && data.version < ReplayVersionCheckpointCommands)
+                {
+                    data.checkpoints.clear();
+                }
+            }
+
+            if (data.version >= ReplayVersionStateHashes)
+            {
+                uint32_t countStateHashes = static_cast<uint32_t>(data.stateHashes.size());
+                serialiser << countStateHashes;
+
+                if (serialiser.IsLoading())
+                {
+                    data.stateHashes.resize(countStateHashes);
+                }
+
+                for (auto& stateHash : data.stateHashes)
+                {
+                    serialiser << stateHash.first;
+                    serialiser << stateHash.second;
+                }
+            }
             return true;
         }
 
 #ifndef DISABLE_NETWORK
         void CheckState()
         {
+            CheckStateHash();
+
             uint32_t checksumIndex = _currentReplay->checksumIndex;
 
             if (checksumIndex >= _currentReplay->checksums.size())
@@ -820,6 +1002,35 @@ namespace OpenRCT2
                 }
             }
         }
+
+        void CheckStateHash()
+        {
+            // The state hash of the previous tick is compared, as it is taken part way through the tick
+            const uint32_t tick = gCurrentTicks - 1;
+            auto& stateHashes = _currentReplay->stateHashes;
+            auto& stateHashIndex = _currentReplay->stateHashIndex;
+            while (stateHashIndex < stateHashes.size() && stateHashes[stateHashIndex].first < tick)
+            {
+                stateHashIndex++;
+            }
+
+            if (stateHashIndex >= stateHashes.size() || stateHashes[stateHashIndex].first != tick)
+                return;
+
+            const auto savedStateHash = stateHashes[stateHashIndex].second;
+            const auto* stateHash = state_hash_get(tick);
+            if (stateHash != nullptr && stateHash->Root != savedStateHash)
+            {
+                // Detected different game state.
+                log_warning(
+                    "Different state hash at tick %u (Replay Tick: %u) ; Saved: %016llX, Current: %016llX", tick,
+                    tick - _currentReplay->tickStart, static_cast<unsigned long long>(savedStateHash),
+                    static_cast<unsigned long long>(stateHash->Root));
+
+                _faultyStateHashIndex = static_cast<int32_t>(stateHashIndex);
+            }
+            stateHashIndex++;
+        }
 #endif // DISABLE_NETWORK
 
         void ReplayCommands()
@@ -873,8 +1084,10 @@ namespace OpenRCT2
         std::unique_ptr<ReplayRecordData> _currentRecording;
         std::unique_ptr<ReplayRecordData> _currentReplay;
         int32_t _faultyChecksumIndex = -1;
+        int32_t _faultyStateHashIndex = -1;
         uint32_t _commandId = 0;
         uint32_t _nextChecksumTick = 0;
+        uint32_t _nextCheckpointTick = 0;
         uint32_t _nextReplayTick = 0;
         RecordType _recordType = RecordType::NORMAL;
     };
@@ -20,6 +20,8 @@ struct GameAction;
 namespace OpenRCT2
 {
     static constexpr uint32_t k_MaxReplayTicks = 0xFFFFFFFF;
+    // Number of ticks between the checkpoints of a normal recording, about every five minutes at normal speed
+    static constexpr uint32_t k_ReplayCheckpointTicks = 40 * 60 * 5;
 
     struct ReplayRecordInfo
     {
@@ -28,6 +30,7 @@ namespace OpenRCT2
         uint64_t TimeRecorded;
         uint32_t NumCommands;
         uint32_t NumChecksums;
+        uint32_t NumCheckpoints;
         std::string Name;
         std::string FilePath;
     };
@@ -50,6 +53,11 @@ namespace OpenRCT2
         virtual bool IsNormalising() const = 0;
         virtual bool ShouldDisplayNotice() const = 0;
 
+        /**
+         * Whether the state hash has to be updated each tick, so it can be recorded or checked.
+         */
+        virtual bool UsesStateHash() const = 0;
+
         virtual void AddGameAction(uint32_t tick, const GameAction* action) = 0;
 
         virtual bool StartRecording(
@@ -58,7 +66,11 @@ namespace OpenRCT2
         virtual bool StopRecording(bool discard = false) = 0;
         virtual bool GetCurrentReplayInfo(ReplayRecordInfo& info) const = 0;
 
-        virtual bool StartPlayback(const std::string& file) = 0;
+        /**
+         * Starts playing back the given replay. When seekTick is past the start of the replay, playback starts from the
+         * last checkpoint at or before that tick instead of the start.
+         */
+        virtual bool StartPlayback(const std::string& file, uint32_t seekTick = 0) = 0;
         virtual bool IsPlaybackStateMismatching() const = 0;
         virtual bool StopPlayback() = 0;
 
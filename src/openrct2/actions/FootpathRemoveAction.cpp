@@ -15,6 +15,7 @@
 #include "../interface/Window.h"
 #include "../localisation/StringIds.h"
 #include "../management/Finance.h"
+#include "../peep/GuestPathfinding.h"
 #include "../world/Footpath.h"
 #include "../world/Location.hpp"
 #include "../world/Park.h"
@@ -96,6 +97,7 @@ GameActions::Result::Ptr FootpathRemoveAction::Execute() const
         footpath_remove_edges_at(_loc, footpathElement);
         map_invalidate_tile_full(_loc);
         tile_element_remove(footpathElement);
+        pathfind_graph_invalidate(_loc);
         footpath_update_queue_chains();
 
         // Remove the spawn point (if there is one in the current tile)
@@ -152,6 +152,7 @@ GameActions::Result::Ptr LandBuyRightsAction::map_buy_land_rights_for_tile(const
             if (isExecuting)
             {
                 surfaceElement->SetOwnership(surfaceElement->GetOwnership() | OWNERSHIP_CONSTRUCTION_RIGHTS_OWNED);
+                park_size_invalidate(loc);
                 uint16_t baseZ = surfaceElement->GetBaseZ();
                 map_invalidate_tile({ loc, baseZ, baseZ + 16 });
             }
@@ -135,6 +135,7 @@ GameActions::Result::Ptr LandSetRightsAction::map_buy_land_rights_for_tile(const
             if (isExecuting)
             {
                 surfaceElement->SetOwnership(surfaceElement->GetOwnership() & ~OWNERSHIP_CONSTRUCTION_RIGHTS_OWNED);
+                park_size_invalidate(loc);
                 uint16_t baseZ = surfaceElement->GetBaseZ();
                 map_invalidate_tile({ loc, baseZ, baseZ + 16 });
             }
@@ -15,6 +15,7 @@
 #include "../localisation/Localisation.h"
 #include "../localisation/StringIds.h"
 #include "../management/Finance.h"
+#include "../peep/GuestPathfinding.h"
 #include "../ride/RideData.h"
 #include "../ride/Track.h"
 #include "../ride/TrackData.h"
@@ -289,6 +290,7 @@ GameActions::Result::Ptr MazeSetTrackAction::Execute() const
     if ((tileElement->AsTrack()->GetMazeEntry() & 0x8888) == 0x8888)
     {
         tile_element_remove(tileElement);
+        pathfind_graph_invalidate(_loc);
         sub_6CB945(ride);
         ride->maze_tiles--;
     }
@@ -11,6 +11,7 @@
 
 #include "../OpenRCT2.h"
 #include "../management/Finance.h"
+#include "../peep/GuestPathfinding.h"
 #include "../world/Entrance.h"
 #include "../world/Park.h"
 
@@ -93,5 +94,6 @@ void ParkEntranceRemoveAction::ParkEntranceRemoveSegment(const CoordsXYZ& loc) c
 
     map_invalidate_tile({ loc, entranceElement->GetBaseZ(), entranceElement->GetClearanceZ() });
     entranceElement->Remove();
+    pathfind_graph_invalidate(loc);
     update_park_fences({ loc.x, loc.y });
 }
@@ -17,6 +17,7 @@
 #include "../interface/Window.h"
 #include "../localisation/Localisation.h"
 #include "../management/NewsItem.h"
+#include "../peep/GuestPathfinding.h"
 #include "../ride/Ride.h"
 #include "../ride/RideData.h"
 #include "../ui/UiContext.h"
@@ -310,6 +311,7 @@ money32 RideDemolishAction::DemolishTracks() const
             if (removRes->Error != GameActions::Status::Ok)
             {
                 tile_element_remove(it.element);
+                pathfind_graph_invalidate(location);
             }
             else
             {
@@ -9,6 +9,7 @@
 
 #include "RideEntranceExitRemoveAction.h"
 
+#include "../peep/GuestPathfinding.h"
 #include "../ride/Ride.h"
 #include "../ride/Station.h"
 #include "../world/Entrance.h"
@@ -145,6 +146,7 @@ GameActions::Result::Ptr RideEntranceExitRemoveAction::Execute() const
     footpath_remove_edges_at(_loc, entranceElement);
 
     tile_element_remove(entranceElement);
+    pathfind_graph_invalidate(_loc);
 
     if (_isExit)
     {
@@ -9,6 +9,7 @@
 
 #include "TileModifyAction.h"
 
+#include "../peep/GuestPathfinding.h"
 #include "../world/TileInspector.h"
 
 using namespace OpenRCT2;
@@ -221,6 +222,12 @@ GameActions::Result::Ptr TileModifyAction::QueryExecute(bool isExecuting) const
             return MakeResult(GameActions::Status::InvalidParameters, STR_NONE);
     }
 
+    if (isExecuting && res->Error == GameActions::Status::Ok)
+    {
+        // Elements can be removed, reordered or have any of their properties changed
+        pathfind_graph_invalidate(_loc);
+    }
+
     res->Position.x = _loc.x;
     res->Position.y = _loc.y;
     res->Position.z = tile_element_height(_loc);
@@ -10,6 +10,7 @@
 #include "TrackRemoveAction.h"
 
 #include "../management/Finance.h"
+#include "../peep/GuestPathfinding.h"
 #include "../ride/RideData.h"
 #include "../ride/Track.h"
 #include "../ride/TrackData.h"
@@ -422,6 +423,7 @@ GameActions::Result::Ptr TrackRemoveAction::Execute() const
             footpath_remove_edges_at(mapLoc, tileElement);
         }
         tile_element_remove(tileElement);
+        pathfind_graph_invalidate(mapLoc);
         sub_6CB945(ride);
         if (!(GetFlags() & GAME_COMMAND_FLAG_GHOST))
         {
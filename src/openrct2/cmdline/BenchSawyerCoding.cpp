@@ -0,0 +1,196 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "CommandLine.hpp"
+
+#ifdef USE_BENCHMARK
+
+#    include "../core/File.h"
+#    include "../core/MemoryStream.h"
+#    include "../platform/Platform2.h"
+#    include "../rct12/SawyerChunkReader.h"
+#    include "../rct12/SawyerChunkWriter.h"
+#    include "../util/SawyerCoding.h"
+
+#    include <benchmark/benchmark.h>
+#    include <cstdint>
+#    include <random>
+#    include <vector>
+
+struct BenchChunk
+{
+    SAWYER_ENCODING Encoding;
+    std::vector<uint8_t> Data;
+};
+
+/**
+ * Reads the chunks at the start of a park file, up to the first one that can not be read. Packed objects end the list.
+ */
+static std::vector<BenchChunk> read_bench_chunks(const char* path)
+{
+    std::vector<BenchChunk> chunks;
+    try
+    {
+        auto fileData = File::ReadAllBytes(path);
+        OpenRCT2::MemoryStream ms(fileData.data(), fileData.size());
+        SawyerChunkReader reader(&ms);
+        while (ms.GetPosition() + sizeof(sawyercoding_chunk_header) < ms.GetLength())
+        {
+            auto chunk = reader.ReadChunk();
+            auto data = static_cast<const uint8_t*>(chunk->GetData());
+            chunks.push_back({ chunk->GetEncoding(), std::vector<uint8_t>(data, data + chunk->GetLength()) });
+        }
+    }
+    catch (const std::exception&)
+    {
+    }
+    return chunks;
+}
+
+/**
+ * Creates data that looks roughly like tile elements: 16 byte records that are mostly zero and often the same as the
+ * record before them.
+ */
+static std::vector<BenchChunk> create_bench_chunks(SAWYER_ENCODING encoding)
+{
+    std::mt19937 rng(0);
+    std::vector<uint8_t> data(0x180000);
+    for (size_t i = 0; i < data.size(); i += 16)
+    {
+        for (size_t j = 0; j < 16; j++)
+        {
+            if (i >= 16 && rng() % 4 != 0)
+                data[i + j] = data[i + j - 16];
+            else if (rng() % 2 == 0)
+                data[i + j] = static_cast<uint8_t>(rng());
+        }
+    }
+    return { { encoding, std::move(data) } };
+}
+
+static void BM_sawyer_encode(benchmark::State& state, const std::vector<BenchChunk>& chunks)
+{
+    size_t bytesPerIteration = 0;
+    for (const auto& chunk : chunks)
+    {
+        bytesPerIteration += chunk.Data.size();
+    }
+
+    for (auto _ : state)
+    {
+        for (const auto& chunk : chunks)
+        {
+            auto encoded = SawyerChunkWriter::EncodeChunk(chunk.Data.data(), chunk.Data.size(), chunk.Encoding);
+            benchmark::DoNotOptimize(encoded.data());
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * bytesPerIteration);
+}
+
+static void BM_sawyer_decode(benchmark::State& state, const std::vector<BenchChunk>& chunks)
+{
+    size_t bytesPerIteration = 0;
+    std::vector<std::vector<uint8_t>> encodedChunks;
+    for (const auto& chunk : chunks)
+    {
+        bytesPerIteration += chunk.Data.size();
+        encodedChunks.push_back(SawyerChunkWriter::EncodeChunk(chunk.Data.data(), chunk.Data.size(), chunk.Encoding));
+    }
+
+    for (auto _ : state)
+    {
+        for (const auto& encodedChunk : encodedChunks)
+        {
+            OpenRCT2::MemoryStream ms(const_cast<uint8_t*>(encodedChunk.data()), encodedChunk.size());
+            SawyerChunkReader reader(&ms);
+            auto chunk = reader.ReadChunk();
+            benchmark::DoNotOptimize(chunk->GetData());
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * bytesPerIteration);
+}
+
+static void register_sawyer_benchmarks(const std::string& name, const std::vector<BenchChunk>& chunks)
+{
+    benchmark::RegisterBenchmark((name + "/encode").c_str(), BM_sawyer_encode, chunks);
+    benchmark::RegisterBenchmark((name + "/decode").c_str(), BM_sawyer_decode, chunks);
+}
+
+static int cmdline_for_bench_sawyer_coding(int argc, const char* const* argv)
+{
+    // Add baselines for each encoding on generated data
+    register_sawyer_benchmarks("rle", create_bench_chunks(SAWYER_ENCODING::RLE));
+    register_sawyer_benchmarks("rlecompressed", create_bench_chunks(SAWYER_ENCODING::RLECOMPRESSED));
+    register_sawyer_benchmarks("rotate", create_bench_chunks(SAWYER_ENCODING::ROTATE));
+
+    // Google benchmark does stuff to argv. It doesn't modify the pointees,
+    // but it wants to reorder the pointers, so present a copy of them.
+    std::vector<char*> argv_for_benchmark;
+
+    // argv[0] is expected to contain the binary name. It's only for logging purposes, don't bother.
+    argv_for_benchmark.push_back(nullptr);
+
+    // Extract file names from argument list. If there is no such file, consider it benchmark option.
+    for (int i = 0; i < argc; i++)
+    {
+        if (Platform::FileExists(argv[i]))
+        {
+            // Register benchmark for the chunks of the sv6 / sc6 if valid
+            auto chunks = read_bench_chunks(argv[i]);
+            if (!chunks.empty())
+                register_sawyer_benchmarks(argv[i], chunks);
+        }
+        else
+        {
+            argv_for_benchmark.push_back(const_cast<char*>(argv[i]));
+        }
+    }
+    // Update argc with all the changes made
+    argc = static_cast<int>(argv_for_benchmark.size());
+    ::benchmark::Initialize(&argc, &argv_for_benchmark[0]);
+    if (::benchmark::ReportUnrecognizedArguments(argc, &argv_for_benchmark[0]))
+        return -1;
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
+
+static exitcode_t HandleBenchSawyerCoding(CommandLineArgEnumerator* argEnumerator)
+{
+    const char* const* argv = static_cast<const char* const*>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    int32_t result = cmdline_for_bench_sawyer_coding(argc, argv);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
+
+#else
+static exitcode_t HandleBenchSawyerCoding(CommandLineArgEnumerator* argEnumerator)
+{
+    log_error("Sorry, Google benchmark not enabled in this build");
+    return EXITCODE_FAIL;
+}
+#endif // USE_BENCHMARK
+
+const CommandLineCommand CommandLine::BenchSawyerCodingCommands[]{
+#ifdef USE_BENCHMARK
+    DefineCommand(
+        "",
+        "[<file>]... [--benchmark_list_tests={true|false}] [--benchmark_filter=<regex>] [--benchmark_min_time=<min_time>] "
+        "[--benchmark_repetitions=<num_repetitions>] [--benchmark_report_aggregates_only={true|false}] "
+        "[--benchmark_format=<console|json|csv>] [--benchmark_out=<filename>] [--benchmark_out_format=<json|console|csv>] "
+        "[--benchmark_color={auto|true|false}] [--benchmark_counters_tabular={true|false}] [--v=<verbosity>]",
+        nullptr, HandleBenchSawyerCoding),
+    CommandTableEnd
+#else
+    DefineCommand("", "*** SORRY NOT ENABLED IN THIS BUILD ***", nullptr, HandleBenchSawyerCoding), CommandTableEnd
+#endif // USE_BENCHMARK
+};
@@ -14,8 +14,14 @@
 #    include "../Context.h"
 #    include "../GameState.h"
 #    include "../OpenRCT2.h"
+#    include "../peep/Peep.h"
 #    include "../platform/Platform2.h"
 #    include "../platform/platform.h"
+#    include "../ride/TrainManager.h"
+#    include "../ride/Vehicle.h"
+#    include "../world/EntityList.h"
+#    include "../world/Footpath.h"
+#    include "../world/Map.h"
 
 #    include <benchmark/benchmark.h>
 #    include <cstdint>
@@ -49,14 +55,14 @@ static void BM_update(benchmark::State& state, const std::string& filename)
             context->GetGameState()->UpdateLogic(timingToUse);
         }
         state.SetItemsProcessed(state.iterations());
-        auto accumulator = [timings](LogicTimePart part) -> double {
-            std::chrono::duration<double> timesum;
+        auto accumulator = [&timings](LogicTimePart part) -> double {
+            std::chrono::duration<double> timesum{};
             for (const auto& timing : timings)
             {
-                timesum = std::accumulate(
-                    timing.TimingInfo.at(part).begin(), timing.TimingInfo.at(part).end(), std::chrono::duration<double>());
+                const auto& info = timing.TimingInfo.at(part);
+                timesum = std::accumulate(info.begin(), info.begin() + timing.CurrentIdx, timesum);
             }
-            return std::chrono::duration_cast<std::chrono::milliseconds>(timesum).count();
+            return std::chrono::duration<double, std::milli>(timesum).count();
         };
         state.counters["NetworkUpdateAcc_ms"] = accumulator(LogicTimePart::NetworkUpdate);
         state.counters["DateAcc_ms"] = accumulator(LogicTimePart::Date);
@@ -65,6 +71,7 @@ static void BM_update(benchmark::State& state, const std::string& filename)
         state.counters["MapTilesAcc_ms"] = accumulator(LogicTimePart::MapTiles);
         state.counters["MapStashProvisionalElementsAcc_ms"] = accumulator(LogicTimePart::MapStashProvisionalElements);
         state.counters["MapPathWideFlagsAcc_ms"] = accumulator(LogicTimePart::MapPathWideFlags);
+        state.counters["StateHashAcc_ms"] = accumulator(LogicTimePart::StateHash);
         state.counters["PeepAcc_ms"] = accumulator(LogicTimePart::Peep);
         state.counters["MapRestoreProvisionalElementsAcc_ms"] = accumulator(LogicTimePart::MapRestoreProvisionalElements);
         state.counters["VehicleAcc_ms"] = accumulator(LogicTimePart::Vehicle);
@@ -87,6 +94,82 @@ static void BM_update(benchmark::State& state, const std::string& filename)
     }
 }
 
+static void BM_entity_lists(benchmark::State& state, const std::string& filename)
+{
+    std::unique_ptr<IContext> context(CreateContext());
+    if (context->Initialise())
+    {
+        if (!filename.empty() && !context->LoadParkFromFile(filename))
+        {
+            state.SkipWithError("Failed to load file!");
+        }
+
+        // Walks the entity lists the same way the guest and vehicle update loops do, touching each entity
+        int64_t visited = 0;
+        int64_t checksum = 0;
+        for (auto _ : state)
+        {
+            for (auto* guest : EntityList<Guest>())
+            {
+                checksum += guest->x;
+                visited++;
+            }
+            for (auto* train : TrainManager::View())
+            {
+                checksum += train->x;
+                visited++;
+            }
+            benchmark::DoNotOptimize(checksum);
+        }
+        state.SetItemsProcessed(visited);
+    }
+    else
+    {
+        state.SkipWithError("Context initialization failed.");
+    }
+}
+
+static void BM_tile_element_lookups(benchmark::State& state, const std::string& filename)
+{
+    std::unique_ptr<IContext> context(CreateContext());
+    if (context->Initialise())
+    {
+        if (!filename.empty() && !context->LoadParkFromFile(filename))
+        {
+            state.SkipWithError("Failed to load file!");
+        }
+
+        // Looks up the surface, footpath and track of every tile at the surface height, like the guest and ride code
+        // does when probing neighbouring tiles
+        int64_t lookups = 0;
+        int64_t found = 0;
+        for (auto _ : state)
+        {
+            for (int32_t y = 0; y < gMapSize; y++)
+            {
+                for (int32_t x = 0; x < gMapSize; x++)
+                {
+                    auto loc = TileCoordsXY{ x, y }.ToCoordsXY();
+                    auto* surfaceElement = map_get_surface_element_at(loc);
+                    if (surfaceElement == nullptr)
+                        continue;
+
+                    auto pos = CoordsXYZ{ loc, surfaceElement->GetBaseZ() };
+                    found += map_get_footpath_element(pos) != nullptr;
+                    found += map_get_track_element_at(pos) != nullptr;
+                    lookups += 3;
+                }
+            }
+            benchmark::DoNotOptimize(found);
+        }
+        state.SetItemsProcessed(lookups);
+    }
+    else
+    {
+        state.SkipWithError("Context initialization failed.");
+    }
+}
+
 static int CmdlineForBenchSpriteSort(int argc, const char* const* argv)
 {
     // Add a baseline test on an empty park
@@ -106,6 +189,9 @@ static int CmdlineForBenchSpriteSort(int argc, const char* const* argv)
         {
             // Register benchmark for sv6 if valid
             benchmark::RegisterBenchmark(argv[i], BM_update, argv[i]);
+            benchmark::RegisterBenchmark((std::string(argv[i]) + "/entity_lists").c_str(), BM_entity_lists, argv[i]);
+            benchmark::RegisterBenchmark(
+                (std::string(argv[i]) + "/tile_element_lookups").c_str(), BM_tile_element_lookups, argv[i]);
         }
         else
         {
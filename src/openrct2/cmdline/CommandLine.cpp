@@ -15,7 +15,11 @@
 #include "../platform/Platform2.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <future>
+#include <mutex>
+#include <thread>
 
 #pragma region CommandLineArgEnumerator
 
@@ -329,7 +333,8 @@ namespace CommandLine
         return fallback;
     }
 
-    static bool ParseOptions(const CommandLineOptionDefinition* options, CommandLineArgEnumerator* argEnumerator)
+    static bool ParseOptions(
+        const CommandLineOptionDefinition* options, CommandLineArgEnumerator* argEnumerator, bool optionsAnywhere)
     {
         bool firstOption = true;
 
@@ -359,7 +364,7 @@ namespace CommandLine
                 }
                 firstOption = false;
             }
-            else if (!firstOption)
+            else if (!firstOption && !optionsAnywhere)
             {
                 Console::Error::WriteLine("All options must be passed at the end of the command line.");
                 return false;
@@ -534,6 +539,119 @@ namespace CommandLine
         }
         return nullptr;
     }
+
+    std::vector<std::string> PopPositionalArguments(
+        const CommandLineOptionDefinition* options, CommandLineArgEnumerator* argEnumerator)
+    {
+        std::vector<std::string> result;
+        const char* argument;
+        while (argEnumerator->TryPopString(&argument))
+        {
+            if (HandleSpecialArgument(argument))
+            {
+                continue;
+            }
+
+            if (argument[0] != '-')
+            {
+                result.emplace_back(argument);
+                continue;
+            }
+
+            // Skip the value of an option that takes one, unless it was joined to the option
+            const CommandLineOptionDefinition* option = nullptr;
+            bool hasJoinedValue = false;
+            if (argument[1] == '-')
+            {
+                hasJoinedValue = strchr(argument, '=') != nullptr;
+                if (!hasJoinedValue)
+                {
+                    option = FindOption(options, &argument[2]);
+                }
+            }
+            else
+            {
+                for (const char* shortOption = &argument[1]; *shortOption != '\0' && !hasJoinedValue; shortOption++)
+                {
+                    option = FindOption(options, shortOption[0]);
+                    hasJoinedValue = option != nullptr && option->Type != CMDLINE_TYPE_SWITCH && shortOption[1] != '\0';
+                }
+            }
+            if (!hasJoinedValue && option != nullptr && option->Type != CMDLINE_TYPE_SWITCH)
+            {
+                argEnumerator->TryPop();
+            }
+        }
+        return result;
+    }
+
+    void PrintTickRate(uint32_t numTicks, double seconds)
+    {
+        double ticksPerSecond = seconds > 0 ? numTicks / seconds : 0;
+        Console::WriteLine("Ran %u ticks in %.3f s (%.0f ticks/s)", numTicks, seconds, ticksPerSecond);
+    }
+
+    size_t RunChildProcesses(
+        const std::vector<std::string>& argumentLists, [[maybe_unused]] size_t numJobs,
+        [[maybe_unused]] const std::function<exitcode_t(size_t)>& runInProcess)
+    {
+#if defined(_WIN32) || defined(__EMSCRIPTEN__)
+        // Platform::Execute is not implemented here, so run them one after another in this process instead
+        size_t numFailed = 0;
+        for (size_t index = 0; index < argumentLists.size(); index++)
+        {
+            const auto& arguments = argumentLists[index];
+            bool passed = runInProcess != nullptr && runInProcess(index) == EXITCODE_OK;
+            if (!passed)
+            {
+                numFailed++;
+            }
+            Console::WriteLine("%s: %s", arguments.c_str(), passed ? "passed" : "FAILED");
+        }
+        return numFailed;
+#else
+        if (numJobs == 0)
+        {
+            numJobs = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        }
+        numJobs = std::min(numJobs, argumentLists.size());
+
+        auto exePath = Platform::GetCurrentExecutablePath();
+        std::atomic<size_t> nextRun = { 0 };
+        std::atomic<size_t> numFailed = { 0 };
+        std::mutex outputMutex;
+        auto runChildren = [&]() {
+            size_t index;
+            while ((index = nextRun++) < argumentLists.size())
+            {
+                const auto& arguments = argumentLists[index];
+                auto command = String::StdFormat("\"%s\" %s 2>&1", exePath.c_str(), arguments.c_str());
+
+                std::string output;
+                bool passed = Platform::Execute(command, &output) == 0;
+                if (!passed)
+                {
+                    numFailed++;
+                }
+
+                std::lock_guard<std::mutex> lock(outputMutex);
+                Console::WriteLine("%s: %s", arguments.c_str(), passed ? "passed" : "FAILED");
+                Console::WriteLine("%s", output.c_str());
+            }
+        };
+
+        std::vector<std::future<void>> workers;
+        for (size_t i = 0; i < numJobs; i++)
+        {
+            workers.push_back(std::async(std::launch::async, runChildren));
+        }
+        for (auto& worker : workers)
+        {
+            worker.wait();
+        }
+        return numFailed;
+#endif
+    }
 } // namespace CommandLine
 
 int32_t cmdline_run(const char** argv, int32_t argc)
@@ -553,7 +671,7 @@ int32_t cmdline_run(const char** argv, int32_t argc)
     if (command->Options != nullptr)
     {
         auto argEnumeratorForOptions = CommandLineArgEnumerator(argEnumerator);
-        if (!CommandLine::ParseOptions(command->Options, &argEnumeratorForOptions))
+        if (!CommandLine::ParseOptions(command->Options, &argEnumeratorForOptions, command->OptionsAnywhere))
         {
             return EXITCODE_FAIL;
         }
@@ -11,6 +11,10 @@
 
 #include "../common.h"
 
+#include <functional>
+#include <string>
+#include <vector>
+
 /**
  * Class for enumerating and retrieving values for a set of command line arguments.
  */
@@ -77,6 +81,8 @@ struct CommandLineCommand
     const CommandLineOptionDefinition* Options;
     const CommandLineCommand* SubCommands;
     CommandLineFunc Func;
+    // Options may also be given before or between the other arguments, see CommandLine::PopPositionalArguments
+    bool OptionsAnywhere;
 };
 
 enum
@@ -99,16 +105,20 @@ constexpr char NAC = '\0';
     }
 #define CommandTableEnd                                                                                                        \
     {                                                                                                                          \
-        nullptr, nullptr, nullptr, nullptr, nullptr                                                                            \
+        nullptr, nullptr, nullptr, nullptr, nullptr, false                                                                     \
     }
 
 #define DefineCommand(name, params, options, func)                                                                             \
     {                                                                                                                          \
-        name, params, options, nullptr, func                                                                                   \
+        name, params, options, nullptr, func, false                                                                            \
+    }
+#define DefineCommandOptionsAnywhere(name, params, options, func)                                                              \
+    {                                                                                                                          \
+        name, params, options, nullptr, func, true                                                                             \
     }
 #define DefineSubCommand(name, subcommandtable)                                                                                \
     {                                                                                                                          \
-        name, "", nullptr, subcommandtable, nullptr                                                                            \
+        name, "", nullptr, subcommandtable, nullptr, false                                                                     \
     }
 
 namespace CommandLine
@@ -119,7 +129,9 @@ namespace CommandLine
     extern const CommandLineCommand BenchGfxCommands[];
     extern const CommandLineCommand BenchSpriteSortCommands[];
     extern const CommandLineCommand BenchUpdateCommands[];
+    extern const CommandLineCommand BenchSawyerCodingCommands[];
     extern const CommandLineCommand SimulateCommands[];
+    extern const CommandLineCommand ReplayCommands[];
 
     extern const CommandLineExample RootExamples[];
 
@@ -128,4 +140,26 @@ namespace CommandLine
 
     exitcode_t HandleCommandConvert(CommandLineArgEnumerator* enumerator);
     exitcode_t HandleCommandUri(CommandLineArgEnumerator* enumerator);
+
+    /**
+     * Pops the remaining arguments and returns those that are neither options nor option values, for commands that
+     * accept their options anywhere. The options themselves have already been parsed by then.
+     */
+    std::vector<std::string> PopPositionalArguments(
+        const CommandLineOptionDefinition* options, CommandLineArgEnumerator* argEnumerator);
+
+    /**
+     * Prints how many ticks took how long to run, for the commands that run the game logic as fast as possible.
+     */
+    void PrintTickRate(uint32_t numTicks, double seconds);
+
+    /**
+     * Runs this executable once for each of the given argument lists, numJobs at a time or one per core if 0, and prints
+     * the output of each run as it finishes. The game state is global, so this is how commands work on several parks at
+     * once. Where child processes can not be started, runInProcess is called with the index of each argument list in turn
+     * instead. Returns the number of runs that failed.
+     */
+    size_t RunChildProcesses(
+        const std::vector<std::string>& argumentLists, size_t numJobs,
+        const std::function<exitcode_t(size_t)>& runInProcess = nullptr);
 } // namespace CommandLine
@@ -0,0 +1,134 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "../Context.h"
+#include "../Game.h"
+#include "../GameState.h"
+#include "../OpenRCT2.h"
+#include "../ReplayManager.h"
+#include "../core/Console.hpp"
+#include "../core/String.hpp"
+#include "../platform/platform.h"
+#include "../world/Sprite.h"
+#include "CommandLine.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace OpenRCT2;
+
+static int32_t _seekTick = 0;
+static int32_t _jobs = 0;
+
+// clang-format off
+static constexpr const CommandLineOptionDefinition ReplayOptions[]
+{
+    { CMDLINE_TYPE_INTEGER, &_seekTick, NAC, "seek", "start from the last checkpoint before this tick"      },
+    { CMDLINE_TYPE_INTEGER, &_jobs,     NAC, "jobs", "number of replays to run at once when given several" },
+    OptionTableEnd
+};
+
+static exitcode_t HandleReplay(CommandLineArgEnumerator* argEnumerator);
+
+const CommandLineCommand CommandLine::ReplayCommands[]
+{
+    // Main commands
+    DefineCommandOptionsAnywhere("", "<file> [<file>]...", ReplayOptions, HandleReplay),
+    CommandTableEnd
+};
+// clang-format on
+
+/**
+ * Plays back a replay without rendering, as fast as the game logic allows.
+ */
+static exitcode_t RunReplay(const char* replayPath, uint32_t seekTick)
+{
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    std::unique_ptr<IContext> context(CreateContext());
+    if (!context->Initialise())
+    {
+        Console::Error::WriteLine("Context initialization failed.");
+        return EXITCODE_FAIL;
+    }
+
+    auto replayManager = context->GetReplayManager();
+    if (!replayManager->StartPlayback(replayPath, seekTick))
+    {
+        Console::Error::WriteLine("Unable to start replay '%s'.", replayPath);
+        return EXITCODE_FAIL;
+    }
+
+    ReplayRecordInfo info;
+    replayManager->GetCurrentReplayInfo(info);
+    uint32_t startTick = gCurrentTicks;
+    Console::WriteLine(
+        "Playing %s from tick %u, %u ticks, %u checkpoints...", info.FilePath.c_str(), startTick, info.Ticks,
+        info.NumCheckpoints);
+
+    auto gameState = context->GetGameState();
+    auto startTime = std::chrono::high_resolution_clock::now();
+    while (replayManager->IsReplaying())
+    {
+        gameState->UpdateLogic();
+        if (replayManager->IsPlaybackStateMismatching())
+            break;
+    }
+    std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - startTime;
+
+    CommandLine::PrintTickRate(gCurrentTicks - startTick, duration.count());
+
+    if (replayManager->IsPlaybackStateMismatching())
+    {
+        // The state is checked at the start of a tick, before the tick counter is advanced.
+        Console::Error::WriteLine("Replay state mismatch at tick %u.", gCurrentTicks - 1);
+        return EXITCODE_FAIL;
+    }
+    Console::WriteLine("Replay completed: %s", sprite_checksum().ToString().c_str());
+    return EXITCODE_OK;
+}
+
+static exitcode_t HandleReplay(CommandLineArgEnumerator* argEnumerator)
+{
+    auto replayPaths = CommandLine::PopPositionalArguments(ReplayOptions, argEnumerator);
+
+    if (replayPaths.empty())
+    {
+        Console::Error::WriteLine("Missing argument <file>.");
+        return EXITCODE_FAIL;
+    }
+
+    core_init();
+
+    uint32_t seekTick = static_cast<uint32_t>(std::max(_seekTick, 0));
+    if (replayPaths.size() == 1)
+    {
+        return RunReplay(replayPaths[0].c_str(), seekTick);
+    }
+
+    std::vector<std::string> argumentLists;
+    for (const auto& replayPath : replayPaths)
+    {
+        argumentLists.push_back(String::StdFormat("replay \"%s\" --seek %u", replayPath.c_str(), seekTick));
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    size_t numFailed = CommandLine::RunChildProcesses(
+        argumentLists, static_cast<size_t>(std::max(_jobs, 0)),
+        [&](size_t index) { return RunReplay(replayPaths[index].c_str(), seekTick); });
+    std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - startTime;
+
+    Console::WriteLine(
+        "%zu of %zu replays passed in %.3f s", replayPaths.size() - numFailed, replayPaths.size(), duration.count());
+    return numFailed == 0 ? EXITCODE_OK : EXITCODE_FAIL;
+}
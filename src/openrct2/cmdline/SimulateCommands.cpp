@@ -12,64 +12,314 @@
 #include "../GameState.h"
 #include "../OpenRCT2.h"
 #include "../core/Console.hpp"
+#include "../core/File.h"
+#include "../core/Json.hpp"
+#include "../core/Path.hpp"
+#include "../core/String.hpp"
 #include "../network/network.h"
 #include "../platform/platform.h"
 #include "../world/Sprite.h"
 #include "CommandLine.hpp"
 
+#include <algorithm>
+#include <cctype>
+#include <chrono>
 #include <cstdlib>
+#include <limits>
 #include <memory>
+#include <string>
+#include <vector>
 
 using namespace OpenRCT2;
 
-static exitcode_t HandleSimulate(CommandLineArgEnumerator* argEnumerator);
+static utf8* _profilePath = nullptr;
+static int32_t _jobs = 0;
 
-const CommandLineCommand CommandLine::SimulateCommands[]{ // Main commands
-                                                          DefineCommand("", "<ticks>", nullptr, HandleSimulate), CommandTableEnd
+// clang-format off
+static constexpr const CommandLineOptionDefinition SimulateOptions[]
+{
+    { CMDLINE_TYPE_STRING,  &_profilePath, NAC, "profile", "write the time per tick of each part of the update to a .json or .csv file" },
+    { CMDLINE_TYPE_INTEGER, &_jobs,        NAC, "jobs",    "number of parks to simulate at once when given several"                   },
+    OptionTableEnd
 };
 
-static exitcode_t HandleSimulate(CommandLineArgEnumerator* argEnumerator)
+static exitcode_t HandleSimulate(CommandLineArgEnumerator* argEnumerator);
+
+const CommandLineCommand CommandLine::SimulateCommands[]
 {
-    const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
-    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    // Main commands
+    DefineCommandOptionsAnywhere("", "<file> [<file>]... <ticks>", SimulateOptions, HandleSimulate),
+    CommandTableEnd
+};
+// clang-format on
+
+// Scripts is the last part of the update
+static constexpr size_t LogicTimePartCount = static_cast<size_t>(LogicTimePart::Scripts) + 1;
 
-    if (argc < 2)
+// There is no default case so the compiler warns when a part is added without a name
+static const char* GetLogicTimePartName(LogicTimePart part)
+{
+    switch (part)
     {
-        Console::Error::WriteLine("Missing arguments <sv6-file> <ticks>.");
-        return EXITCODE_FAIL;
+        case LogicTimePart::NetworkUpdate:
+            return "NetworkUpdate";
+        case LogicTimePart::Date:
+            return "Date";
+        case LogicTimePart::Scenario:
+            return "Scenario";
+        case LogicTimePart::Climate:
+            return "Climate";
+        case LogicTimePart::MapTiles:
+            return "MapTiles";
+        case LogicTimePart::MapStashProvisionalElements:
+            return "MapStashProvisionalElements";
+        case LogicTimePart::MapPathWideFlags:
+            return "MapPathWideFlags";
+        case LogicTimePart::StateHash:
+            return "StateHash";
+        case LogicTimePart::Peep:
+            return "Peep";
+        case LogicTimePart::MapRestoreProvisionalElements:
+            return "MapRestoreProvisionalElements";
+        case LogicTimePart::Vehicle:
+            return "Vehicle";
+        case LogicTimePart::Misc:
+            return "Misc";
+        case LogicTimePart::Ride:
+            return "Ride";
+        case LogicTimePart::Park:
+            return "Park";
+        case LogicTimePart::Research:
+            return "Research";
+        case LogicTimePart::RideRatings:
+            return "RideRatings";
+        case LogicTimePart::RideMeasurments:
+            return "RideMeasurments";
+        case LogicTimePart::News:
+            return "News";
+        case LogicTimePart::MapAnimation:
+            return "MapAnimation";
+        case LogicTimePart::Sounds:
+            return "Sounds";
+        case LogicTimePart::GameActions:
+            return "GameActions";
+        case LogicTimePart::NetworkFlush:
+            return "NetworkFlush";
+        case LogicTimePart::Scripts:
+            return "Scripts";
     }
+    return "Unknown";
+}
 
-    core_init();
+struct SimulateProfileEntry
+{
+    std::string Name;
+    double MeanMs;
+    double P50Ms;
+    double P99Ms;
+    double MaxMs;
+    double TotalMs;
+};
+
+/**
+ * Summarises the time taken by one part of the update on each tick, in seconds.
+ */
+static SimulateProfileEntry GetProfileEntry(const char* name, std::vector<double>& samples)
+{
+    SimulateProfileEntry entry{ name, 0, 0, 0, 0, 0 };
+    if (samples.empty())
+        return entry;
+
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](size_t p) { return samples[(samples.size() - 1) * p / 100] * 1000; };
+    for (auto sample : samples)
+    {
+        entry.TotalMs += sample * 1000;
+    }
+    entry.MeanMs = entry.TotalMs / samples.size();
+    entry.P50Ms = percentile(50);
+    entry.P99Ms = percentile(99);
+    entry.MaxMs = samples.back() * 1000;
+    return entry;
+}
 
-    const char* inputPath = argv[0];
-    uint32_t ticks = atol(argv[1]);
+static bool WriteProfile(
+    const std::string& path, const std::string& parkPath, uint32_t ticks, double seconds,
+    const std::vector<SimulateProfileEntry>& entries)
+{
+    try
+    {
+        if (String::Equals(Path::GetExtension(path), ".csv", true))
+        {
+            std::string csv = "part,mean_ms,p50_ms,p99_ms,max_ms,total_ms\n";
+            for (const auto& entry : entries)
+            {
+                csv += String::StdFormat(
+                    "%s,%.6f,%.6f,%.6f,%.6f,%.3f\n", entry.Name.c_str(), entry.MeanMs, entry.P50Ms, entry.P99Ms, entry.MaxMs,
+                    entry.TotalMs);
+            }
+            File::WriteAllBytes(path, csv.data(), csv.size());
+        }
+        else
+        {
+            json_t parts = json_t::object();
+            for (const auto& entry : entries)
+            {
+                parts[entry.Name] = { { "mean_ms", entry.MeanMs }, { "p50_ms", entry.P50Ms }, { "p99_ms", entry.P99Ms },
+                                      { "max_ms", entry.MaxMs },   { "total_ms", entry.TotalMs } };
+            }
+            json_t profile = { { "park", parkPath },
+                               { "ticks", ticks },
+                               { "seconds", seconds },
+                               { "ticks_per_second", seconds > 0 ? ticks / seconds : 0 },
+                               { "parts", parts } };
+            Json::WriteToFile(path.c_str(), profile);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        Console::Error::WriteLine("Unable to write profile '%s': %s", path.c_str(), e.what());
+        return false;
+    }
+    return true;
+}
 
+static exitcode_t RunSimulation(const std::string& inputPath, uint32_t ticks, const utf8* profilePath)
+{
     gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
 
 #ifndef DISABLE_NETWORK
     gNetworkStart = NETWORK_MODE_SERVER;
 #endif
 
     std::unique_ptr<IContext> context(CreateContext());
-    if (context->Initialise())
+    if (!context->Initialise())
+    {
+        Console::Error::WriteLine("Context initialization failed.");
+        return EXITCODE_FAIL;
+    }
+    if (!context->LoadParkFromFile(inputPath))
     {
-        if (!context->LoadParkFromFile(inputPath))
+        return EXITCODE_FAIL;
+    }
+
+    // Allocate everything up front so the measurements are not disturbed by it
+    bool profile = profilePath != nullptr;
+    auto timings = std::make_unique<LogicTimings>();
+    std::vector<std::vector<double>> partSamples(profile ? LogicTimePartCount : 0);
+    std::vector<double> tickSamples;
+    if (profile)
+    {
+        for (auto& samples : partSamples)
         {
-            return EXITCODE_FAIL;
+            samples.reserve(ticks);
+        }
+        tickSamples.reserve(ticks);
+    }
+
+    Console::WriteLine("Running %u ticks...", ticks);
+    auto gameState = context->GetGameState();
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < ticks; i++)
+    {
+        if (!profile)
+        {
+            gameState->UpdateLogic();
+            continue;
         }
 
-        Console::WriteLine("Running %d ticks...", ticks);
-        for (uint32_t i = 0; i < ticks; i++)
+        // Only the first measurement slot is used, it is read back straight after each tick.
+        timings->CurrentIdx = 0;
+        auto tickStartTime = std::chrono::high_resolution_clock::now();
+        gameState->UpdateLogic(timings.get());
+        std::chrono::duration<double> tickDuration = std::chrono::high_resolution_clock::now() - tickStartTime;
+
+        tickSamples.push_back(tickDuration.count());
+        for (const auto& [part, samples] : timings->TimingInfo)
         {
-            context->GetGameState()->UpdateLogic();
+            partSamples[static_cast<size_t>(part)].push_back(samples[0].count());
         }
-        Console::WriteLine("Completed: %s", sprite_checksum().ToString().c_str());
     }
-    else
+    std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - startTime;
+
+    CommandLine::PrintTickRate(ticks, duration.count());
+    Console::WriteLine("Completed: %s", sprite_checksum().ToString().c_str());
+
+    if (profile)
     {
-        Console::Error::WriteLine("Context initialization failed.");
+        std::vector<SimulateProfileEntry> entries;
+        for (size_t i = 0; i < LogicTimePartCount; i++)
+        {
+            if (!partSamples[i].empty())
+            {
+                entries.push_back(GetProfileEntry(GetLogicTimePartName(static_cast<LogicTimePart>(i)), partSamples[i]));
+            }
+        }
+        entries.push_back(GetProfileEntry("Tick", tickSamples));
+
+        if (!WriteProfile(profilePath, inputPath, ticks, duration.count(), entries))
+        {
+            return EXITCODE_FAIL;
+        }
+    }
+    return EXITCODE_OK;
+}
+
+static exitcode_t HandleSimulate(CommandLineArgEnumerator* argEnumerator)
+{
+    auto arguments = CommandLine::PopPositionalArguments(SimulateOptions, argEnumerator);
+    if (arguments.size() < 2)
+    {
+        Console::Error::WriteLine("Missing arguments <sv6-file> <ticks>.");
         return EXITCODE_FAIL;
     }
 
-    return EXITCODE_OK;
+    // The tick count comes last, so a forgotten one would otherwise be read from a file name
+    const auto& ticksArgument = arguments.back();
+    char* ticksEnd = nullptr;
+    unsigned long parsedTicks = std::strtoul(ticksArgument.c_str(), &ticksEnd, 10);
+    if (ticksArgument.empty() || !std::isdigit(static_cast<unsigned char>(ticksArgument[0])) || *ticksEnd != '\0'
+        || parsedTicks == 0 || parsedTicks > std::numeric_limits<uint32_t>::max())
+    {
+        Console::Error::WriteLine("Invalid tick count '%s', expected a positive number.", ticksArgument.c_str());
+        return EXITCODE_FAIL;
+    }
+    uint32_t ticks = static_cast<uint32_t>(parsedTicks);
+    arguments.pop_back();
+
+    core_init();
+
+    if (arguments.size() == 1)
+    {
+        return RunSimulation(arguments[0], ticks, _profilePath);
+    }
+
+    // Each park writes its own profile, named after the park
+    std::vector<std::string> argumentLists;
+    std::vector<std::string> parkProfilePaths;
+    for (const auto& inputPath : arguments)
+    {
+        auto argumentList = String::StdFormat("simulate \"%s\" %u", inputPath.c_str(), ticks);
+        if (_profilePath != nullptr)
+        {
+            std::string profilePath = _profilePath;
+            auto parkProfilePath = Path::Combine(
+                Path::GetDirectory(profilePath),
+                Path::GetFileNameWithoutExtension(profilePath) + "-" + Path::GetFileNameWithoutExtension(inputPath)
+                    + Path::GetExtension(profilePath));
+            argumentList += String::StdFormat(" --profile \"%s\"", parkProfilePath.c_str());
+            parkProfilePaths.push_back(std::move(parkProfilePath));
+        }
+        argumentLists.push_back(std::move(argumentList));
+    }
+
+    auto runInProcess = [&](size_t index) {
+        const utf8* parkProfilePath = parkProfilePaths.empty() ? nullptr : parkProfilePaths[index].c_str();
+        return RunSimulation(arguments[index], ticks, parkProfilePath);
+    };
+
+    size_t numFailed = CommandLine::RunChildProcesses(argumentLists, static_cast<size_t>(std::max(_jobs, 0)), runInProcess);
+    Console::WriteLine("%zu of %zu parks simulated", arguments.size() - numFailed, arguments.size());
+    return numFailed == 0 ? EXITCODE_OK : EXITCODE_FAIL;
 }
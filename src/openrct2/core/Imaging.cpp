@@ -162,93 +162,164 @@ namespace Imaging
         }
     }
 
-    static void WritePng(std::ostream& ostream, const Image& image)
+    struct PngWriteState
     {
         png_structp png_ptr = nullptr;
+        png_infop info_ptr = nullptr;
         png_colorp png_palette = nullptr;
-        try
+
+        ~PngWriteState()
         {
-            png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, PngError, PngWarning);
-            if (png_ptr == nullptr)
+            if (png_ptr != nullptr)
             {
-                throw std::runtime_error("png_create_write_struct failed.");
+                png_free(png_ptr, png_palette);
+                png_destroy_write_struct(&png_ptr, &info_ptr);
             }
+        }
+    };
 
-            png_text text_ptr[1];
-            text_ptr[0].key = const_cast<char*>("Software");
-            text_ptr[0].text = const_cast<char*>(gVersionInfoFull);
-            text_ptr[0].compression = PNG_TEXT_COMPRESSION_zTXt;
-
-            auto info_ptr = png_create_info_struct(png_ptr);
-            if (info_ptr == nullptr)
-            {
-                throw std::runtime_error("png_create_info_struct failed.");
-            }
+    static void BeginPng(
+        PngWriteState& state, std::ostream& ostream, uint32_t width, uint32_t height, uint32_t depth,
+        const GamePalette* palette)
+    {
+        auto& png_ptr = state.png_ptr;
+        png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, PngError, PngWarning);
+        if (png_ptr == nullptr)
+        {
+            throw std::runtime_error("png_create_write_struct failed.");
+        }
 
-            if (image.Depth == 8)
-            {
-                if (image.Palette == nullptr)
-                {
-                    throw std::runtime_error("Expected a palette for 8-bit image.");
-                }
+        png_text text_ptr[1];
+        text_ptr[0].key = const_cast<char*>("Software");
+        text_ptr[0].text = const_cast<char*>(gVersionInfoFull);
+        text_ptr[0].compression = PNG_TEXT_COMPRESSION_zTXt;
 
-                // Set the palette
-                png_palette = static_cast<png_colorp>(png_malloc(png_ptr, PNG_MAX_PALETTE_LENGTH * sizeof(png_color)));
-                if (png_palette == nullptr)
-                {
-                    throw std::runtime_error("png_malloc failed.");
-                }
-                for (size_t i = 0; i < PNG_MAX_PALETTE_LENGTH; i++)
-                {
-                    const auto& entry = (*image.Palette)[static_cast<uint16_t>(i)];
-                    png_palette[i].blue = entry.Blue;
-                    png_palette[i].green = entry.Green;
-                    png_palette[i].red = entry.Red;
-                }
-                png_set_PLTE(png_ptr, info_ptr, png_palette, PNG_MAX_PALETTE_LENGTH);
-            }
-
-            png_set_write_fn(png_ptr, &ostream, PngWriteData, PngFlush);
+        auto& info_ptr = state.info_ptr;
+        info_ptr = png_create_info_struct(png_ptr);
+        if (info_ptr == nullptr)
+        {
+            throw std::runtime_error("png_create_info_struct failed.");
+        }
 
-            // Set error handler
-            if (setjmp(png_jmpbuf(png_ptr)))
+        if (depth == 8)
+        {
+            if (palette == nullptr)
             {
-                throw std::runtime_error("PNG ERROR");
+                throw std::runtime_error("Expected a palette for 8-bit image.");
             }
 
-            // Write header
-            auto colourType = PNG_COLOR_TYPE_RGB_ALPHA;
-            if (image.Depth == 8)
+            // Set the palette
+            state.png_palette = static_cast<png_colorp>(png_malloc(png_ptr, PNG_MAX_PALETTE_LENGTH * sizeof(png_color)));
+            if (state.png_palette == nullptr)
             {
-                png_byte transparentIndex = 0;
-                png_set_tRNS(png_ptr, info_ptr, &transparentIndex, 1, nullptr);
-                colourType = PNG_COLOR_TYPE_PALETTE;
+                throw std::runtime_error("png_malloc failed.");
             }
-            png_set_text(png_ptr, info_ptr, text_ptr, 1);
-            png_set_IHDR(
-                png_ptr, info_ptr, image.Width, image.Height, 8, colourType, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
-                PNG_FILTER_TYPE_DEFAULT);
-            png_write_info(png_ptr, info_ptr);
-
-            // Write pixels
-            auto pixels = image.Pixels.data();
-            for (uint32_t y = 0; y < image.Height; y++)
+            for (size_t i = 0; i < PNG_MAX_PALETTE_LENGTH; i++)
             {
-                png_write_row(png_ptr, const_cast<png_byte*>(pixels));
-                pixels += image.Stride;
+                const auto& entry = (*palette)[static_cast<uint16_t>(i)];
+                state.png_palette[i].blue = entry.Blue;
+                state.png_palette[i].green = entry.Green;
+                state.png_palette[i].red = entry.Red;
             }
+            png_set_PLTE(png_ptr, info_ptr, state.png_palette, PNG_MAX_PALETTE_LENGTH);
+        }
+
+        png_set_write_fn(png_ptr, &ostream, PngWriteData, PngFlush);
 
-            png_write_end(png_ptr, nullptr);
-            png_destroy_info_struct(png_ptr, &info_ptr);
-            png_free(png_ptr, png_palette);
-            png_destroy_write_struct(&png_ptr, nullptr);
+        // Set error handler
+        if (setjmp(png_jmpbuf(png_ptr)))
+        {
+            throw std::runtime_error("PNG ERROR");
         }
-        catch (const std::exception&)
+
+        // Write header
+        auto colourType = PNG_COLOR_TYPE_RGB_ALPHA;
+        if (depth == 8)
         {
-            png_free(png_ptr, png_palette);
-            png_destroy_write_struct(&png_ptr, nullptr);
-            throw;
+            png_byte transparentIndex = 0;
+            png_set_tRNS(png_ptr, info_ptr, &transparentIndex, 1, nullptr);
+            colourType = PNG_COLOR_TYPE_PALETTE;
+        }
+        png_set_text(png_ptr, info_ptr, text_ptr, 1);
+        png_set_IHDR(
+            png_ptr, info_ptr, width, height, 8, colourType, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
+            PNG_FILTER_TYPE_DEFAULT);
+        png_write_info(png_ptr, info_ptr);
+    }
+
+    static void WritePngRows(PngWriteState& state, const uint8_t* pixels, uint32_t numRows, uint32_t stride)
+    {
+        // Set error handler
+        if (setjmp(png_jmpbuf(state.png_ptr)))
+        {
+            throw std::runtime_error("PNG ERROR");
         }
+
+        for (uint32_t y = 0; y < numRows; y++)
+        {
+            png_write_row(state.png_ptr, const_cast<png_byte*>(pixels));
+            pixels += stride;
+        }
+    }
+
+    static void EndPng(PngWriteState& state)
+    {
+        // Set error handler
+        if (setjmp(png_jmpbuf(state.png_ptr)))
+        {
+            throw std::runtime_error("PNG ERROR");
+        }
+
+        png_write_end(state.png_ptr, nullptr);
+    }
+
+    static void WritePng(std::ostream& ostream, const Image& image)
+    {
+        PngWriteState state;
+        BeginPng(state, ostream, image.Width, image.Height, image.Depth, image.Palette.get());
+        WritePngRows(state, image.Pixels.data(), image.Height, image.Stride);
+        EndPng(state);
+    }
+
+    static void OpenFileForWriting(std::ofstream& fs, std::string_view path)
+    {
+#if defined(_WIN32) && !defined(__MINGW32__)
+        auto pathW = String::ToWideChar(path);
+        fs.open(pathW, std::ios::binary);
+#else
+        fs.open(std::string(path), std::ios::binary);
+#endif
+        if (!fs.is_open())
+        {
+            throw std::runtime_error("Unable to open file for writing.");
+        }
+    }
+
+    struct PngStreamWriter::State
+    {
+        std::ofstream Stream;
+        PngWriteState Png;
+    };
+
+    PngStreamWriter::PngStreamWriter(
+        std::string_view path, uint32_t width, uint32_t height, uint32_t depth, const GamePalette* palette)
+        : _state(std::make_unique<State>())
+    {
+        OpenFileForWriting(_state->Stream, path);
+        BeginPng(_state->Png, _state->Stream, width, height, depth, palette);
+    }
+
+    PngStreamWriter::~PngStreamWriter() = default;
+
+    void PngStreamWriter::WriteRows(const uint8_t* pixels, uint32_t numRows, uint32_t stride)
+    {
+        WritePngRows(_state->Png, pixels, numRows, stride);
+    }
+
+    void PngStreamWriter::Finish()
+    {
+        EndPng(_state->Png);
+        _state->Stream.close();
     }
 
     IMAGE_FORMAT GetImageFormatFromPath(std::string_view path)
@@ -338,12 +409,8 @@ namespace Imaging
                 break;
             case IMAGE_FORMAT::PNG:
             {
-#if defined(_WIN32) && !defined(__MINGW32__)
-                auto pathW = String::ToWideChar(path);
-                std::ofstream fs(pathW, std::ios::binary);
-#else
-                std::ofstream fs(std::string(path), std::ios::binary);
-#endif
+                std::ofstream fs;
+                OpenFileForWriting(fs, path);
                 WritePng(fs, image);
                 break;
             }
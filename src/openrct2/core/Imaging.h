@@ -52,4 +52,21 @@ namespace Imaging
     void WriteToFile(std::string_view path, const Image& image, IMAGE_FORMAT format = IMAGE_FORMAT::AUTOMATIC);
 
     void SetReader(IMAGE_FORMAT format, ImageReaderFunc impl);
+
+    /**
+     * Writes a PNG file a few rows at a time, so images too large to hold in memory can still be written.
+     */
+    class PngStreamWriter
+    {
+    private:
+        struct State;
+        std::unique_ptr<State> _state;
+
+    public:
+        PngStreamWriter(std::string_view path, uint32_t width, uint32_t height, uint32_t depth, const GamePalette* palette);
+        ~PngStreamWriter();
+
+        void WriteRows(const uint8_t* pixels, uint32_t numRows, uint32_t stride);
+        void Finish();
+    };
 } // namespace Imaging
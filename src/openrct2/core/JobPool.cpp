@@ -11,115 +11,475 @@
 
 #include <algorithm>
 #include <cassert>
+#include <thread>
 
-JobPool::TaskData::TaskData(std::function<void()> workFn, std::function<void()> completionFn)
-    : WorkFn(workFn)
-    , CompletionFn(completionFn)
+namespace
 {
-}
+    struct ScheduledTask
+    {
+        JobPool* Owner{};
+        std::function<void()> WorkFn;
+        std::function<void()> CompletionFn;
+        void (*RangeFn)(void* context, size_t begin, size_t end){};
+        void* RangeContext{};
+        size_t RangeBegin{};
+        size_t RangeEnd{};
+    };
 
-JobPool::JobPool(size_t maxThreads)
+    /**
+     * Tasks queued by one thread. The owning thread pushes and pops at the back, other threads steal from the front.
+     * The ring buffer only grows, so once warmed up queueing a task does not allocate.
+     */
+    class WorkQueue
+    {
+    private:
+        std::mutex _mutex;
+        std::vector<ScheduledTask> _ring;
+        size_t _head{};
+        size_t _count{};
+        std::atomic<size_t> _size{};
+
+    public:
+        std::atomic_bool InUse{};
+
+        bool IsEmpty() const
+        {
+            return _size.load(std::memory_order_relaxed) == 0;
+        }
+
+        void Push(ScheduledTask&& task)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_count == _ring.size())
+            {
+                Grow();
+            }
+            _ring[(_head + _count) & (_ring.size() - 1)] = std::move(task);
+            _count++;
+            _size.store(_count, std::memory_order_relaxed);
+        }
+
+        bool PopBack(ScheduledTask& task)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_count == 0)
+                return false;
+
+            _count--;
+            auto& slot = _ring[(_head + _count) & (_ring.size() - 1)];
+            task = std::move(slot);
+            slot = {};
+            _size.store(_count, std::memory_order_relaxed);
+            return true;
+        }
+
+        bool PopFront(ScheduledTask& task)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_count == 0)
+                return false;
+
+            auto& slot = _ring[_head];
+            task = std::move(slot);
+            slot = {};
+            _head = (_head + 1) & (_ring.size() - 1);
+            _count--;
+            _size.store(_count, std::memory_order_relaxed);
+            return true;
+        }
+
+    private:
+        void Grow()
+        {
+            // Capacity is kept a power of two so indices can be wrapped with a mask
+            std::vector<ScheduledTask> ring(std::max<size_t>(64, _ring.size() * 2));
+            for (size_t i = 0; i < _count; i++)
+            {
+                ring[i] = std::move(_ring[(_head + i) & (_ring.size() - 1)]);
+            }
+            _ring = std::move(ring);
+            _head = 0;
+        }
+    };
+
+    constexpr size_t QUEUE_INDEX_NONE = SIZE_MAX;
+
+    // Queue used by the current thread, workers own theirs for their lifetime
+    struct QueueLease
+    {
+        size_t Index = QUEUE_INDEX_NONE;
+        bool IsWorker = false;
+
+        ~QueueLease();
+    };
+
+    thread_local QueueLease _queueLease;
+    std::atomic_bool _schedulerAlive = { false };
+} // namespace
+
+class JobScheduler
+{
+private:
+    // Queues for threads that are not workers, the last one is shared once all the others are taken
+    static constexpr size_t MaxExternalQueues = 64;
+
+    std::vector<std::thread> _threads;
+    std::unique_ptr<WorkQueue[]> _queues;
+    size_t _numWorkers{};
+    size_t _numQueues{};
+    std::atomic<size_t> _queued = { 0 };
+    std::atomic<size_t> _sleeping = { 0 };
+    std::atomic_bool _shouldStop = { false };
+    std::condition_variable _condSleep;
+    std::mutex _sleepMutex;
+
+public:
+    static JobScheduler& Get()
+    {
+        static JobScheduler scheduler;
+        return scheduler;
+    }
+
+    JobScheduler()
+    {
+        auto numCores = std::thread::hardware_concurrency();
+        // The thread joining a job pool runs tasks as well, so one less worker than cores are needed. There is always
+        // at least one worker so a task waiting on another thread can not hold up everything queued behind it.
+        _numWorkers = std::max<size_t>(1, numCores > 1 ? numCores - 1 : 0);
+        _numQueues = _numWorkers + MaxExternalQueues;
+        _queues = std::make_unique<WorkQueue[]>(_numQueues);
+        _queues[_numQueues - 1].InUse = true;
+        _schedulerAlive = true;
+
+        for (size_t n = 0; n < _numWorkers; n++)
+        {
+            _queues[n].InUse = true;
+            _threads.emplace_back(&JobScheduler::ProcessQueue, this, n);
+        }
+    }
+
+    ~JobScheduler()
+    {
+        _schedulerAlive = false;
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            _shouldStop = true;
+            _condSleep.notify_all();
+        }
+
+        for (auto& th : _threads)
+        {
+            assert(th.joinable() != false);
+            th.join();
+        }
+    }
+
+    size_t GetNumWorkers() const
+    {
+        return _numWorkers;
+    }
+
+    void Push(ScheduledTask&& task)
+    {
+        _queued++;
+        GetLocalQueue().Push(std::move(task));
+
+        // Only take the lock if a worker may be waiting for work
+        if (_sleeping > 0)
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            _condSleep.notify_one();
+        }
+    }
+
+    /**
+     * Runs a task queued by the calling thread, most recently queued first.
+     */
+    bool RunLocalTask()
+    {
+        ScheduledTask task;
+        if (!GetLocalQueue().PopBack(task))
+            return false;
+
+        _queued--;
+        Run(task);
+        return true;
+    }
+
+    void ReleaseQueue(size_t index)
+    {
+        if (index < _numQueues - 1)
+        {
+            _queues[index].InUse = false;
+        }
+    }
+
+private:
+    WorkQueue& GetLocalQueue()
+    {
+        if (_queueLease.Index == QUEUE_INDEX_NONE)
+        {
+            _queueLease.Index = _numQueues - 1;
+            for (size_t i = _numWorkers; i < _numQueues - 1; i++)
+            {
+                bool expected = false;
+                if (_queues[i].InUse.compare_exchange_strong(expected, true))
+                {
+                    _queueLease.Index = i;
+                    break;
+                }
+            }
+        }
+        return _queues[_queueLease.Index];
+    }
+
+    bool TryTakeTask(size_t self, ScheduledTask& task)
+    {
+        if (_queues[self].PopBack(task))
+            return true;
+
+        // Steal the oldest task of another thread, starting after our own queue to spread out the thieves
+        for (size_t n = 1; n < _numQueues; n++)
+        {
+            auto& queue = _queues[(self + n) % _numQueues];
+            if (!queue.IsEmpty() && queue.PopFront(task))
+                return true;
+        }
+        return false;
+    }
+
+    static void Run(ScheduledTask& task)
+    {
+        if (task.RangeFn != nullptr)
+        {
+            task.RangeFn(task.RangeContext, task.RangeBegin, task.RangeEnd);
+        }
+        else
+        {
+            task.WorkFn();
+        }
+
+        // Release whatever the task captured before the joining thread can be woken up
+        auto* owner = task.Owner;
+        auto completionFn = std::move(task.CompletionFn);
+        task = {};
+        owner->FinishTask(std::move(completionFn));
+    }
+
+    void ProcessQueue(size_t index)
+    {
+        _queueLease.Index = index;
+        _queueLease.IsWorker = true;
+
+        ScheduledTask task;
+        while (!_shouldStop)
+        {
+            if (TryTakeTask(index, task))
+            {
+                _queued--;
+                Run(task);
+                continue;
+            }
+
+            // Wait for work or cancellation.
+            std::unique_lock<std::mutex> lock(_sleepMutex);
+            _sleeping++;
+            _condSleep.wait(lock, [this]() { return _shouldStop || _queued > 0; });
+            _sleeping--;
+        }
+    }
+};
+
+QueueLease::~QueueLease()
 {
-    maxThreads = std::min<size_t>(maxThreads, std::thread::hardware_concurrency());
-    for (size_t n = 0; n < maxThreads; n++)
+    if (Index != QUEUE_INDEX_NONE && !IsWorker && _schedulerAlive)
     {
-        _threads.emplace_back(&JobPool::ProcessQueue, this);
+        JobScheduler::Get().ReleaseQueue(Index);
     }
 }
 
+JobPool::JobPool(size_t maxThreads)
+    : _maxThreads(maxThreads)
+    , _serial(maxThreads <= 1)
+{
+}
+
 JobPool::~JobPool()
 {
+    // Pools may outlive the scheduler during shutdown, so only join if there is something left to do
+    bool idle;
     {
         unique_lock lock(_mutex);
-        _shouldStop = true;
-        _condPending.notify_all();
+        idle = _outstanding == 0 && _completed.empty();
     }
-
-    for (auto& th : _threads)
+    if (!idle)
     {
-        assert(th.joinable() != false);
-        th.join();
+        Join();
     }
 }
 
 void JobPool::AddTask(std::function<void()> workFn, std::function<void()> completionFn)
 {
-    unique_lock lock(_mutex);
-    _pending.emplace_back(workFn, completionFn);
-    _condPending.notify_one();
+    if (_serial)
+    {
+        // Run straight away on the calling thread, completion callbacks are still dispatched by Join
+        workFn();
+        if (completionFn)
+        {
+            unique_lock lock(_mutex);
+            _completed.push_back(std::move(completionFn));
+        }
+        return;
+    }
+
+    _outstanding++;
+    {
+        // Hold tasks back once as many are queued as this pool may use threads, they are queued as others finish
+        unique_lock lock(_mutex);
+        if (_running >= _maxThreads)
+        {
+            _backlog.emplace_back(std::move(workFn), std::move(completionFn));
+            return;
+        }
+        _running++;
+    }
+    Schedule(std::move(workFn), std::move(completionFn));
+}
+
+void JobPool::Schedule(std::function<void()>&& workFn, std::function<void()>&& completionFn)
+{
+    ScheduledTask task;
+    task.Owner = this;
+    task.WorkFn = std::move(workFn);
+    task.CompletionFn = std::move(completionFn);
+    JobScheduler::Get().Push(std::move(task));
 }
 
 void JobPool::Join(std::function<void()> reportFn)
 {
-    unique_lock lock(_mutex);
+    auto& scheduler = JobScheduler::Get();
+    std::vector<std::function<void()>> completed;
     while (true)
     {
-        // Wait for the queue to become empty or having completed tasks.
-        _condComplete.wait(lock, [this]() { return (_pending.empty() && _processing == 0) || !_completed.empty(); });
+        // Help out with the tasks queued by this thread rather than only waiting for the workers.
+        bool ranTask = scheduler.RunLocalTask();
 
-        // Dispatch all completion callbacks if there are any.
-        while (!_completed.empty())
+        bool done;
         {
-            auto taskData = _completed.front();
-            _completed.pop_front();
-
-            if (taskData.CompletionFn)
+            unique_lock lock(_mutex);
+            if (!ranTask)
             {
-                lock.unlock();
-
-                taskData.CompletionFn();
-
-                lock.lock();
+                // Wait for the pool to complete or having completed tasks.
+                _condComplete.wait(lock, [this]() { return _outstanding == 0 || !_completed.empty(); });
             }
+            completed.swap(_completed);
+            done = _outstanding == 0;
         }
 
-        if (reportFn)
+        // Dispatch all completion callbacks if there are any.
+        for (auto& completionFn : completed)
         {
-            lock.unlock();
+            completionFn();
+        }
+        completed.clear();
 
+        if (reportFn)
+        {
             reportFn();
-
-            lock.lock();
         }
 
         // If everything is empty and no more work has to be done we can stop waiting.
-        if (_completed.empty() && _pending.empty() && _processing == 0)
+        if (done)
         {
-            break;
+            unique_lock lock(_mutex);
+            if (_completed.empty() && _outstanding == 0)
+            {
+                break;
+            }
         }
     }
 }
 
 size_t JobPool::CountPending()
 {
-    return _pending.size();
+    return _outstanding;
 }
 
-void JobPool::ProcessQueue()
+size_t JobPool::GetThreadCount()
 {
-    unique_lock lock(_mutex);
-    do
-    {
-        // Wait for work or cancellation.
-        _condPending.wait(lock, [this]() { return _shouldStop || !_pending.empty(); });
-
-        if (!_pending.empty())
-        {
-            _processing++;
+    return JobScheduler::Get().GetNumWorkers() + 1;
+}
 
-            auto taskData = _pending.front();
-            _pending.pop_front();
+void JobPool::ParallelForRange(size_t begin, size_t end, size_t grainSize, RangeFn fn, void* context)
+{
+    if (begin >= end)
+        return;
 
-            lock.unlock();
+    const size_t count = end - begin;
+    if (grainSize == 0)
+    {
+        // A few chunks per thread so that threads finishing early can steal the remainder
+        grainSize = std::max<size_t>(1, count / (GetThreadCount() * 4));
+    }
+    if (_serial || count <= grainSize || GetThreadCount() == 1)
+    {
+        fn(context, begin, end);
+        return;
+    }
 
-            taskData.WorkFn();
+    // Use a separate group so only the range is waited for, not other tasks added to this pool
+    JobPool group(_maxThreads);
+    if (_maxThreads < GetThreadCount())
+    {
+        // Go through AddTask so the chunks are held back like any other task of this pool
+        for (size_t rangeBegin = begin; rangeBegin < end; rangeBegin += grainSize)
+        {
+            auto rangeEnd = std::min(rangeBegin + grainSize, end);
+            group.AddTask([fn, context, rangeBegin, rangeEnd]() { fn(context, rangeBegin, rangeEnd); });
+        }
+        group.Join();
+        return;
+    }
 
-            lock.lock();
+    auto& scheduler = JobScheduler::Get();
+    for (size_t rangeBegin = begin; rangeBegin < end; rangeBegin += grainSize)
+    {
+        ScheduledTask task;
+        task.Owner = &group;
+        task.RangeFn = fn;
+        task.RangeContext = context;
+        task.RangeBegin = rangeBegin;
+        task.RangeEnd = std::min(rangeBegin + grainSize, end);
 
-            _completed.push_back(std::move(taskData));
+        group._outstanding++;
+        scheduler.Push(std::move(task));
+    }
+    group.Join();
+}
 
-            _processing--;
-            _condComplete.notify_one();
-        }
-    } while (!_shouldStop);
+void JobPool::FinishTask(std::function<void()>&& completionFn)
+{
+    // The pool may be destroyed as soon as the joining thread sees no outstanding tasks, so it is
+    // only decremented while holding the lock and the pool is not touched after releasing it.
+    unique_lock lock(_mutex);
+    bool hasCompletion = completionFn != nullptr;
+    if (hasCompletion)
+    {
+        _completed.push_back(std::move(completionFn));
+    }
+    if (!_backlog.empty())
+    {
+        // Hand the thread slot of the finished task to the next one held back
+        auto [nextWorkFn, nextCompletionFn] = std::move(_backlog.front());
+        _backlog.pop_front();
+        Schedule(std::move(nextWorkFn), std::move(nextCompletionFn));
+    }
+    else if (_running > 0)
+    {
+        _running--;
+    }
+    if (--_outstanding == 0 || hasCompletion)
+    {
+        _condComplete.notify_all();
+    }
 }
@@ -11,35 +11,46 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <cstddef>
 #include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
-#include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+class JobScheduler;
+
+/**
+ * A group of tasks that run on the process wide work-stealing scheduler. All job pools share the same worker
+ * threads, so creating one is cheap. While joining, the calling thread runs the tasks it queued itself, so tasks
+ * complete even when there are no worker threads and nested joins do not deadlock.
+ */
 class JobPool
 {
 private:
-    struct TaskData
-    {
-        const std::function<void()> WorkFn;
-        const std::function<void()> CompletionFn;
-
-        TaskData(std::function<void()> workFn, std::function<void()> completionFn);
-    };
-
-    std::atomic_bool _shouldStop = { false };
-    std::atomic<size_t> _processing = { 0 };
-    std::vector<std::thread> _threads;
-    std::deque<TaskData> _pending;
-    std::deque<TaskData> _completed;
-    std::condition_variable _condPending;
+    using RangeFn = void (*)(void* context, size_t begin, size_t end);
+
+    std::atomic<size_t> _outstanding = { 0 };
+    std::vector<std::function<void()>> _completed;
     std::condition_variable _condComplete;
     std::mutex _mutex;
+    // Tasks that wait for one of the pool's running tasks to finish before being queued
+    std::deque<std::pair<std::function<void()>, std::function<void()>>> _backlog;
+    size_t _running{};
+    size_t _maxThreads;
+    bool _serial;
 
     using unique_lock = std::unique_lock<std::mutex>;
 
+    friend class JobScheduler;
+
 public:
+    /**
+     * @param maxThreads The most tasks of this pool that run at the same time. When 1 or less, tasks are run straight
+     *                   away by the thread adding them.
+     */
     JobPool(size_t maxThreads = 255);
     ~JobPool();
 
@@ -47,6 +58,32 @@ public:
     void Join(std::function<void()> reportFn = nullptr);
     size_t CountPending();
 
+    /**
+     * Calls fn(i) for every i in [begin, end) across the worker threads and returns once all of them are done.
+     * The range is split into chunks of grainSize indices, or a size suited to the number of threads if 0.
+     */
+    template<typename TFn> void ParallelFor(size_t begin, size_t end, TFn&& fn, size_t grainSize = 0)
+    {
+        using Fn = std::remove_reference_t<TFn>;
+        ParallelForRange(
+            begin, end, grainSize,
+            [](void* context, size_t rangeBegin, size_t rangeEnd) {
+                auto& rangeFn = *static_cast<Fn*>(context);
+                for (size_t i = rangeBegin; i < rangeEnd; i++)
+                {
+                    rangeFn(i);
+                }
+            },
+            const_cast<void*>(static_cast<const void*>(std::addressof(fn))));
+    }
+
+    /**
+     * Number of threads that run tasks, including the thread calling Join.
+     */
+    static size_t GetThreadCount();
+
 private:
-    void ProcessQueue();
+    void ParallelForRange(size_t begin, size_t end, size_t grainSize, RangeFn fn, void* context);
+    void Schedule(std::function<void()>&& workFn, std::function<void()>&& completionFn);
+    void FinishTask(std::function<void()>&& completionFn);
 };
@@ -0,0 +1,130 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "MemoryMappedFile.h"
+
+#include "IStream.hpp"
+#include "String.hpp"
+
+#ifdef _WIN32
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace OpenRCT2
+{
+#ifdef _WIN32
+    MemoryMappedFile::MemoryMappedFile(const std::string& path)
+    {
+        auto pathW = String::ToWideChar(path);
+        auto file = CreateFileW(
+            pathW.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            throw IOException(String::StdFormat("Unable to open '%s'", path.c_str()));
+        }
+        _fileHandle = file;
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize))
+        {
+            Close();
+            throw IOException(String::StdFormat("Unable to read the size of '%s'", path.c_str()));
+        }
+        _length = static_cast<size_t>(fileSize.QuadPart);
+
+        // Empty files can not be mapped, they are simply read as no data
+        if (_length != 0)
+        {
+            _mappingHandle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (_mappingHandle != nullptr)
+            {
+                _data = static_cast<const uint8_t*>(MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+            }
+            if (_data == nullptr)
+            {
+                Close();
+                throw IOException(String::StdFormat("Unable to map '%s'", path.c_str()));
+            }
+        }
+    }
+
+    void MemoryMappedFile::Close()
+    {
+        if (_data != nullptr)
+        {
+            UnmapViewOfFile(_data);
+            _data = nullptr;
+        }
+        if (_mappingHandle != nullptr)
+        {
+            CloseHandle(_mappingHandle);
+            _mappingHandle = nullptr;
+        }
+        if (_fileHandle != nullptr)
+        {
+            CloseHandle(_fileHandle);
+            _fileHandle = nullptr;
+        }
+        _length = 0;
+    }
+#else
+    MemoryMappedFile::MemoryMappedFile(const std::string& path)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+        {
+            throw IOException(String::StdFormat("Unable to open '%s'", path.c_str()));
+        }
+
+        struct stat fileStat;
+        if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+        {
+            close(fd);
+            throw IOException(String::StdFormat("Unable to open '%s'", path.c_str()));
+        }
+        _length = static_cast<size_t>(fileStat.st_size);
+
+        // Empty files can not be mapped, they are simply read as no data
+        if (_length != 0)
+        {
+            void* data = mmap(nullptr, _length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED)
+            {
+                close(fd);
+                _length = 0;
+                throw IOException(String::StdFormat("Unable to map '%s'", path.c_str()));
+            }
+            _data = static_cast<const uint8_t*>(data);
+        }
+
+        // The mapping stays valid after the file is closed
+        close(fd);
+    }
+
+    void MemoryMappedFile::Close()
+    {
+        if (_data != nullptr)
+        {
+            munmap(const_cast<uint8_t*>(_data), _length);
+            _data = nullptr;
+        }
+        _length = 0;
+    }
+#endif
+
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+        Close();
+    }
+} // namespace OpenRCT2
@@ -0,0 +1,50 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+
+#include <string>
+
+namespace OpenRCT2
+{
+    /**
+     * A file mapped into memory for reading. Only the pages that are read get loaded from disk, so reading a small part
+     * of a large file is cheap.
+     */
+    class MemoryMappedFile final
+    {
+    private:
+        const uint8_t* _data = nullptr;
+        size_t _length = 0;
+#ifdef _WIN32
+        void* _fileHandle = nullptr;
+        void* _mappingHandle = nullptr;
+#endif
+
+    public:
+        explicit MemoryMappedFile(const std::string& path);
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+        MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+        ~MemoryMappedFile();
+
+        const uint8_t* GetData() const
+        {
+            return _data;
+        }
+        size_t GetLength() const
+        {
+            return _length;
+        }
+
+    private:
+        void Close();
+    };
+} // namespace OpenRCT2
@@ -122,6 +122,12 @@ namespace OpenRCT2
         return _data;
     }
 
+    void MemoryStream::Clear()
+    {
+        _dataSize = 0;
+        _position = _data;
+    }
+
     bool MemoryStream::CanRead() const
     {
         return (_access & MEMORY_ACCESS::READ) != 0;
@@ -52,6 +52,11 @@ namespace OpenRCT2
         void* GetDataCopy() const;
         void* TakeData();
 
+        /**
+         * Empties the stream while keeping the allocated buffer for the data written next.
+         */
+        void Clear();
+
         ///////////////////////////////////////////////////////////////////////////
         // ISteam methods
         ///////////////////////////////////////////////////////////////////////////
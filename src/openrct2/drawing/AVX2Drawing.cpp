@@ -42,6 +42,109 @@ void mask_avx2(
     }
 }
 
+void palette_lookup_avx2(
+    int32_t width, int32_t height, const uint8_t* RESTRICT src, uint32_t* RESTRICT dst, const uint32_t* RESTRICT palette,
+    int32_t srcWrap, int32_t dstWrap)
+{
+    const int* paletteInts = reinterpret_cast<const int*>(palette);
+    for (int32_t yy = 0; yy < height; yy++)
+    {
+        int32_t xx = 0;
+        for (; xx + 16 <= width; xx += 16)
+        {
+            const __m128i indices = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + xx));
+            const __m256i indices1 = _mm256_cvtepu8_epi32(indices);
+            const __m256i indices2 = _mm256_cvtepu8_epi32(_mm_srli_si128(indices, 8));
+            const __m256i pixels1 = _mm256_i32gather_epi32(paletteInts, indices1, 4);
+            const __m256i pixels2 = _mm256_i32gather_epi32(paletteInts, indices2, 4);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + xx), pixels1);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + xx + 8), pixels2);
+        }
+        for (; xx < width; xx++)
+        {
+            dst[xx] = palette[src[xx]];
+        }
+        src += width + srcWrap;
+        dst += width + dstWrap;
+    }
+}
+
+// Looks up 32 indices in a 256 entry table held as 16 rows of 16 bytes. For each row the indices are
+// xor'd with the row's high nibble, only the matching indices are then below 16, and the saturating
+// add leaves those with bit 7 clear while pushing all others above 0x80, which pshufb turns into zero.
+static inline __m256i LookupTableAvx2(const __m256i (&tables)[16], __m256i indices)
+{
+    const __m256i saturate = _mm256_set1_epi8(0x70);
+    __m256i result = _mm256_setzero_si256();
+    for (int32_t i = 0; i < 16; i++)
+    {
+        const __m256i row = _mm256_xor_si256(indices, _mm256_set1_epi8(static_cast<char>(i << 4)));
+        const __m256i shuffle = _mm256_adds_epu8(row, saturate);
+        result = _mm256_or_si256(result, _mm256_shuffle_epi8(tables[i], shuffle));
+    }
+    return result;
+}
+
+static inline void LoadLookupTableAvx2(const uint8_t* table, __m256i (&tables)[16])
+{
+    for (int32_t i = 0; i < 16; i++)
+    {
+        tables[i] = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table + i * 16)));
+    }
+}
+
+void blit_row_transparent_avx2(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count)
+{
+    const __m256i zero = {};
+    int32_t i = 0;
+    for (; i + 32 <= count; i += 32)
+    {
+        const __m256i colour = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        const __m256i dest = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        const __m256i transparent = _mm256_cmpeq_epi8(colour, zero);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_blendv_epi8(colour, dest, transparent));
+    }
+    blit_row_transparent_scalar(src + i, dst + i, count - i);
+}
+
+template<bool TGlass>
+static void BlitRowTableAvx2(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t count)
+{
+    int32_t i = 0;
+    if (count >= 32)
+    {
+        __m256i tables[16];
+        LoadLookupTableAvx2(table, tables);
+        const __m256i zero = {};
+        for (; i + 32 <= count; i += 32)
+        {
+            const __m256i colour = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            const __m256i dest = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+            const __m256i pixel = LookupTableAvx2(tables, TGlass ? dest : colour);
+            const __m256i keep = _mm256_or_si256(_mm256_cmpeq_epi8(colour, zero), _mm256_cmpeq_epi8(pixel, zero));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_blendv_epi8(pixel, dest, keep));
+        }
+    }
+    if constexpr (TGlass)
+    {
+        blit_row_glass_scalar(src + i, dst + i, table, count - i);
+    }
+    else
+    {
+        blit_row_remap_scalar(src + i, dst + i, table, count - i);
+    }
+}
+
+void blit_row_remap_avx2(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t count)
+{
+    BlitRowTableAvx2<false>(src, dst, table, count);
+}
+
+void blit_row_glass_avx2(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t count)
+{
+    BlitRowTableAvx2<true>(src, dst, table, count);
+}
+
 #else
 
 #    ifdef OPENRCT2_X86
@@ -55,4 +158,26 @@ void mask_avx2(
     openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
 }
 
+void palette_lookup_avx2(
+    int32_t width, int32_t height, const uint8_t* RESTRICT src, uint32_t* RESTRICT dst, const uint32_t* RESTRICT palette,
+    int32_t srcWrap, int32_t dstWrap)
+{
+    openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+}
+
+void blit_row_transparent_avx2(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count)
+{
+    openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+}
+
+void blit_row_remap_avx2(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t count)
+{
+    openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+}
+
+void blit_row_glass_avx2(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t count)
+{
+    openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+}
+
 #endif // __AVX2__
@@ -49,6 +49,18 @@ template<DrawBlendOp TBlendOp> static void FASTCALL DrawBMPSpriteMinify(DrawSpri
     size_t srcLineWidth = g1.width * zoomLevel;
     size_t dstLineWidth = (static_cast<size_t>(dpi->width) / zoomLevel) + dpi->pitch;
     uint8_t zoom = 1 * zoomLevel;
+    if (zoom == 1)
+    {
+        // Every pixel is sampled at this zoom level, so whole rows can be drawn at once
+        for (; height > 0; height--)
+        {
+            BlitPixelRow<TBlendOp>(src, dst, paletteMap, width);
+            src += srcLineWidth;
+            dst += dstLineWidth;
+        }
+        return;
+    }
+
     for (; height > 0; height -= zoom)
     {
         auto nextSrc = src + srcLineWidth;
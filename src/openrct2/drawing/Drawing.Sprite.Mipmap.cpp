@@ -0,0 +1,405 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "../sprites.h"
+#include "Drawing.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#ifndef __MACOSX__
+#    include <shared_mutex>
+#endif
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Below this zoom level minifying skips few enough source pixels that a copy is not worth the memory
+static constexpr int8_t SpriteMipmapMinZoom = 2;
+static constexpr size_t SpriteMipmapCapacity = 16 * 1024 * 1024;
+static constexpr size_t SpriteMipmapShardCount = 16;
+static constexpr size_t SpriteMipmapShardCapacity = SpriteMipmapCapacity / SpriteMipmapShardCount;
+
+/**
+ * The pixels a zoomed out draw of an image samples, stored as a bitmap where 0 is transparent.
+ */
+struct SpriteMipmap
+{
+    std::vector<uint8_t> Pixels;
+    int16_t Width{};
+    int16_t Height{};
+    // Position of the first pixel in zoomed pixels, relative to where the image is anchored on the destination
+    int32_t OffsetX{};
+    int32_t OffsetY{};
+};
+
+/**
+ * Cache of mipmaps, keyed by image index, zoom level and the row phase the image is sampled at. Viewport columns can be
+ * painted on several threads, so the cache is split into shards by image index, each with its own lock. Draws only take
+ * a shard's lock for reading; instead of reordering a list they stamp the entry with the shard's insertion count, and the
+ * entries with the oldest stamps are evicted when a shard is full.
+ */
+class SpriteMipmapCache
+{
+private:
+    struct Entry
+    {
+        std::shared_ptr<const SpriteMipmap> Mipmap;
+        size_t Size;
+        std::atomic<uint64_t> LastUsed;
+
+        Entry(std::shared_ptr<const SpriteMipmap>&& mipmap, size_t size, uint64_t lastUsed)
+            : Mipmap(std::move(mipmap))
+            , Size(size)
+            , LastUsed(lastUsed)
+        {
+        }
+    };
+
+#ifndef __MACOSX__
+    using shared_mutex = std::shared_mutex;
+    using shared_lock = std::shared_lock<std::shared_mutex>;
+    using unique_lock = std::unique_lock<std::shared_mutex>;
+#else
+    using shared_mutex = std::mutex;
+    using shared_lock = std::unique_lock<std::mutex>;
+    using unique_lock = std::unique_lock<std::mutex>;
+#endif
+
+    struct Shard
+    {
+        shared_mutex Mutex;
+        std::unordered_map<uint64_t, Entry> Entries;
+        size_t Bytes{};
+        // Number of mipmaps added, only changed with the lock held for writing
+        uint64_t Clock{};
+        std::atomic<uint64_t> Hits{};
+        std::atomic<uint64_t> Misses{};
+        uint64_t Evictions{};
+    };
+
+    std::array<Shard, SpriteMipmapShardCount> _shards;
+
+    Shard& GetShard(uint64_t key)
+    {
+        return _shards[(key >> 16) % SpriteMipmapShardCount];
+    }
+
+    /**
+     * Evicts the least recently drawn entries until a quarter of the shard is free, so that the entries are not sorted
+     * again for every mipmap that is added.
+     */
+    static void Evict(Shard& shard, uint64_t keepKey)
+    {
+        std::vector<std::pair<uint64_t, uint64_t>> entriesByAge;
+        entriesByAge.reserve(shard.Entries.size());
+        for (const auto& [key, entry] : shard.Entries)
+        {
+            if (key != keepKey)
+            {
+                entriesByAge.emplace_back(entry.LastUsed.load(std::memory_order_relaxed), key);
+            }
+        }
+        std::sort(entriesByAge.begin(), entriesByAge.end());
+
+        for (const auto& [lastUsed, key] : entriesByAge)
+        {
+            if (shard.Bytes <= SpriteMipmapShardCapacity / 4 * 3)
+            {
+                break;
+            }
+            auto it = shard.Entries.find(key);
+            shard.Bytes -= it->second.Size;
+            shard.Entries.erase(it);
+            shard.Evictions++;
+        }
+    }
+
+public:
+    static uint64_t GetKey(uint32_t imageIndex, int8_t zoomLevel, int32_t phaseY)
+    {
+        return (static_cast<uint64_t>(imageIndex) << 16) | (static_cast<uint64_t>(zoomLevel) << 8)
+            | static_cast<uint64_t>(phaseY);
+    }
+
+    std::shared_ptr<const SpriteMipmap> Get(uint64_t key)
+    {
+        auto& shard = GetShard(key);
+        shared_lock lock(shard.Mutex);
+        auto it = shard.Entries.find(key);
+        if (it == shard.Entries.end())
+        {
+            shard.Misses.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        shard.Hits.fetch_add(1, std::memory_order_relaxed);
+
+        // Most draws are of images already drawn since the last mipmap was added, leave those entries alone
+        auto& lastUsed = it->second.LastUsed;
+        if (lastUsed.load(std::memory_order_relaxed) != shard.Clock)
+        {
+            lastUsed.store(shard.Clock, std::memory_order_relaxed);
+        }
+        return it->second.Mipmap;
+    }
+
+    void Add(uint64_t key, std::shared_ptr<const SpriteMipmap> mipmap)
+    {
+        auto& shard = GetShard(key);
+        unique_lock lock(shard.Mutex);
+        size_t size = sizeof(Entry) + sizeof(SpriteMipmap) + mipmap->Pixels.size();
+        auto [it, inserted] = shard.Entries.try_emplace(key, std::move(mipmap), size, shard.Clock);
+        if (!inserted)
+        {
+            // Another thread got there first
+            return;
+        }
+
+        shard.Clock++;
+        shard.Bytes += size;
+        if (shard.Bytes > SpriteMipmapShardCapacity)
+        {
+            Evict(shard, key);
+        }
+    }
+
+    void RemoveImage(uint32_t imageIndex)
+    {
+        auto& shard = GetShard(GetKey(imageIndex, 0, 0));
+        unique_lock lock(shard.Mutex);
+        if (shard.Entries.empty())
+        {
+            return;
+        }
+
+        for (int8_t zoomLevel = SpriteMipmapMinZoom; zoomLevel <= static_cast<int8_t>(ZoomLevel::max()); zoomLevel++)
+        {
+            for (int32_t phaseY = 0; phaseY < (1 << zoomLevel); phaseY++)
+            {
+                auto it = shard.Entries.find(GetKey(imageIndex, zoomLevel, phaseY));
+                if (it != shard.Entries.end())
+                {
+                    shard.Bytes -= it->second.Size;
+                    shard.Entries.erase(it);
+                }
+            }
+        }
+    }
+
+    void Clear()
+    {
+        for (auto& shard : _shards)
+        {
+            unique_lock lock(shard.Mutex);
+            shard.Entries.clear();
+            shard.Bytes = 0;
+        }
+    }
+
+    SpriteMipmapStats GetStats()
+    {
+        SpriteMipmapStats stats{ 0, 0, 0, 0, 0, SpriteMipmapCapacity };
+        for (auto& shard : _shards)
+        {
+            shared_lock lock(shard.Mutex);
+            stats.Hits += shard.Hits.load(std::memory_order_relaxed);
+            stats.Misses += shard.Misses.load(std::memory_order_relaxed);
+            stats.Evictions += shard.Evictions;
+            stats.Entries += shard.Entries.size();
+            stats.Bytes += shard.Bytes;
+        }
+        return stats;
+    }
+};
+
+static SpriteMipmapCache _spriteMipmapCache;
+
+struct SpriteMipmapAnchor
+{
+    int32_t X;
+    int32_t Y;
+    int32_t PhaseY;
+};
+
+/**
+ * Gets the position gfx_draw_sprite_element_software rounds the image to at the given zoom level. Only the RLE
+ * version samples different rows depending on where the image is drawn, the columns are always the same.
+ */
+static SpriteMipmapAnchor GetMipmapAnchor(const rct_g1_element& g1, const ScreenCoordsXY& coords, int8_t zoomLevel)
+{
+    int32_t zoom = 1 << zoomLevel;
+    int32_t zoomMask = ~(zoom - 1);
+    int32_t x = coords.x;
+    int32_t y = coords.y;
+    bool isRLE = (g1.flags & G1_FLAG_RLE_COMPRESSION) != 0;
+    if (isRLE)
+    {
+        x -= zoom - 1;
+        y -= zoom - 1;
+    }
+
+    SpriteMipmapAnchor anchor;
+    anchor.X = (x + g1.x_offset + zoom - 1) & zoomMask;
+    anchor.Y = (y + g1.y_offset) & zoomMask;
+    anchor.PhaseY = isRLE ? (y + g1.y_offset) & (zoom - 1) : 0;
+    return anchor;
+}
+
+/**
+ * Draws the image with the normal minify code onto a blank buffer and keeps the part of it that was drawn to.
+ */
+static std::shared_ptr<const SpriteMipmap> CreateMipmap(
+    uint32_t imageIndex, const rct_g1_element& g1, int8_t zoomLevel, int32_t phaseY)
+{
+    int32_t zoom = 1 << zoomLevel;
+    int32_t zoomMask = ~(zoom - 1);
+
+    // Choose a position that is sampled with the requested row phase
+    ScreenCoordsXY coords{};
+    if (g1.flags & G1_FLAG_RLE_COMPRESSION)
+    {
+        coords.y = phaseY - g1.y_offset + zoom - 1;
+    }
+    auto anchor = GetMipmapAnchor(g1, coords, zoomLevel);
+
+    // Leave a zoomed pixel of margin on every side so nothing is clipped
+    rct_drawpixelinfo dpi;
+    dpi.x = anchor.X - zoom;
+    dpi.y = anchor.Y - zoom;
+    dpi.width = ((g1.width + zoom - 1) & zoomMask) + 2 * zoom;
+    dpi.height = ((g1.height + zoom - 1) & zoomMask) + 2 * zoom;
+    dpi.pitch = 0;
+    dpi.zoom_level = zoomLevel;
+
+    int32_t bufferWidth = dpi.width >> zoomLevel;
+    int32_t bufferHeight = dpi.height >> zoomLevel;
+    std::vector<uint8_t> buffer(static_cast<size_t>(bufferWidth) * bufferHeight);
+    dpi.bits = buffer.data();
+    gfx_draw_sprite_element_software(&dpi, ImageId(imageIndex), g1, coords, PaletteMap::GetDefault());
+
+    int32_t left = bufferWidth;
+    int32_t top = bufferHeight;
+    int32_t right = 0;
+    int32_t bottom = 0;
+    for (int32_t y = 0; y < bufferHeight; y++)
+    {
+        const auto* row = buffer.data() + static_cast<size_t>(y) * bufferWidth;
+        for (int32_t x = 0; x < bufferWidth; x++)
+        {
+            if (row[x] != 0)
+            {
+                left = std::min(left, x);
+                right = std::max(right, x + 1);
+                top = std::min(top, y);
+                bottom = y + 1;
+            }
+        }
+    }
+
+    auto mipmap = std::make_shared<SpriteMipmap>();
+    if (left < right)
+    {
+        mipmap->Width = right - left;
+        mipmap->Height = bottom - top;
+        mipmap->OffsetX = left - 1;
+        mipmap->OffsetY = top - 1;
+        mipmap->Pixels.resize(static_cast<size_t>(mipmap->Width) * mipmap->Height);
+        for (int32_t y = 0; y < mipmap->Height; y++)
+        {
+            const auto* src = buffer.data() + static_cast<size_t>(top + y) * bufferWidth + left;
+            std::copy_n(src, mipmap->Width, mipmap->Pixels.data() + static_cast<size_t>(y) * mipmap->Width);
+        }
+    }
+    return mipmap;
+}
+
+/**
+ * Draws the image from a cached copy that has already been minified to the zoom level of the dpi. The result is identical
+ * to minifying the image on every draw. Returns false if the image or dpi can not be drawn this way.
+ */
+bool FASTCALL gfx_draw_sprite_mipmap_software(
+    rct_drawpixelinfo* dpi, ImageId imageId, const rct_g1_element& g1, const ScreenCoordsXY& coords,
+    const PaletteMap& paletteMap)
+{
+    auto zoomLevel = static_cast<int8_t>(dpi->zoom_level);
+    if (zoomLevel < SpriteMipmapMinZoom || zoomLevel > static_cast<int8_t>(ZoomLevel::max()))
+    {
+        return false;
+    }
+
+    // The sampled pixels only line up with the cached ones when the drawing area is on the zoomed pixel grid
+    int32_t zoom = 1 << zoomLevel;
+    if ((dpi->x | dpi->y | dpi->width | dpi->height) & (zoom - 1))
+    {
+        return false;
+    }
+
+    // Transparency has to be known, so bitmaps that draw colour 0 are left alone
+    if (!(g1.flags & G1_FLAG_RLE_COMPRESSION) && (!(g1.flags & G1_FLAG_BMP) || (g1.flags & G1_FLAG_1)))
+    {
+        return false;
+    }
+
+    // These are rewritten all the time
+    auto imageIndex = imageId.GetIndex();
+    if (imageIndex == SPR_TEMP || (imageIndex >= SPR_SCROLLING_TEXT_START && imageIndex < SPR_SCROLLING_TEXT_END))
+    {
+        return false;
+    }
+
+    auto anchor = GetMipmapAnchor(g1, coords, zoomLevel);
+    auto key = SpriteMipmapCache::GetKey(imageIndex, zoomLevel, anchor.PhaseY);
+    auto mipmap = _spriteMipmapCache.Get(key);
+    if (mipmap == nullptr)
+    {
+        mipmap = CreateMipmap(imageIndex, g1, zoomLevel, anchor.PhaseY);
+        _spriteMipmapCache.Add(key, mipmap);
+    }
+
+    if (mipmap->Pixels.empty())
+    {
+        return true;
+    }
+
+    rct_g1_element mipmapElement{};
+    mipmapElement.offset = const_cast<uint8_t*>(mipmap->Pixels.data());
+    mipmapElement.width = mipmap->Width;
+    mipmapElement.height = mipmap->Height;
+    mipmapElement.flags = G1_FLAG_BMP;
+
+    rct_drawpixelinfo zoomedDpi = *dpi;
+    zoomedDpi.x = dpi->x >> zoomLevel;
+    zoomedDpi.y = dpi->y >> zoomLevel;
+    zoomedDpi.width = dpi->width >> zoomLevel;
+    zoomedDpi.height = dpi->height >> zoomLevel;
+    zoomedDpi.zoom_level = 0;
+
+    const auto mipmapCoords = ScreenCoordsXY{ (anchor.X >> zoomLevel) + mipmap->OffsetX,
+                                              (anchor.Y >> zoomLevel) + mipmap->OffsetY };
+    gfx_draw_sprite_element_software(&zoomedDpi, imageId, mipmapElement, mipmapCoords, paletteMap);
+    return true;
+}
+
+void gfx_sprite_mipmap_invalidate(uint32_t imageIndex)
+{
+    _spriteMipmapCache.RemoveImage(imageIndex);
+}
+
+void gfx_sprite_mipmap_clear()
+{
+    _spriteMipmapCache.Clear();
+}
+
+SpriteMipmapStats gfx_sprite_mipmap_get_stats()
+{
+    return _spriteMipmapCache.GetStats();
+}
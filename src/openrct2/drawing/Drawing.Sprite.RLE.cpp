@@ -163,6 +163,10 @@ template<DrawBlendOp TBlendOp, size_t TZoom> static void FASTCALL DrawRLESpriteM
                     std::memcpy(dst, src, numPixels);
                 }
             }
+            else if constexpr (TZoom == 0)
+            {
+                BlitPixelRow<TBlendOp>(src, dst, args.PalMap, numPixels);
+            }
             else
             {
                 auto& paletteMap = args.PalMap;
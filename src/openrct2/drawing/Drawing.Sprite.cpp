@@ -178,6 +178,47 @@ void mask_scalar(
     }
 }
 
+void blit_row_transparent_scalar(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count)
+{
+    for (int32_t i = 0; i < count; i++)
+    {
+        if (src[i] != 0)
+        {
+            dst[i] = src[i];
+        }
+    }
+}
+
+void blit_row_remap_scalar(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t count)
+{
+    for (int32_t i = 0; i < count; i++)
+    {
+        if (src[i] != 0)
+        {
+            auto pixel = table[src[i]];
+            if (pixel != 0)
+            {
+                dst[i] = pixel;
+            }
+        }
+    }
+}
+
+void blit_row_glass_scalar(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t count)
+{
+    for (int32_t i = 0; i < count; i++)
+    {
+        if (src[i] != 0)
+        {
+            auto pixel = table[dst[i]];
+            if (pixel != 0)
+            {
+                dst[i] = pixel;
+            }
+        }
+    }
+}
+
 static rct_gx _g1 = {};
 static rct_gx _g2 = {};
 static rct_gx _csg = {};
@@ -244,6 +285,7 @@ void gfx_unload_g1()
     _g1.data.reset();
     _g1.elements.clear();
     _g1.elements.shrink_to_fit();
+    gfx_sprite_mipmap_clear();
 }
 
 void gfx_unload_g2()
@@ -251,6 +293,7 @@ void gfx_unload_g2()
     _g2.data.reset();
     _g2.elements.clear();
     _g2.elements.shrink_to_fit();
+    gfx_sprite_mipmap_clear();
 }
 
 void gfx_unload_csg()
@@ -258,6 +301,7 @@ void gfx_unload_csg()
     _csg.data.reset();
     _csg.elements.clear();
     _csg.elements.shrink_to_fit();
+    gfx_sprite_mipmap_clear();
 }
 
 bool gfx_load_g2()
@@ -459,6 +503,26 @@ void FASTCALL gfx_draw_sprite_palette_set_software(
         return;
     }
 
+    if (gfx_draw_sprite_mipmap_software(dpi, imageId, *g1, coords, paletteMap))
+    {
+        return;
+    }
+
+    gfx_draw_sprite_element_software(dpi, imageId, *g1, coords, paletteMap);
+}
+
+/**
+ * Clips the given image element against the drawing area and copies it onto the buffer at the zoom level of the dpi.
+ * @param imageId Only flags are used.
+ */
+void FASTCALL gfx_draw_sprite_element_software(
+    rct_drawpixelinfo* dpi, ImageId imageId, const rct_g1_element& g1Element, const ScreenCoordsXY& coords,
+    const PaletteMap& paletteMap)
+{
+    int32_t x = coords.x;
+    int32_t y = coords.y;
+    const auto* g1 = &g1Element;
+
     // Its used super often so we will define it to a separate variable.
     auto zoom_level = dpi->zoom_level;
     int32_t zoom_mask = zoom_level > 0 ? 0xFFFFFFFF * zoom_level : 0xFFFFFFFF;
@@ -73,6 +73,11 @@ uint8_t PaletteMap::Blend(uint8_t src, uint8_t dst) const
     return (*this)[idx];
 }
 
+const uint8_t* PaletteMap::GetTable() const
+{
+    return _dataLength >= 256 ? _data : nullptr;
+}
+
 void PaletteMap::Copy(size_t dstIndex, const PaletteMap& src, size_t srcIndex, size_t length)
 {
     auto maxLength = std::min(_mapLength - srcIndex, _mapLength - dstIndex);
@@ -571,6 +576,76 @@ void mask_init()
     }
 }
 
+void palette_lookup_scalar(
+    int32_t width, int32_t height, const uint8_t* RESTRICT src, uint32_t* RESTRICT dst, const uint32_t* RESTRICT palette,
+    int32_t srcWrap, int32_t dstWrap)
+{
+    for (int32_t yy = 0; yy < height; yy++)
+    {
+        for (int32_t xx = 0; xx < width; xx++)
+        {
+            dst[xx] = palette[src[xx]];
+        }
+        src += width + srcWrap;
+        dst += width + dstWrap;
+    }
+}
+
+void (*palette_lookup_fn)(
+    int32_t width, int32_t height, const uint8_t* RESTRICT src, uint32_t* RESTRICT dst, const uint32_t* RESTRICT palette,
+    int32_t srcWrap, int32_t dstWrap)
+    = nullptr;
+
+void palette_lookup_init()
+{
+    if (avx2_available())
+    {
+        log_verbose("registering AVX2 palette lookup function");
+        palette_lookup_fn = palette_lookup_avx2;
+    }
+    else if (sse41_available())
+    {
+        log_verbose("registering SSE4.1 palette lookup function");
+        palette_lookup_fn = palette_lookup_sse4_1;
+    }
+    else
+    {
+        log_verbose("registering scalar palette lookup function");
+        palette_lookup_fn = palette_lookup_scalar;
+    }
+}
+
+void (*blit_row_transparent_fn)(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count) = nullptr;
+void (*blit_row_remap_fn)(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t count)
+    = nullptr;
+void (*blit_row_glass_fn)(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t count)
+    = nullptr;
+
+void blit_row_init()
+{
+    if (avx2_available())
+    {
+        log_verbose("registering AVX2 sprite row functions");
+        blit_row_transparent_fn = blit_row_transparent_avx2;
+        blit_row_remap_fn = blit_row_remap_avx2;
+        blit_row_glass_fn = blit_row_glass_avx2;
+    }
+    else if (sse41_available())
+    {
+        log_verbose("registering SSE4.1 sprite row functions");
+        blit_row_transparent_fn = blit_row_transparent_sse4_1;
+        blit_row_remap_fn = blit_row_remap_sse4_1;
+        blit_row_glass_fn = blit_row_glass_sse4_1;
+    }
+    else
+    {
+        log_verbose("registering scalar sprite row functions");
+        blit_row_transparent_fn = blit_row_transparent_scalar;
+        blit_row_remap_fn = blit_row_remap_scalar;
+        blit_row_glass_fn = blit_row_glass_scalar;
+    }
+}
+
 void gfx_filter_pixel(rct_drawpixelinfo* dpi, const ScreenCoordsXY& coords, FilterPaletteID palette)
 {
     gfx_filter_rect(dpi, { coords, coords }, palette);
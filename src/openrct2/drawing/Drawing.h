@@ -17,6 +17,7 @@
 #include "Font.h"
 #include "Text.h"
 
+#include <cstring>
 #include <memory>
 #include <optional>
 #include <vector>
@@ -540,6 +541,11 @@ public:
     uint8_t operator[](size_t index) const;
     uint8_t Blend(uint8_t src, uint8_t dst) const;
     void Copy(size_t dstIndex, const PaletteMap& src, size_t srcIndex, size_t length);
+
+    /**
+     * Returns the map as a plain table of 256 entries, or nullptr if it is shorter than that.
+     */
+    const uint8_t* GetTable() const;
 };
 
 struct DrawSpriteArgs
@@ -570,6 +576,24 @@ struct DrawSpriteArgs
     }
 };
 
+void blit_row_transparent_scalar(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count);
+void blit_row_transparent_sse4_1(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count);
+void blit_row_transparent_avx2(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count);
+void blit_row_remap_scalar(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t count);
+void blit_row_remap_sse4_1(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t count);
+void blit_row_remap_avx2(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t count);
+void blit_row_glass_scalar(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t count);
+void blit_row_glass_sse4_1(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t count);
+void blit_row_glass_avx2(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t count);
+void blit_row_init();
+
+// Copies the non-zero source pixels.
+extern void (*blit_row_transparent_fn)(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count);
+// Writes table[src] for the non-zero source pixels, unless that is zero.
+extern void (*blit_row_remap_fn)(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t count);
+// Writes table[dst] for the non-zero source pixels, unless that is zero.
+extern void (*blit_row_glass_fn)(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t count);
+
 template<DrawBlendOp TBlendOp> bool FASTCALL BlitPixel(const uint8_t* src, uint8_t* dst, const PaletteMap& paletteMap)
 {
     if constexpr (TBlendOp & BLEND_TRANSPARENT)
@@ -642,6 +666,51 @@ void FASTCALL BlitPixels(const uint8_t* src, uint8_t* dst, const PaletteMap& pal
     }
 }
 
+/**
+ * Draws a row of pixels without any scaling. The common blend ops are handed to vectorised kernels.
+ */
+template<DrawBlendOp TBlendOp>
+void FASTCALL BlitPixelRow(const uint8_t* src, uint8_t* dst, const PaletteMap& paletteMap, int32_t count)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    if constexpr (TBlendOp == BLEND_NONE)
+    {
+        std::memcpy(dst, src, count);
+    }
+    else if constexpr (TBlendOp == BLEND_TRANSPARENT)
+    {
+        blit_row_transparent_fn(src, dst, count);
+    }
+    else
+    {
+        if constexpr (TBlendOp == (BLEND_TRANSPARENT | BLEND_SRC) || TBlendOp == (BLEND_TRANSPARENT | BLEND_DST))
+        {
+            auto table = paletteMap.GetTable();
+            if (table != nullptr)
+            {
+                if constexpr ((TBlendOp & BLEND_SRC) != 0)
+                {
+                    blit_row_remap_fn(src, dst, table, count);
+                }
+                else
+                {
+                    blit_row_glass_fn(src, dst, table, count);
+                }
+                return;
+            }
+        }
+
+        for (int32_t i = 0; i < count; i++)
+        {
+            BlitPixel<TBlendOp>(src + i, dst + i, paletteMap);
+        }
+    }
+}
+
 #define SPRITE_ID_PALETTE_COLOUR_1(colourId) (IMAGE_TYPE_REMAP | ((colourId) << 19))
 #define SPRITE_ID_PALETTE_COLOUR_2(primaryId, secondaryId)                                                                     \
     (IMAGE_TYPE_REMAP_2_PLUS | IMAGE_TYPE_REMAP | (((primaryId) << 19) | ((secondaryId) << 24)))
@@ -728,6 +797,26 @@ void FASTCALL gfx_draw_sprite_solid(rct_drawpixelinfo* dpi, int32_t image, const
 void FASTCALL gfx_draw_sprite_software(rct_drawpixelinfo* dpi, ImageId imageId, const ScreenCoordsXY& spriteCoords);
 void FASTCALL gfx_draw_sprite_palette_set_software(
     rct_drawpixelinfo* dpi, ImageId imageId, const ScreenCoordsXY& coords, const PaletteMap& paletteMap);
+void FASTCALL gfx_draw_sprite_element_software(
+    rct_drawpixelinfo* dpi, ImageId imageId, const rct_g1_element& g1Element, const ScreenCoordsXY& coords,
+    const PaletteMap& paletteMap);
+
+struct SpriteMipmapStats
+{
+    uint64_t Hits;
+    uint64_t Misses;
+    uint64_t Evictions;
+    size_t Entries;
+    size_t Bytes;
+    size_t Capacity;
+};
+
+bool FASTCALL gfx_draw_sprite_mipmap_software(
+    rct_drawpixelinfo* dpi, ImageId imageId, const rct_g1_element& g1, const ScreenCoordsXY& coords,
+    const PaletteMap& paletteMap);
+void gfx_sprite_mipmap_invalidate(uint32_t imageIndex);
+void gfx_sprite_mipmap_clear();
+SpriteMipmapStats gfx_sprite_mipmap_get_stats();
 void FASTCALL gfx_draw_sprite_raw_masked_software(
     rct_drawpixelinfo* dpi, const ScreenCoordsXY& scrCoords, int32_t maskImage, int32_t colourImage);
 
@@ -786,6 +875,24 @@ extern void (*mask_fn)(
     int32_t width, int32_t height, const uint8_t* RESTRICT maskSrc, const uint8_t* RESTRICT colourSrc, uint8_t* RESTRICT dst,
     int32_t maskWrap, int32_t colourWrap, int32_t dstWrap);
 
+void palette_lookup_scalar(
+    int32_t width, int32_t height, const uint8_t* RESTRICT src, uint32_t* RESTRICT dst, const uint32_t* RESTRICT palette,
+    int32_t srcWrap, int32_t dstWrap);
+void palette_lookup_sse4_1(
+    int32_t width, int32_t height, const uint8_t* RESTRICT src, uint32_t* RESTRICT dst, const uint32_t* RESTRICT palette,
+    int32_t srcWrap, int32_t dstWrap);
+void palette_lookup_avx2(
+    int32_t width, int32_t height, const uint8_t* RESTRICT src, uint32_t* RESTRICT dst, const uint32_t* RESTRICT palette,
+    int32_t srcWrap, int32_t dstWrap);
+void palette_lookup_init();
+
+/**
+ * Converts 8-bit palette indices into 32-bit pixels using a 256 entry table already in the destination's pixel format.
+ */
+extern void (*palette_lookup_fn)(
+    int32_t width, int32_t height, const uint8_t* RESTRICT src, uint32_t* RESTRICT dst, const uint32_t* RESTRICT palette,
+    int32_t srcWrap, int32_t dstWrap);
+
 std::optional<uint32_t> GetPaletteG1Index(colour_t paletteId);
 std::optional<PaletteMap> GetPaletteMapForColour(colour_t paletteId);
 
@@ -13,6 +13,7 @@
 
 #ifdef __SSE4_1__
 
+#    include <cstring>
 #    include <immintrin.h>
 
 void mask_sse4_1(
@@ -56,6 +57,110 @@ void mask_sse4_1(
     }
 }
 
+void palette_lookup_sse4_1(
+    int32_t width, int32_t height, const uint8_t* RESTRICT src, uint32_t* RESTRICT dst, const uint32_t* RESTRICT palette,
+    int32_t srcWrap, int32_t dstWrap)
+{
+    for (int32_t yy = 0; yy < height; yy++)
+    {
+        int32_t xx = 0;
+        for (; xx + 8 <= width; xx += 8)
+        {
+            // There is no gather before AVX2, so read eight indices at once and insert the colours with pinsrd
+            uint64_t indices;
+            std::memcpy(&indices, src + xx, sizeof(indices));
+            const __m128i pixels1 = _mm_setr_epi32(
+                palette[indices & 0xFF], palette[(indices >> 8) & 0xFF], palette[(indices >> 16) & 0xFF],
+                palette[(indices >> 24) & 0xFF]);
+            const __m128i pixels2 = _mm_setr_epi32(
+                palette[(indices >> 32) & 0xFF], palette[(indices >> 40) & 0xFF], palette[(indices >> 48) & 0xFF],
+                palette[indices >> 56]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + xx), pixels1);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + xx + 4), pixels2);
+        }
+        for (; xx < width; xx++)
+        {
+            dst[xx] = palette[src[xx]];
+        }
+        src += width + srcWrap;
+        dst += width + dstWrap;
+    }
+}
+
+// Looks up 16 indices in a 256 entry table held as 16 rows of 16 bytes, see LookupTableAvx2.
+static inline __m128i LookupTableSse41(const __m128i (&tables)[16], __m128i indices)
+{
+    const __m128i saturate = _mm_set1_epi8(0x70);
+    __m128i result = _mm_setzero_si128();
+    for (int32_t i = 0; i < 16; i++)
+    {
+        const __m128i row = _mm_xor_si128(indices, _mm_set1_epi8(static_cast<char>(i << 4)));
+        const __m128i shuffle = _mm_adds_epu8(row, saturate);
+        result = _mm_or_si128(result, _mm_shuffle_epi8(tables[i], shuffle));
+    }
+    return result;
+}
+
+static inline void LoadLookupTableSse41(const uint8_t* table, __m128i (&tables)[16])
+{
+    for (int32_t i = 0; i < 16; i++)
+    {
+        tables[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table + i * 16));
+    }
+}
+
+void blit_row_transparent_sse4_1(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count)
+{
+    const __m128i zero = {};
+    int32_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m128i colour = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i dest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        const __m128i transparent = _mm_cmpeq_epi8(colour, zero);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_blendv_epi8(colour, dest, transparent));
+    }
+    blit_row_transparent_scalar(src + i, dst + i, count - i);
+}
+
+template<bool TGlass>
+static void BlitRowTableSse41(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t count)
+{
+    int32_t i = 0;
+    if (count >= 16)
+    {
+        __m128i tables[16];
+        LoadLookupTableSse41(table, tables);
+        const __m128i zero = {};
+        for (; i + 16 <= count; i += 16)
+        {
+            const __m128i colour = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            const __m128i dest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+            const __m128i pixel = LookupTableSse41(tables, TGlass ? dest : colour);
+            const __m128i keep = _mm_or_si128(_mm_cmpeq_epi8(colour, zero), _mm_cmpeq_epi8(pixel, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_blendv_epi8(pixel, dest, keep));
+        }
+    }
+    if constexpr (TGlass)
+    {
+        blit_row_glass_scalar(src + i, dst + i, table, count - i);
+    }
+    else
+    {
+        blit_row_remap_scalar(src + i, dst + i, table, count - i);
+    }
+}
+
+void blit_row_remap_sse4_1(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t count)
+{
+    BlitRowTableSse41<false>(src, dst, table, count);
+}
+
+void blit_row_glass_sse4_1(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t count)
+{
+    BlitRowTableSse41<true>(src, dst, table, count);
+}
+
 #else
 
 #    ifdef OPENRCT2_X86
@@ -69,4 +174,26 @@ void mask_sse4_1(
     openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
 }
 
+void palette_lookup_sse4_1(
+    int32_t width, int32_t height, const uint8_t* RESTRICT src, uint32_t* RESTRICT dst, const uint32_t* RESTRICT palette,
+    int32_t srcWrap, int32_t dstWrap)
+{
+    openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+}
+
+void blit_row_transparent_sse4_1(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count)
+{
+    openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+}
+
+void blit_row_remap_sse4_1(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t count)
+{
+    openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+}
+
+void blit_row_glass_sse4_1(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t count)
+{
+    openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+}
+
 #endif // __SSE4_1__
@@ -116,6 +116,11 @@ void X8WeatherDrawer::Restore()
     }
 }
 
+bool X8WeatherDrawer::HasPixels() const
+{
+    return _weatherPixelsCount > 0;
+}
+
 #ifdef __WARN_SUGGEST_FINAL_METHODS__
 #    pragma GCC diagnostic push
 #    pragma GCC diagnostic ignored "-Wsuggest-final-methods"
@@ -211,6 +216,7 @@ void X8DrawingEngine::EndDraw()
 
 void X8DrawingEngine::PaintWindows()
 {
+    _dirtyStats = {};
     window_reset_visibilities();
 
     // Redraw dirty regions before updating the viewports, otherwise
@@ -296,6 +302,11 @@ rct_drawpixelinfo* X8DrawingEngine::GetDPI()
     return &_bitsDPI;
 }
 
+const DirtyStats& X8DrawingEngine::GetDirtyStats() const
+{
+    return _dirtyStats;
+}
+
 void X8DrawingEngine::ConfigureBits(uint32_t width, uint32_t height, uint32_t pitch)
 {
     size_t newBitsSize = pitch * height;
@@ -362,8 +373,10 @@ void X8DrawingEngine::OnDrawDirtyBlock(
 
 void X8DrawingEngine::ConfigureDirtyGrid()
 {
-    _dirtyGrid.BlockShiftX = 7;
-    _dirtyGrid.BlockShiftY = 6;
+    // Small blocks keep a moving sprite from repainting a large area around it,
+    // MergeDirtyRects joins them back up where that is cheaper.
+    _dirtyGrid.BlockShiftX = 5;
+    _dirtyGrid.BlockShiftY = 4;
     _dirtyGrid.BlockWidth = 1 << _dirtyGrid.BlockShiftX;
     _dirtyGrid.BlockHeight = 1 << _dirtyGrid.BlockShiftY;
     _dirtyGrid.BlockColumns = (_width >> _dirtyGrid.BlockShiftX) + 1;
@@ -375,6 +388,8 @@ void X8DrawingEngine::ConfigureDirtyGrid()
 
 void X8DrawingEngine::DrawAllDirtyBlocks()
 {
+    // Collect all the dirty regions first so that nearby ones can be drawn together
+    _dirtyRects.clear();
     for (uint32_t x = 0; x < _dirtyGrid.BlockColumns; x++)
     {
         for (uint32_t y = 0; y < _dirtyGrid.BlockRows; y++)
@@ -398,9 +413,18 @@ void X8DrawingEngine::DrawAllDirtyBlocks()
             // Check rows
             uint32_t columns = xx - x;
             auto rows = GetNumDirtyRows(x, y, columns);
-            DrawDirtyBlocks(x, y, columns, rows);
+            DirtyRect rect = { x, y, x + columns, y + rows };
+            ClearDirtyBlocks(rect);
+            _dirtyRects.push_back(rect);
+            _dirtyStats.Blocks += columns * rows;
         }
     }
+
+    MergeDirtyRects();
+    for (const auto& rect : _dirtyRects)
+    {
+        DrawDirtyBlocks(rect);
+    }
 }
 
 uint32_t X8DrawingEngine::GetNumDirtyRows(const uint32_t x, const uint32_t y, const uint32_t columns)
@@ -421,33 +445,203 @@ uint32_t X8DrawingEngine::GetNumDirtyRows(const uint32_t x, const uint32_t y, co
     return yy - y;
 }
 
-void X8DrawingEngine::DrawDirtyBlocks(uint32_t x, uint32_t y, uint32_t columns, uint32_t rows)
+void X8DrawingEngine::ClearDirtyBlocks(const DirtyRect& rect)
 {
     uint32_t dirtyBlockColumns = _dirtyGrid.BlockColumns;
     uint8_t* screenDirtyBlocks = _dirtyGrid.Blocks;
-
-    // Unset dirty blocks
-    for (uint32_t top = y; top < y + rows; top++)
+    for (uint32_t top = rect.Top; top < rect.Bottom; top++)
     {
         uint32_t topOffset = top * dirtyBlockColumns;
-        for (uint32_t left = x; left < x + columns; left++)
+        std::fill(screenDirtyBlocks + topOffset + rect.Left, screenDirtyBlocks + topOffset + rect.Right, 0);
+    }
+}
+
+static uint32_t GetDirtyRectArea(const DirtyRect& rect)
+{
+    return (rect.Right - rect.Left) * (rect.Bottom - rect.Top);
+}
+
+static bool DirtyRectsIntersect(const DirtyRect& a, const DirtyRect& b)
+{
+    return a.Left < b.Right && b.Left < a.Right && a.Top < b.Bottom && b.Top < a.Bottom;
+}
+
+static DirtyRect GetDirtyRectUnion(const DirtyRect& a, const DirtyRect& b)
+{
+    return { std::min(a.Left, b.Left), std::min(a.Top, b.Top), std::max(a.Right, b.Right), std::max(a.Bottom, b.Bottom) };
+}
+
+// Each region drawn walks every window and sets up a paint session for every viewport it
+// touches, so repainting up to this many clean pixels is cheaper than drawing another region.
+static constexpr uint32_t DirtyRectCostPixels = 64 * 64;
+
+// Merging is quadratic in the number of regions, beyond this they are first snapped to a coarser grid.
+static constexpr size_t MaxMergeableDirtyRects = 128;
+
+// The coarse grid uses the block size from before the blocks were made smaller, in pixels.
+static constexpr uint32_t CoarseDirtyBlockShiftX = 7;
+static constexpr uint32_t CoarseDirtyBlockShiftY = 6;
+
+void X8DrawingEngine::MergeDirtyRects()
+{
+    if (_dirtyRects.size() > MaxMergeableDirtyRects)
+    {
+        CoarsenDirtyRects();
+        _dirtyStats.CoarseMerge = true;
+    }
+    if (_dirtyRects.size() < 2 || _dirtyRects.size() > MaxMergeableDirtyRects)
+    {
+        return;
+    }
+
+    bool merged;
+    do
+    {
+        merged = false;
+        for (size_t a = 0; a < _dirtyRects.size(); a++)
+        {
+            for (size_t b = a + 1; b < _dirtyRects.size(); b++)
+            {
+                if (TryMergeDirtyRects(a, b))
+                {
+                    merged = true;
+                }
+            }
+        }
+
+        // Merged regions are left empty
+        _dirtyRects.erase(
+            std::remove_if(
+                _dirtyRects.begin(), _dirtyRects.end(), [](const DirtyRect& rect) { return GetDirtyRectArea(rect) == 0; }),
+            _dirtyRects.end());
+    } while (merged);
+}
+
+/**
+ * Replaces the regions with ones covering the same coarse blocks, so each coarse block is drawn at most once.
+ */
+void X8DrawingEngine::CoarsenDirtyRects()
+{
+    const uint32_t shiftX = CoarseDirtyBlockShiftX - std::min(CoarseDirtyBlockShiftX, _dirtyGrid.BlockShiftX);
+    const uint32_t shiftY = CoarseDirtyBlockShiftY - std::min(CoarseDirtyBlockShiftY, _dirtyGrid.BlockShiftY);
+    const uint32_t columns = ((_dirtyGrid.BlockColumns - 1) >> shiftX) + 1;
+    const uint32_t rows = ((_dirtyGrid.BlockRows - 1) >> shiftY) + 1;
+    _coarseDirtyBlocks.assign(columns * rows, 0);
+    uint8_t* blocks = _coarseDirtyBlocks.data();
+    for (const auto& rect : _dirtyRects)
+    {
+        const uint32_t left = rect.Left >> shiftX;
+        const uint32_t right = ((rect.Right - 1) >> shiftX) + 1;
+        for (uint32_t y = rect.Top >> shiftY; y <= (rect.Bottom - 1) >> shiftY; y++)
+        {
+            std::fill(blocks + y * columns + left, blocks + y * columns + right, 1);
+        }
+    }
+
+    _dirtyRects.clear();
+    for (uint32_t y = 0; y < rows; y++)
+    {
+        for (uint32_t x = 0; x < columns; x++)
+        {
+            if (blocks[y * columns + x] == 0)
+            {
+                continue;
+            }
+
+            uint32_t right = x + 1;
+            while (right < columns && blocks[y * columns + right] != 0)
+            {
+                right++;
+            }
+            uint32_t bottom = y + 1;
+            while (bottom < rows && std::find(blocks + bottom * columns + x, blocks + bottom * columns + right, 0)
+                       == blocks + bottom * columns + right)
+            {
+                bottom++;
+            }
+            for (uint32_t yy = y; yy < bottom; yy++)
+            {
+                std::fill(blocks + yy * columns + x, blocks + yy * columns + right, 0);
+            }
+
+            _dirtyRects.push_back({ x << shiftX, y << shiftY, std::min(right << shiftX, _dirtyGrid.BlockColumns),
+                                    std::min(bottom << shiftY, _dirtyGrid.BlockRows) });
+        }
+    }
+}
+
+/**
+ * Replaces region a with the bounds of a and b if drawing the clean blocks in between costs less than drawing
+ * b separately. Any other region overlapping those bounds is absorbed as well so that no pixel is drawn twice.
+ */
+bool X8DrawingEngine::TryMergeDirtyRects(size_t a, size_t b)
+{
+    const auto& rectA = _dirtyRects[a];
+    const auto& rectB = _dirtyRects[b];
+    if (GetDirtyRectArea(rectA) == 0 || GetDirtyRectArea(rectB) == 0)
+    {
+        return false;
+    }
+
+    const uint32_t blockPixels = _dirtyGrid.BlockWidth * _dirtyGrid.BlockHeight;
+    const uint32_t rectCost = std::max<uint32_t>(1, DirtyRectCostPixels / blockPixels);
+    auto bounds = GetDirtyRectUnion(rectA, rectB);
+    uint32_t dirtyArea = GetDirtyRectArea(rectA) + GetDirtyRectArea(rectB);
+    if (GetDirtyRectArea(bounds) > dirtyArea + rectCost)
+    {
+        return false;
+    }
+
+    _dirtyRectsToMerge.clear();
+    _dirtyRectsToMerge.push_back(b);
+    bool grown;
+    do
+    {
+        grown = false;
+        for (size_t i = 0; i < _dirtyRects.size(); i++)
         {
-            screenDirtyBlocks[topOffset + left] = 0;
+            const auto& rect = _dirtyRects[i];
+            if (i == a || GetDirtyRectArea(rect) == 0 || !DirtyRectsIntersect(bounds, rect)
+                || std::find(_dirtyRectsToMerge.begin(), _dirtyRectsToMerge.end(), i) != _dirtyRectsToMerge.end())
+            {
+                continue;
+            }
+            bounds = GetDirtyRectUnion(bounds, rect);
+            dirtyArea += GetDirtyRectArea(rect);
+            _dirtyRectsToMerge.push_back(i);
+            grown = true;
         }
+    } while (grown);
+
+    if (GetDirtyRectArea(bounds) > dirtyArea + rectCost * static_cast<uint32_t>(_dirtyRectsToMerge.size()))
+    {
+        return false;
     }
 
+    _dirtyRects[a] = bounds;
+    for (auto i : _dirtyRectsToMerge)
+    {
+        _dirtyRects[i] = {};
+    }
+    return true;
+}
+
+void X8DrawingEngine::DrawDirtyBlocks(const DirtyRect& rect)
+{
     // Determine region in pixels
-    uint32_t left = std::max<uint32_t>(0, x * _dirtyGrid.BlockWidth);
-    uint32_t top = std::max<uint32_t>(0, y * _dirtyGrid.BlockHeight);
-    uint32_t right = std::min(_width, left + (columns * _dirtyGrid.BlockWidth));
-    uint32_t bottom = std::min(_height, top + (rows * _dirtyGrid.BlockHeight));
+    uint32_t left = rect.Left * _dirtyGrid.BlockWidth;
+    uint32_t top = rect.Top * _dirtyGrid.BlockHeight;
+    uint32_t right = std::min(_width, rect.Right * _dirtyGrid.BlockWidth);
+    uint32_t bottom = std::min(_height, rect.Bottom * _dirtyGrid.BlockHeight);
     if (right <= left || bottom <= top)
     {
         return;
     }
 
     // Draw region
-    OnDrawDirtyBlock(x, y, columns, rows);
+    _dirtyStats.Rects++;
+    _dirtyStats.PixelsRepainted += static_cast<uint64_t>(right - left) * (bottom - top);
+    OnDrawDirtyBlock(rect.Left, rect.Top, rect.Right - rect.Left, rect.Bottom - rect.Top);
     window_draw_all(&_bitsDPI, left, top, right, bottom);
 }
 
@@ -13,6 +13,8 @@
 #include "IDrawingContext.h"
 #include "IDrawingEngine.h"
 
+#include <vector>
+
 namespace OpenRCT2
 {
     namespace Ui
@@ -35,6 +37,29 @@ namespace OpenRCT2
             uint8_t* Blocks;
         };
 
+        /**
+         * A rectangle of dirty blocks, in block units with an exclusive right and bottom.
+         */
+        struct DirtyRect
+        {
+            uint32_t Left;
+            uint32_t Top;
+            uint32_t Right;
+            uint32_t Bottom;
+        };
+
+        /**
+         * How much of the screen was redrawn by the last call to PaintWindows.
+         */
+        struct DirtyStats
+        {
+            uint32_t Blocks;
+            uint32_t Rects;
+            uint64_t PixelsRepainted;
+            // Too many regions were dirty to merge them individually, so they were snapped to a coarser grid first
+            bool CoarseMerge;
+        };
+
         class X8WeatherDrawer final : public IWeatherDrawer
         {
         private:
@@ -59,6 +84,7 @@ namespace OpenRCT2
                 int32_t x, int32_t y, int32_t width, int32_t height, int32_t xStart, int32_t yStart,
                 const uint8_t* weatherpattern) override;
             void Restore();
+            bool HasPixels() const;
         };
 
 #ifdef __WARN_SUGGEST_FINAL_TYPES__
@@ -75,6 +101,10 @@ namespace OpenRCT2
             uint8_t* _bits = nullptr;
 
             DirtyGrid _dirtyGrid = {};
+            DirtyStats _dirtyStats = {};
+            std::vector<DirtyRect> _dirtyRects;
+            std::vector<size_t> _dirtyRectsToMerge;
+            std::vector<uint8_t> _coarseDirtyBlocks;
 
             rct_drawpixelinfo _bitsDPI = {};
 
@@ -115,6 +145,7 @@ namespace OpenRCT2
             void InvalidateImage(uint32_t image) override;
 
             rct_drawpixelinfo* GetDPI();
+            const DirtyStats& GetDirtyStats() const;
 
         protected:
             void ConfigureBits(uint32_t width, uint32_t height, uint32_t pitch);
@@ -125,7 +156,11 @@ namespace OpenRCT2
             static void ResetWindowVisbilities();
             void DrawAllDirtyBlocks();
             uint32_t GetNumDirtyRows(const uint32_t x, const uint32_t y, const uint32_t columns);
-            void DrawDirtyBlocks(uint32_t x, uint32_t y, uint32_t columns, uint32_t rows);
+            void ClearDirtyBlocks(const DirtyRect& rect);
+            void MergeDirtyRects();
+            void CoarsenDirtyRects();
+            bool TryMergeDirtyRects(size_t a, size_t b);
+            void DrawDirtyBlocks(const DirtyRect& rect);
         };
 #ifdef __WARN_SUGGEST_FINAL_TYPES__
 #    pragma GCC diagnostic pop
@@ -28,6 +28,7 @@
 #include "../core/String.hpp"
 #include "../drawing/Drawing.h"
 #include "../drawing/Font.h"
+#include "../drawing/X8DrawingEngine.h"
 #include "../interface/Chat.h"
 #include "../interface/Colour.h"
 #include "../interface/Window_internal.h"
@@ -1278,6 +1279,40 @@ static int32_t cc_show_limits(InteractiveConsole& console, [[maybe_unused]] cons
     return 0;
 }
 
+static int32_t cc_dirty_stats(InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
+{
+    auto drawingEngine = dynamic_cast<OpenRCT2::Drawing::X8DrawingEngine*>(OpenRCT2::GetContext()->GetDrawingEngine());
+    if (drawingEngine == nullptr)
+    {
+        console.WriteLineError("The current drawing engine does not track dirty regions.");
+        return 1;
+    }
+
+    const auto& stats = drawingEngine->GetDirtyStats();
+    auto dpi = drawingEngine->GetDPI();
+    auto screenPixels = static_cast<uint64_t>(dpi->width) * dpi->height;
+    console.WriteFormatLine("Dirty blocks: %u", stats.Blocks);
+    console.WriteFormatLine("Regions drawn: %u%s", stats.Rects, stats.CoarseMerge ? " (merged on the coarse grid)" : "");
+    console.WriteFormatLine(
+        "Pixels repainted: %llu (%.1f%% of the screen)", static_cast<unsigned long long>(stats.PixelsRepainted),
+        screenPixels > 0 ? stats.PixelsRepainted * 100.0 / screenPixels : 0.0);
+    return 0;
+}
+
+static int32_t cc_sprite_cache(InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
+{
+    auto stats = gfx_sprite_mipmap_get_stats();
+    auto lookups = stats.Hits + stats.Misses;
+    console.WriteFormatLine(
+        "Zoomed out images cached: %zu (%.1f of %.1f MiB)", stats.Entries, stats.Bytes / (1024.0 * 1024.0),
+        stats.Capacity / (1024.0 * 1024.0));
+    console.WriteFormatLine(
+        "Hits: %llu, misses: %llu (%.1f%% hit rate), evictions: %llu", static_cast<unsigned long long>(stats.Hits),
+        static_cast<unsigned long long>(stats.Misses), lookups > 0 ? stats.Hits * 100.0 / lookups : 0.0,
+        static_cast<unsigned long long>(stats.Evictions));
+    return 0;
+}
+
 static int32_t cc_for_date([[maybe_unused]] InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
 {
     int32_t year = 0;
@@ -1497,14 +1532,21 @@ static int32_t cc_replay_start(InteractiveConsole& console, const arguments_t& a
 
     if (argv.size() < 1)
     {
-        console.WriteFormatLine("Parameters required <replay_name>");
+        console.WriteFormatLine("Parameters required <replay_name> [<seek_tick = 0>]");
         return 0;
     }
 
     std::string name = argv[0];
 
+    // Start from the last checkpoint before the given tick if specified.
+    uint32_t seekTick = 0;
+    if (argv.size() >= 2)
+    {
+        seekTick = atol(argv[1].c_str());
+    }
+
     auto* replayManager = OpenRCT2::GetContext()->GetReplayManager();
-    if (replayManager->StartPlayback(name))
+    if (replayManager->StartPlayback(name, seekTick))
     {
         OpenRCT2::ReplayRecordInfo info;
         replayManager->GetCurrentReplayInfo(info);
@@ -1783,6 +1825,7 @@ static constexpr const console_command console_command_table[] = {
     { "close", cc_close, "Closes the console.", "close" },
     { "date", cc_for_date, "Sets the date to a given date.", "Format <year>[ <month>[ <day>]]." },
     { "dereference", cc_dereference, "Dereferences a nullptr, for testing purposes only", "dereference" },
+    { "dirty_stats", cc_dirty_stats, "Shows how much of the screen was redrawn in the last frame.", "dirty_stats" },
     { "echo", cc_echo, "Echoes the text to the console.", "echo <text>" },
     { "exit", cc_close, "Closes the console.", "exit" },
     { "get", cc_get, "Gets the value of the specified variable.", "get <variable>" },
@@ -1804,13 +1847,14 @@ static constexpr const console_command console_command_table[] = {
     { "say", cc_say, "Say to other players.", "say <message>" },
     { "set", cc_set, "Sets the variable to the specified value.", "set <variable> <value>" },
     { "show_limits", cc_show_limits, "Shows the map data counts and limits.", "show_limits" },
+    { "sprite_cache", cc_sprite_cache, "Shows how well the cache of zoomed out images is working.", "sprite_cache" },
     { "staff", cc_staff, "Staff management.", "staff <subcommand>" },
     { "terminate", cc_terminate, "Calls std::terminate(), for testing purposes only.", "terminate" },
     { "variables", cc_variables, "Lists all the variables that can be used with get and sometimes set.", "variables" },
     { "windows", cc_windows, "Lists all the windows that can be opened.", "windows" },
     { "replay_startrecord", cc_replay_startrecord, "Starts recording a new replay.", "replay_startrecord <name> [max_ticks]"},
     { "replay_stoprecord", cc_replay_stoprecord, "Stops recording a new replay.", "replay_stoprecord"},
-    { "replay_start", cc_replay_start, "Starts a replay", "replay_start <name>"},
+    { "replay_start", cc_replay_start, "Starts a replay", "replay_start <name> [<seek_tick>]"},
     { "replay_stop", cc_replay_stop, "Stops the replay", "replay_stop"},
     { "replay_normalise", cc_replay_normalise, "Normalises the replay to remove all gaps", "replay_normalise <input file> <output file>"},
     { "mp_desync", cc_mp_desync, "Forces a multiplayer desync", "cc_mp_desync [desync_type, 0 = Random t-shirt color on random guest, 1 = Remove random guest ]"},
@@ -32,9 +32,12 @@
 #include <cctype>
 #include <chrono>
 #include <cstdlib>
+#include <future>
+#include <iterator>
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 using namespace std::literals::string_literals;
 using namespace OpenRCT2;
@@ -44,18 +47,11 @@ uint8_t gScreenshotCountdown = 0;
 
 static bool WriteDpiToFile(std::string_view path, const rct_drawpixelinfo* dpi, const GamePalette& palette)
 {
-    auto const pixels8 = dpi->bits;
-    auto const pixelsLen = (dpi->width + dpi->pitch) * dpi->height;
     try
     {
-        Image image;
-        image.Width = dpi->width;
-        image.Height = dpi->height;
-        image.Depth = 8;
-        image.Stride = dpi->width + dpi->pitch;
-        image.Palette = std::make_unique<GamePalette>(palette);
-        image.Pixels = std::vector<uint8_t>(pixels8, pixels8 + pixelsLen);
-        Imaging::WriteToFile(path, image, IMAGE_FORMAT::PNG);
+        Imaging::PngStreamWriter writer(path, dpi->width, dpi->height, 8, &palette);
+        writer.WriteRows(dpi->bits, dpi->height, dpi->width + dpi->pitch);
+        writer.Finish();
         return true;
     }
     catch (const std::exception& e)
@@ -378,9 +374,69 @@ static void RenderViewport(IDrawingEngine* drawingEngine, const rct_viewport& vi
     viewport_render(&dpi, &viewport, 0, 0, viewport.width, viewport.height);
 }
 
+/**
+ * Renders the viewport a band of rows at a time, writing each band to the PNG while the next one is rendered. Only two
+ * bands are held in memory, however large the image is.
+ */
+static bool WriteViewportToFile(std::string_view path, const rct_viewport& viewport, const GamePalette& palette)
+{
+    // Bands of roughly 8 MiB, one is rendered while the other is written
+    constexpr size_t BandSize = 8 * 1024 * 1024;
+    const int32_t width = std::max<int32_t>(viewport.width, 1);
+    const int32_t height = std::max<int32_t>(viewport.height, 1);
+    const int32_t bandHeight = std::clamp(static_cast<int32_t>(BandSize / width), 1, height);
+    std::vector<uint8_t> bands[2];
+
+    try
+    {
+        Imaging::PngStreamWriter writer(path, width, height, 8, &palette);
+        X8DrawingEngine drawingEngine(GetContext()->GetUiContext());
+
+        // Ensure sprites appear regardless of rotation
+        reset_all_sprite_quadrant_placements();
+
+        std::future<void> pendingWrite;
+        size_t bandIndex = 0;
+        for (int32_t top = 0; top < height; top += bandHeight, bandIndex++)
+        {
+            const int32_t numRows = std::min(bandHeight, height - top);
+            auto& band = bands[bandIndex % 2];
+            band.resize(static_cast<size_t>(width) * bandHeight);
+            if (viewport.flags & VIEWPORT_FLAG_TRANSPARENT_BACKGROUND)
+            {
+                std::fill(band.begin(), band.end(), PALETTE_INDEX_0);
+            }
+
+            rct_drawpixelinfo dpi;
+            dpi.bits = band.data();
+            dpi.y = top;
+            dpi.width = width;
+            dpi.height = numRows;
+            dpi.DrawingEngine = &drawingEngine;
+            viewport_render(&dpi, &viewport, 0, top, width, top + numRows);
+
+            // The other band is free again once the previous write has finished
+            if (pendingWrite.valid())
+            {
+                pendingWrite.get();
+            }
+            pendingWrite = std::async(std::launch::async, [&writer, &band, numRows, width]() {
+                writer.WriteRows(band.data(), numRows, width);
+            });
+        }
+        pendingWrite.get();
+        writer.Finish();
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        log_error("Unable to write png: %s", e.what());
+        return false;
+    }
+}
+
 void screenshot_giant()
 {
-    rct_drawpixelinfo dpi{};
     try
     {
         auto path = screenshot_get_next_path();
@@ -409,10 +465,10 @@ void screenshot_giant()
             viewport.flags |= VIEWPORT_FLAG_TRANSPARENT_BACKGROUND;
         }
 
-        dpi = CreateDPI(viewport);
-
-        RenderViewport(nullptr, viewport, dpi);
-        WriteDpiToFile(path->c_str(), &dpi, gPalette);
+        if (!WriteViewportToFile(*path, viewport, gPalette))
+        {
+            throw std::runtime_error("Giant screenshot failed, unable to write the image.");
+        }
 
         // Show user that screenshot saved successfully
         Formatter ft;
@@ -425,8 +481,6 @@ void screenshot_giant()
         log_error("%s", e.what());
         context_show_error(STR_SCREENSHOT_FAILED, STR_NONE, {});
     }
-
-    ReleaseDPI(dpi);
 }
 
 // TODO: Move this at some point into a more appropriate place.
@@ -438,6 +492,148 @@ template<typename FN> static inline double MeasureFunctionTime(const FN& fn)
     return std::chrono::duration<double>(endTime - startTime).count();
 }
 
+/**
+ * Times converting a 4K frame of the rendered park from palette indices to 32-bit pixels, the way the
+ * software engine presents it, with every implementation the CPU supports.
+ */
+static void benchgfx_palette_lookup(const rct_drawpixelinfo& dpi, uint32_t iterationCount)
+{
+    constexpr int32_t FrameWidth = 3840;
+    constexpr int32_t FrameHeight = 2160;
+    const int32_t dpiStride = dpi.width + dpi.pitch;
+    std::vector<uint8_t> frame(FrameWidth * FrameHeight);
+    for (int32_t y = 0; y < FrameHeight; y++)
+    {
+        for (int32_t x = 0; x < FrameWidth; x++)
+        {
+            frame[y * FrameWidth + x] = dpi.bits[(y % dpi.height) * dpiStride + (x % dpi.width)];
+        }
+    }
+
+    uint32_t palette[256];
+    for (int32_t i = 0; i < 256; i++)
+    {
+        palette[i] = (gGamePalette[i * 4 + 2] << 16) | (gGamePalette[i * 4 + 1] << 8) | gGamePalette[i * 4 + 0];
+    }
+
+    std::vector<uint32_t> reference(frame.size());
+    palette_lookup_scalar(FrameWidth, FrameHeight, frame.data(), reference.data(), palette, 0, 0);
+
+    struct PaletteLookupFunction
+    {
+        const char* Name;
+        decltype(palette_lookup_fn) Function;
+        bool Available;
+    };
+    const PaletteLookupFunction functions[] = {
+        { "scalar", palette_lookup_scalar, true },
+        { "SSE4.1", palette_lookup_sse4_1, sse41_available() },
+        { "AVX2", palette_lookup_avx2, avx2_available() },
+    };
+
+    std::vector<uint32_t> pixels(frame.size());
+    for (const auto& function : functions)
+    {
+        if (!function.Available)
+        {
+            continue;
+        }
+
+        double totalTime = 0.0;
+        for (uint32_t i = 0; i < iterationCount; i++)
+        {
+            totalTime += MeasureFunctionTime([&]() {
+                function.Function(FrameWidth, FrameHeight, frame.data(), pixels.data(), palette, 0, 0);
+            });
+        }
+
+        const double average = totalTime / static_cast<double>(iterationCount);
+        std::printf(
+            "Palette lookup %dx%d (%s) average: %.06fs, %.f Mpixels/s%s\n", FrameWidth, FrameHeight, function.Name, average,
+            FrameWidth * FrameHeight / average / 1000000.0, pixels == reference ? "" : " MISMATCH");
+    }
+}
+
+/**
+ * Times the sprite row kernels over rows as long as a typical sprite run, with every implementation the CPU
+ * supports.
+ */
+static void benchgfx_sprite_rows(uint32_t iterationCount)
+{
+    constexpr int32_t RowLength = 64;
+    constexpr int32_t NumPixels = 1024 * 1024;
+
+    // Fixed pseudo random data with plenty of transparent pixels
+    std::vector<uint8_t> src(NumPixels);
+    std::vector<uint8_t> background(NumPixels);
+    uint8_t table[256];
+    uint32_t seed = 0x12345678;
+    auto nextRandom = [&seed]() {
+        seed = seed * 1664525 + 1013904223;
+        return static_cast<uint8_t>(seed >> 24);
+    };
+    for (int32_t i = 0; i < NumPixels; i++)
+    {
+        src[i] = (i % RowLength) < RowLength / 4 ? 0 : nextRandom();
+        background[i] = nextRandom();
+    }
+    for (auto& entry : table)
+    {
+        entry = nextRandom() < 16 ? 0 : nextRandom();
+    }
+
+    using BlitRowFunction = void (*)(const uint8_t*, uint8_t*, const uint8_t*, int32_t);
+    struct BlitRowKernel
+    {
+        const char* Name;
+        BlitRowFunction Functions[3];
+    };
+    const BlitRowKernel kernels[] = {
+        { "transparent",
+          { [](const uint8_t* s, uint8_t* d, const uint8_t*, int32_t n) { blit_row_transparent_scalar(s, d, n); },
+            [](const uint8_t* s, uint8_t* d, const uint8_t*, int32_t n) { blit_row_transparent_sse4_1(s, d, n); },
+            [](const uint8_t* s, uint8_t* d, const uint8_t*, int32_t n) { blit_row_transparent_avx2(s, d, n); } } },
+        { "remap", { blit_row_remap_scalar, blit_row_remap_sse4_1, blit_row_remap_avx2 } },
+        { "glass", { blit_row_glass_scalar, blit_row_glass_sse4_1, blit_row_glass_avx2 } },
+    };
+    const char* implementationNames[] = { "scalar", "SSE4.1", "AVX2" };
+    const bool implementationAvailable[] = { true, sse41_available(), avx2_available() };
+
+    std::vector<uint8_t> reference;
+    std::vector<uint8_t> dst;
+    for (const auto& kernel : kernels)
+    {
+        for (size_t i = 0; i < std::size(implementationNames); i++)
+        {
+            if (!implementationAvailable[i])
+            {
+                continue;
+            }
+
+            double totalTime = 0.0;
+            for (uint32_t j = 0; j < iterationCount; j++)
+            {
+                dst = background;
+                totalTime += MeasureFunctionTime([&]() {
+                    for (int32_t x = 0; x < NumPixels; x += RowLength)
+                    {
+                        kernel.Functions[i](src.data() + x, dst.data() + x, table, RowLength);
+                    }
+                });
+            }
+            if (i == 0)
+            {
+                reference = dst;
+            }
+
+            const double average = totalTime / static_cast<double>(iterationCount);
+            std::printf(
+                "Sprite rows %s (%s) average: %.06fs, %.f Mpixels/s%s\n", kernel.Name, implementationNames[i], average,
+                NumPixels / average / 1000000.0, dst == reference ? "" : " MISMATCH");
+        }
+    }
+}
+
 static void benchgfx_render_screenshots(const char* inputPath, std::unique_ptr<IContext>& context, uint32_t iterationCount)
 {
     if (!context->LoadParkFromFile(inputPath))
@@ -507,6 +703,15 @@ static void benchgfx_render_screenshots(const char* inputPath, std::unique_ptr<I
         }
         std::printf("Total average: %.06fs, %.f FPS\n", average, 1.0 / average);
         std::printf("Time: %.05fs\n", totalTime);
+
+        auto mipmapStats = gfx_sprite_mipmap_get_stats();
+        std::printf(
+            "Zoomed out image cache: %zu images, %.1f MiB, %llu hits, %llu misses\n", mipmapStats.Entries,
+            mipmapStats.Bytes / (1024.0 * 1024.0), static_cast<unsigned long long>(mipmapStats.Hits),
+            static_cast<unsigned long long>(mipmapStats.Misses));
+
+        benchgfx_palette_lookup(dpis[0], iterationCount);
+        benchgfx_sprite_rows(iterationCount);
     }
     catch (const std::exception& e)
     {
@@ -619,7 +824,6 @@ int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOption
     }
 
     int32_t exitCode = 1;
-    rct_drawpixelinfo dpi;
     try
     {
         core_init();
@@ -721,17 +925,20 @@ int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOption
 
         ApplyOptions(options, viewport);
 
-        dpi = CreateDPI(viewport);
+        // Nothing else is drawn or updated while the screenshot is taken, so the columns can always be painted on the
+        // worker threads.
+        gConfigGeneral.multithreading = true;
 
-        RenderViewport(nullptr, viewport, dpi);
-        WriteDpiToFile(outputPath, &dpi, gPalette);
+        if (!WriteViewportToFile(outputPath, viewport, gPalette))
+        {
+            throw std::runtime_error("Failed to write the image.");
+        }
     }
     catch (const std::exception& e)
     {
         std::printf("%s\n", e.what());
         exitCode = -1;
     }
-    ReleaseDPI(dpi);
 
     drawing_engine_dispose();
 
@@ -820,10 +1027,7 @@ void CaptureImage(const CaptureOptions& options)
     }
 
     auto outputPath = ResolveFilenameForCapture(options.Filename);
-    auto dpi = CreateDPI(viewport);
-    RenderViewport(nullptr, viewport, dpi);
-    WriteDpiToFile(outputPath, &dpi, gPalette);
-    ReleaseDPI(dpi);
+    WriteViewportToFile(outputPath, viewport, gPalette);
 
     gCurrentRotation = backupRotation;
 }
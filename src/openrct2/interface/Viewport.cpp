@@ -49,6 +49,7 @@ rct_viewport* g_music_tracking_viewport;
 
 static std::unique_ptr<JobPool> _paintJobs;
 static std::vector<paint_session*> _paintColumns;
+static std::vector<PaintBand> _paintBands;
 
 ScreenCoordsXY gSavedView;
 ZoomLevel gSavedViewZoom;
@@ -908,9 +909,10 @@ static void record_session(
 }
 
 static void viewport_fill_column(
-    paint_session* session, std::vector<RecordedPaintSession>* recorded_sessions, size_t record_index)
+    const PaintBand* band, size_t columnIndex, std::vector<RecordedPaintSession>* recorded_sessions, size_t record_index)
 {
-    PaintSessionGenerate(session);
+    auto* session = band->Columns[columnIndex];
+    PaintBandGenerateColumn(band, columnIndex);
     if (recorded_sessions != nullptr)
     {
         record_session(session, recorded_sessions, record_index);
@@ -941,12 +943,31 @@ static void viewport_paint_column(paint_session* session)
         viewport_paint_weather_gloom(&session->DPI);
     }
 
-    if (session->PSStringHead != nullptr)
+    PaintSessionFree(session);
+}
+
+/**
+ * Clips dpi to the columns from x to x + width.
+ */
+static void viewport_clip_to_columns(rct_drawpixelinfo& dpi, int16_t x, int16_t width)
+{
+    if (x >= dpi.x)
     {
-        PaintDrawMoneyStructs(&session->DPI, session->PSStringHead);
+        int16_t leftPitch = x - dpi.x;
+        dpi.width -= leftPitch;
+        dpi.bits += leftPitch / dpi.zoom_level;
+        dpi.pitch += leftPitch / dpi.zoom_level;
+        dpi.x = x;
     }
 
-    PaintSessionFree(session);
+    int16_t paintRight = dpi.x + dpi.width;
+    if (paintRight >= x + width)
+    {
+        int16_t rightPitch = paintRight - x - width;
+        paintRight -= rightPitch;
+        dpi.pitch += rightPitch / dpi.zoom_level;
+    }
+    dpi.width = paintRight - dpi.x;
 }
 
 /**
@@ -1012,8 +1033,7 @@ void viewport_paint(
         _paintJobs.reset();
     }
 
-    // Create space to record sessions and keep track which index is being drawn
-    size_t index = 0;
+    // Create space to record sessions
     if (recorded_sessions != nullptr)
     {
         const uint16_t columnSize = rightBorder - alignedX;
@@ -1021,50 +1041,74 @@ void viewport_paint(
         recorded_sessions->resize(columnCount);
     }
 
-    // Splits the area into 32 pixel columns and renders them
-    for (x = alignedX; x < rightBorder; x += 32, index++)
+    // Splits the area into 32 pixel columns
+    for (x = alignedX; x < rightBorder; x += 32)
     {
         paint_session* session = PaintSessionAlloc(&dpi1, viewFlags);
         _paintColumns.push_back(session);
+        viewport_clip_to_columns(session->DPI, x, 32);
+    }
 
-        rct_drawpixelinfo& dpi2 = session->DPI;
-        if (x >= dpi2.x)
-        {
-            int16_t leftPitch = x - dpi2.x;
-            dpi2.width -= leftPitch;
-            dpi2.bits += leftPitch / dpi2.zoom_level;
-            dpi2.pitch += leftPitch / dpi2.zoom_level;
-            dpi2.x = x;
-        }
+    // Neighbouring columns share most of their tiles, so the tiles are set up once for each band of columns. With
+    // multithreading there are a couple of bands per thread so that the threads stay busy.
+    const size_t numColumns = _paintColumns.size();
+    if (numColumns == 0)
+        return;
 
-        int16_t paintRight = dpi2.x + dpi2.width;
-        if (paintRight >= x + 32)
-        {
-            int16_t rightPitch = paintRight - x - 32;
-            paintRight -= rightPitch;
-            dpi2.pitch += rightPitch / dpi2.zoom_level;
-        }
-        dpi2.width = paintRight - dpi2.x;
+    size_t numBands = useMultithreading ? std::min(numColumns, JobPool::GetThreadCount() * 2) : 1;
+    const size_t columnsPerBand = (numColumns + numBands - 1) / numBands;
+    numBands = (numColumns + columnsPerBand - 1) / columnsPerBand;
+    _paintBands.resize(numBands);
+    for (size_t bandIndex = 0; bandIndex < numBands; bandIndex++)
+    {
+        auto& band = _paintBands[bandIndex];
+        auto firstColumn = _paintColumns.begin() + bandIndex * columnsPerBand;
+        auto lastColumn = _paintColumns.begin() + std::min((bandIndex + 1) * columnsPerBand, numColumns);
+        band.Columns.assign(firstColumn, lastColumn);
 
-        if (useMultithreading)
+        int16_t bandX = alignedX + static_cast<int16_t>(bandIndex * columnsPerBand * 32);
+        band.Session = PaintSessionAlloc(&dpi1, viewFlags);
+        viewport_clip_to_columns(band.Session->DPI, bandX, static_cast<int16_t>(band.Columns.size() * 32));
+    }
+
+    auto generateBand = [](size_t bandIndex) { PaintBandGenerate(&_paintBands[bandIndex]); };
+    auto fillColumn = [recorded_sessions, columnsPerBand](size_t columnIndex) {
+        viewport_fill_column(
+            &_paintBands[columnIndex / columnsPerBand], columnIndex % columnsPerBand, recorded_sessions, columnIndex);
+    };
+    if (useMultithreading)
+    {
+        _paintJobs->ParallelFor(0, numBands, generateBand);
+        _paintJobs->ParallelFor(0, numColumns, fillColumn);
+    }
+    else
+    {
+        for (size_t bandIndex = 0; bandIndex < numBands; bandIndex++)
         {
-            _paintJobs->AddTask(
-                [session, recorded_sessions, index]() -> void { viewport_fill_column(session, recorded_sessions, index); });
+            generateBand(bandIndex);
         }
-        else
+        for (size_t columnIndex = 0; columnIndex < numColumns; columnIndex++)
         {
-            viewport_fill_column(session, recorded_sessions, index);
+            fillColumn(columnIndex);
         }
     }
 
-    if (useMultithreading)
+    // Setting up a tile can set up scrolling text, which writes to the shared scrolling text images, so nothing is
+    // drawn until every band has been generated.
+    for (auto& band : _paintBands)
     {
-        _paintJobs->Join();
-    }
+        for (auto column : band.Columns)
+        {
+            viewport_paint_column(column);
+        }
 
-    for (auto column : _paintColumns)
-    {
-        viewport_paint_column(column);
+        // Drawn over the whole band so that text is not cut off where a column ends
+        if (band.Session->PSStringHead != nullptr)
+        {
+            PaintDrawMoneyStructs(&band.Session->DPI, band.Session->PSStringHead);
+        }
+        PaintSessionFree(band.Session);
+        band.Session = nullptr;
     }
 }
 
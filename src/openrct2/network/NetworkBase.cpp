@@ -28,6 +28,7 @@
 #include "../world/EntityTweener.h"
 #include "../world/Location.hpp"
 #include "../world/Sprite.h"
+#include "../world/StateHash.h"
 #include "network.h"
 
 #include <algorithm>
@@ -37,7 +38,7 @@
 // This string specifies which version of network stream current build uses.
 // It is used for making sure only compatible builds get connected, even within
 // single OpenRCT2 version.
-#define NETWORK_STREAM_VERSION "20"
+#define NETWORK_STREAM_VERSION "21"
 #define NETWORK_STREAM_ID OPENRCT2_VERSION "-" NETWORK_STREAM_VERSION
 
 static Peep* _pickup_peep = nullptr;
@@ -129,6 +130,7 @@ NetworkBase::NetworkBase()
     client_command_handlers[NetworkCommand::ObjectsList] = &NetworkBase::Client_Handle_OBJECTS_LIST;
     client_command_handlers[NetworkCommand::Scripts] = &NetworkBase::Client_Handle_SCRIPTS;
     client_command_handlers[NetworkCommand::GameState] = &NetworkBase::Client_Handle_GAMESTATE;
+    client_command_handlers[NetworkCommand::StateHash] = &NetworkBase::Client_Handle_STATE_HASH;
 
     server_command_handlers[NetworkCommand::Auth] = &NetworkBase::Server_Handle_AUTH;
     server_command_handlers[NetworkCommand::Chat] = &NetworkBase::Server_Handle_CHAT;
@@ -138,6 +140,7 @@ NetworkBase::NetworkBase()
     server_command_handlers[NetworkCommand::Token] = &NetworkBase::Server_Handle_TOKEN;
     server_command_handlers[NetworkCommand::MapRequest] = &NetworkBase::Server_Handle_MAPREQUEST;
     server_command_handlers[NetworkCommand::RequestGameState] = &NetworkBase::Server_Handle_REQUEST_GAMESTATE;
+    server_command_handlers[NetworkCommand::RequestStateHash] = &NetworkBase::Server_Handle_REQUEST_STATE_HASH;
     server_command_handlers[NetworkCommand::Heartbeat] = &NetworkBase::Server_Handle_HEARTBEAT;
 
     _chat_log_fs << std::unitbuf;
@@ -231,6 +234,7 @@ void NetworkBase::CloseConnection()
     }
     else if (mode == NETWORK_MODE_SERVER)
     {
+        StopIoThread();
         _listenSocket.reset();
         _advertiser.reset();
     }
@@ -403,6 +407,11 @@ bool NetworkBase::BeginServer(uint16_t port, const std::string& address)
     _serverState.gamestateSnapshotsEnabled = gConfigNetwork.desync_debugging;
     _advertiser = CreateServerAdvertiser(listening_port);
 
+    if (gOpenRCT2Headless)
+    {
+        StartIoThread();
+    }
+
     game_load_scripts();
 
     return true;
@@ -497,6 +506,81 @@ void NetworkBase::Flush()
         {
             it->SendQueuedPackets();
         }
+        if (_ioThread.joinable())
+        {
+            _ioCondition.notify_one();
+        }
+    }
+}
+
+void NetworkBase::StartIoThread()
+{
+    _ioThreadStop = false;
+    _ioThread = std::thread([this]() { UpdateIoThread(); });
+}
+
+void NetworkBase::StopIoThread()
+{
+    if (!_ioThread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(_ioMutex);
+        _ioThreadStop = true;
+    }
+    _ioCondition.notify_one();
+    _ioThread.join();
+
+    for (auto* connection : _ioConnections)
+    {
+        connection->SetUsesIoThread(false);
+    }
+    _ioConnections.clear();
+}
+
+void NetworkBase::UpdateIoThread()
+{
+    std::vector<NetworkConnection*> connections;
+    std::unique_lock<std::mutex> lock(_ioMutex);
+    while (!_ioThreadStop)
+    {
+        // Go through a copy of the list so that the sockets are read and written without holding the lock
+        connections = _ioConnections;
+        _ioPassActive = true;
+        lock.unlock();
+
+        bool transferred = false;
+        for (auto* connection : connections)
+        {
+            transferred |= connection->UpdateIo();
+        }
+
+        lock.lock();
+        _ioPassActive = false;
+        _ioPassFinished.notify_all();
+
+        // Keep going while there is traffic, otherwise wait a little or until the game flushes new packets
+        if (!transferred)
+        {
+            _ioCondition.wait_for(lock, std::chrono::milliseconds(1));
+        }
+    }
+}
+
+void NetworkBase::RemoveIoConnection(NetworkConnection& connection)
+{
+    if (!_ioThread.joinable())
+        return;
+
+    std::unique_lock<std::mutex> lock(_ioMutex);
+    auto it = std::find(_ioConnections.begin(), _ioConnections.end(), &connection);
+    if (it != _ioConnections.end())
+    {
+        _ioConnections.erase(it);
+
+        // The I/O thread may still be using the connection from its copy of the list
+        _ioPassFinished.wait(lock, [this]() { return !_ioPassActive; });
+        connection.SetUsesIoThread(false);
     }
 }
 
@@ -508,6 +592,13 @@ void NetworkBase::UpdateServer()
         if (!connection->IsValid())
             continue;
 
+        if (connection->PendingMap.valid()
+            && connection->PendingMap.wait_for(std::chrono::seconds::zero()) == std::future_status::ready)
+        {
+            Server_Send_MAP_Data(connection.get(), connection->PendingMap.get());
+            connection->ReleaseHeldPackets();
+        }
+
         if (!ProcessConnection(*connection))
         {
             connection->Disconnect();
@@ -715,6 +806,10 @@ const char* NetworkBase::FormatChat(NetworkPlayer* fromplayer, const char* text)
 
 void NetworkBase::SendPacketToClients(const NetworkPacket& packet, bool front, bool gameCmd)
 {
+    // All clients share the same copy of the packet
+    auto sharedPacket = std::make_shared<NetworkPacket>(packet);
+    sharedPacket->Header.Size = static_cast<uint16_t>(sharedPacket->Data.size());
+
     for (auto& client_connection : client_connection_list)
     {
         if (gameCmd)
@@ -728,8 +823,7 @@ void NetworkBase::SendPacketToClients(const NetworkPacket& packet, bool front, b
                 continue;
             }
         }
-        auto packetCopy = packet;
-        client_connection->QueuePacket(std::move(packetCopy), front);
+        client_connection->QueuePacket(sharedPacket, front);
     }
 }
 
@@ -763,6 +857,18 @@ bool NetworkBase::CheckSRAND(uint32_t tick, uint32_t srand0)
         }
     }
 
+    if (storedTick.hasStateHash)
+    {
+        const auto* stateHash = state_hash_get(storedTick.stateHashTick);
+        if (stateHash != nullptr && stateHash->Root != storedTick.stateHash)
+        {
+            log_info(
+                "State hash mismatch at tick %u, client = %016llX, server = %016llX", storedTick.stateHashTick,
+                static_cast<unsigned long long>(stateHash->Root), static_cast<unsigned long long>(storedTick.stateHash));
+            return false;
+        }
+    }
+
     return true;
 }
 
@@ -805,6 +911,14 @@ void NetworkBase::RequestStateSnapshot()
     Client_Send_RequestGameState(_serverState.desyncTick);
 }
 
+void NetworkBase::RequestStateHash()
+{
+    // The state hash checked at a tick is the one taken part way through the tick before
+    log_info("Requesting state hash for tick %u", _serverState.desyncTick - 1);
+
+    Client_Send_RequestStateHash(_serverState.desyncTick - 1);
+}
+
 NetworkServerState_t NetworkBase::GetServerState() const
 {
     return _serverState;
@@ -1196,6 +1310,15 @@ void NetworkBase::Client_Send_RequestGameState(uint32_t tick)
     _serverConnection->QueuePacket(std::move(packet));
 }
 
+void NetworkBase::Client_Send_RequestStateHash(uint32_t tick)
+{
+    log_verbose("Requesting state hash from server for tick %u", tick);
+
+    NetworkPacket packet(NetworkCommand::RequestStateHash);
+    packet << tick;
+    _serverConnection->QueuePacket(std::move(packet));
+}
+
 void NetworkBase::Client_Send_TOKEN()
 {
     log_verbose("requesting token");
@@ -1371,8 +1494,8 @@ void NetworkBase::Server_Send_MAP(NetworkConnection* connection)
         objects = objManager.GetPackableObjects();
     }
 
-    auto header = save_for_network(objects);
-    if (header.empty())
+    auto map = save_map_for_network(objects);
+    if (map.empty())
     {
         if (connection)
         {
@@ -1381,6 +1504,29 @@ void NetworkBase::Server_Send_MAP(NetworkConnection* connection)
         }
         return;
     }
+
+    if (connection)
+    {
+        // The map has to be saved on this thread to get the state of the current tick, but compressing it can
+        // take a while for large parks, so do that in the background rather than holding up everyone else.
+        // Unlike a future from std::async, this one does not wait for the thread when the connection goes away.
+        std::promise<std::vector<uint8_t>> compressed;
+        connection->PendingMap = compressed.get_future();
+        auto thread = std::thread(
+            [map = std::move(map)](std::promise<std::vector<uint8_t>> compressed2) -> void {
+                compressed2.set_value(compress_map_for_network(map));
+            },
+            std::move(compressed));
+        thread.detach();
+    }
+    else
+    {
+        Server_Send_MAP_Data(nullptr, compress_map_for_network(map));
+    }
+}
+
+void NetworkBase::Server_Send_MAP_Data(NetworkConnection* connection, const std::vector<uint8_t>& header)
+{
     size_t chunksize = CHUNK_SIZE;
     for (size_t i = 0; i < header.size(); i += chunksize)
     {
@@ -1399,9 +1545,9 @@ void NetworkBase::Server_Send_MAP(NetworkConnection* connection)
     }
 }
 
-std::vector<uint8_t> NetworkBase::save_for_network(const std::vector<const ObjectRepositoryItem*>& objects) const
+std::vector<uint8_t> NetworkBase::save_map_for_network(const std::vector<const ObjectRepositoryItem*>& objects) const
 {
-    std::vector<uint8_t> header;
+    std::vector<uint8_t> map;
     bool RLEState = gUseRLE;
     gUseRLE = false;
 
@@ -1409,12 +1555,20 @@ std::vector<uint8_t> NetworkBase::save_for_network(const std::vector<const Objec
     if (!SaveMap(&ms, objects))
     {
         log_warning("Failed to export map.");
-        return header;
+        return map;
     }
     gUseRLE = RLEState;
 
-    const void* data = ms.GetData();
-    int32_t size = ms.GetLength();
+    const auto* data = static_cast<const uint8_t*>(ms.GetData());
+    map.assign(data, data + ms.GetLength());
+    return map;
+}
+
+std::vector<uint8_t> NetworkBase::compress_map_for_network(const std::vector<uint8_t>& map)
+{
+    std::vector<uint8_t> header;
+    const void* data = map.data();
+    int32_t size = static_cast<int32_t>(map.size());
 
     auto compressed = util_zlib_deflate(static_cast<const uint8_t*>(data), size);
     if (compressed != std::nullopt)
@@ -1512,6 +1666,13 @@ void NetworkBase::Server_Send_TICK()
         checksum_counter = 0;
         flags |= NETWORK_TICK_FLAG_CHECKSUMS;
     }
+    // The state hash is cheap enough to send every tick. It is taken part way through each tick, so the latest one
+    // is from the previous tick.
+    const auto* stateHash = state_hash_get(gCurrentTicks - 1);
+    if (stateHash != nullptr)
+    {
+        flags |= NETWORK_TICK_FLAG_STATE_HASH;
+    }
     // Send flags always, so we can understand packet structure on the other end,
     // and allow for some expansion.
     packet << flags;
@@ -1520,6 +1681,10 @@ void NetworkBase::Server_Send_TICK()
         rct_sprite_checksum checksum = sprite_checksum();
         packet.WriteString(checksum.ToString().c_str());
     }
+    if (flags & NETWORK_TICK_FLAG_STATE_HASH)
+    {
+        packet << stateHash->Tick << stateHash->Root;
+    }
 
     SendPacketToClients(packet);
 }
@@ -1921,6 +2086,7 @@ void NetworkBase::ProcessDisconnectedClients()
         }
 
         // Make sure to send all remaining packets out before disconnecting.
+        RemoveIoConnection(*connection);
         connection->SendQueuedPackets();
         connection->Socket->Disconnect();
 
@@ -1941,6 +2107,12 @@ void NetworkBase::AddClient(std::unique_ptr<ITcpSocket>&& socket)
     // Store connection
     auto connection = std::make_unique<NetworkConnection>();
     connection->Socket = std::move(socket);
+    if (_ioThread.joinable())
+    {
+        std::lock_guard<std::mutex> lock(_ioMutex);
+        connection->SetUsesIoThread(true);
+        _ioConnections.push_back(connection.get());
+    }
 
     client_connection_list.push_back(std::move(connection));
 }
@@ -2200,6 +2372,33 @@ void NetworkBase::Server_Handle_REQUEST_GAMESTATE(NetworkConnection& connection,
     }
 }
 
+void NetworkBase::Server_Handle_REQUEST_STATE_HASH(NetworkConnection& connection, NetworkPacket& packet)
+{
+    uint32_t tick;
+    packet >> tick;
+
+    const auto* stateHash = state_hash_get(tick);
+    if (stateHash == nullptr)
+    {
+        log_verbose("State hash for tick %u is no longer available", tick);
+        return;
+    }
+
+    NetworkPacket packetStateHash(NetworkCommand::StateHash);
+    packetStateHash << tick << stateHash->Root;
+    packetStateHash << static_cast<uint32_t>(stateHash->EntityBlocks.size());
+    for (auto blockHash : stateHash->EntityBlocks)
+    {
+        packetStateHash << blockHash;
+    }
+    packetStateHash << static_cast<uint32_t>(stateHash->MapRegions.size());
+    for (auto regionHash : stateHash->MapRegions)
+    {
+        packetStateHash << regionHash;
+    }
+    connection.QueuePacket(std::move(packetStateHash));
+}
+
 void NetworkBase::Server_Handle_HEARTBEAT(NetworkConnection& connection, NetworkPacket& packet)
 {
     log_verbose("Client %s heartbeat", connection.Socket->GetHostName());
@@ -2450,6 +2649,74 @@ void NetworkBase::Client_Handle_GAMESTATE(NetworkConnection& connection, Network
     }
 }
 
+void NetworkBase::Client_Handle_STATE_HASH([[maybe_unused]] NetworkConnection& connection, NetworkPacket& packet)
+{
+    uint32_t tick;
+    uint64_t root;
+    packet >> tick >> root;
+
+    StateHashNodes serverStateHash;
+    uint32_t count;
+    packet >> count;
+    serverStateHash.EntityBlocks.resize(count);
+    for (auto& blockHash : serverStateHash.EntityBlocks)
+    {
+        packet >> blockHash;
+    }
+    packet >> count;
+    serverStateHash.MapRegions.resize(count);
+    for (auto& regionHash : serverStateHash.MapRegions)
+    {
+        packet >> regionHash;
+    }
+
+    const auto* stateHash = state_hash_get(tick);
+    if (stateHash == nullptr)
+    {
+        log_warning("State hash for tick %u is no longer available", tick);
+        return;
+    }
+    if (stateHash->EntityBlocks.size() != serverStateHash.EntityBlocks.size()
+        || stateHash->MapRegions.size() != serverStateHash.MapRegions.size())
+    {
+        log_warning("State hash for tick %u does not have the same layout as the server's", tick);
+        return;
+    }
+
+    bool foundDifference = false;
+    for (size_t i = 0; i < stateHash->EntityBlocks.size(); i++)
+    {
+        if (stateHash->EntityBlocks[i] != serverStateHash.EntityBlocks[i])
+        {
+            const auto first = i * STATE_HASH_ENTITY_BLOCK_SIZE;
+            log_warning(
+                "Desync at tick %u: entities %zu to %zu differ from the server", tick, first,
+                std::min<size_t>(first + STATE_HASH_ENTITY_BLOCK_SIZE, MAX_ENTITIES) - 1);
+            foundDifference = true;
+        }
+    }
+
+    const int32_t regionsPerSide = (gMapSize + STATE_HASH_REGION_SIZE - 1) / STATE_HASH_REGION_SIZE;
+    for (size_t i = 0; i < stateHash->MapRegions.size(); i++)
+    {
+        if (stateHash->MapRegions[i] != serverStateHash.MapRegions[i])
+        {
+            const auto x = static_cast<int32_t>(i % regionsPerSide) * STATE_HASH_REGION_SIZE;
+            const auto y = static_cast<int32_t>(i / regionsPerSide) * STATE_HASH_REGION_SIZE;
+            log_warning(
+                "Desync at tick %u: tiles %d,%d to %d,%d differ from the server", tick, x, y,
+                std::min<int32_t>(x + STATE_HASH_REGION_SIZE, gMapSize) - 1,
+                std::min<int32_t>(y + STATE_HASH_REGION_SIZE, gMapSize) - 1);
+            foundDifference = true;
+        }
+    }
+
+    if (!foundDifference)
+    {
+        log_warning("Desync at tick %u: the entities and tile elements match the server", tick);
+    }
+}
+
 void NetworkBase::Server_Handle_MAPREQUEST(NetworkConnection& connection, NetworkPacket& packet)
 {
     uint32_t size;
@@ -3018,6 +3285,11 @@ void NetworkBase::Client_Handle_TICK([[maybe_unused]] NetworkConnection& connect
             tickData.spriteHash = text;
         }
     }
+    if (flags & NETWORK_TICK_FLAG_STATE_HASH)
+    {
+        packet >> tickData.stateHashTick >> tickData.stateHash;
+        tickData.hasStateHash = true;
+    }
 
     // Don't let the history grow too much.
     while (_serverTickData.size() >= 100)
@@ -3267,6 +3539,11 @@ void network_request_gamestate_snapshot()
     return gNetwork.RequestStateSnapshot();
 }
 
+void network_request_state_hash()
+{
+    return gNetwork.RequestStateHash();
+}
+
 void network_send_tick()
 {
     gNetwork.Server_Send_TICK();
@@ -4006,6 +4283,9 @@ bool network_check_desynchronisation()
 void network_request_gamestate_snapshot()
 {
 }
+void network_request_state_hash()
+{
+}
 void network_send_game_action(const GameAction* action)
 {
 }
@@ -8,7 +8,10 @@
 #include "NetworkTypes.h"
 #include "NetworkUser.h"
 
+#include <condition_variable>
 #include <fstream>
+#include <mutex>
+#include <thread>
 
 #ifndef DISABLE_NETWORK
 
@@ -62,6 +65,10 @@ public: // Server
     void CloseServerLog();
     void DecayCooldown(NetworkPlayer* player);
     void AddClient(std::unique_ptr<ITcpSocket>&& socket);
+    void StartIoThread();
+    void StopIoThread();
+    void UpdateIoThread();
+    void RemoveIoConnection(NetworkConnection& connection);
     std::string GetMasterServerUrl();
     std::string GenerateAdvertiseKey();
     void SetupDefaultGroups();
@@ -69,13 +76,15 @@ public: // Server
     void UpdateServer();
     void ServerClientDisconnected(std::unique_ptr<NetworkConnection>& connection);
     bool SaveMap(OpenRCT2::IStream* stream, const std::vector<const ObjectRepositoryItem*>& objects) const;
-    std::vector<uint8_t> save_for_network(const std::vector<const ObjectRepositoryItem*>& objects) const;
+    std::vector<uint8_t> save_map_for_network(const std::vector<const ObjectRepositoryItem*>& objects) const;
+    static std::vector<uint8_t> compress_map_for_network(const std::vector<uint8_t>& map);
     std::string MakePlayerNameUnique(const std::string& name);
 
     // Packet dispatchers.
     void Server_Send_AUTH(NetworkConnection& connection);
     void Server_Send_TOKEN(NetworkConnection& connection);
     void Server_Send_MAP(NetworkConnection* connection = nullptr);
+    void Server_Send_MAP_Data(NetworkConnection* connection, const std::vector<uint8_t>& header);
     void Server_Send_CHAT(const char* text, const std::vector<uint8_t>& playerIds = {});
     void Server_Send_GAME_ACTION(const GameAction* action);
     void Server_Send_TICK();
@@ -94,6 +103,7 @@ public: // Server
 
     // Handlers
     void Server_Handle_REQUEST_GAMESTATE(NetworkConnection& connection, NetworkPacket& packet);
+    void Server_Handle_REQUEST_STATE_HASH(NetworkConnection& connection, NetworkPacket& packet);
     void Server_Handle_HEARTBEAT(NetworkConnection& connection, NetworkPacket& packet);
     void Server_Handle_AUTH(NetworkConnection& connection, NetworkPacket& packet);
     void Server_Client_Joined(const char* name, const std::string& keyhash, NetworkConnection& connection);
@@ -117,6 +127,7 @@ public: // Client
     bool CheckSRAND(uint32_t tick, uint32_t srand0);
     bool CheckDesynchronizaton();
     void RequestStateSnapshot();
+    void RequestStateHash();
     bool IsDesynchronised();
     NetworkServerState_t GetServerState() const;
     void ServerClientDisconnected();
@@ -125,6 +136,7 @@ public: // Client
 
     // Packet dispatchers.
     void Client_Send_RequestGameState(uint32_t tick);
+    void Client_Send_RequestStateHash(uint32_t tick);
     void Client_Send_TOKEN();
     void Client_Send_AUTH(
         const std::string& name, const std::string& password, const std::string& pubkey, const std::vector<uint8_t>& signature);
@@ -154,6 +166,7 @@ public: // Client
     void Client_Handle_OBJECTS_LIST(NetworkConnection& connection, NetworkPacket& packet);
     void Client_Handle_SCRIPTS(NetworkConnection& connection, NetworkPacket& packet);
     void Client_Handle_GAMESTATE(NetworkConnection& connection, NetworkPacket& packet);
+    void Client_Handle_STATE_HASH(NetworkConnection& connection, NetworkPacket& packet);
 
     std::vector<uint8_t> _challenge;
     std::map<uint32_t, GameAction::Callback_t> _gameActionCallbacks;
@@ -195,6 +208,15 @@ private: // Server Data
     uint16_t listening_port = 0;
     bool _playerListInvalidated = false;
 
+    // Headless servers read and write the client sockets on this thread, so that slow sockets do not hold up the game
+    std::thread _ioThread;
+    std::mutex _ioMutex;
+    std::condition_variable _ioCondition;
+    std::condition_variable _ioPassFinished;
+    std::vector<NetworkConnection*> _ioConnections;
+    bool _ioPassActive = false;
+    bool _ioThreadStop = false;
+
 private: // Client Data
     struct PlayerListUpdate
     {
@@ -206,6 +228,10 @@ private: // Client Data
         uint32_t srand0;
         uint32_t tick;
         std::string spriteHash;
+        // The server's state hash of an earlier tick
+        bool hasStateHash = false;
+        uint32_t stateHashTick = 0;
+        uint64_t stateHash = 0;
     };
 
     std::unordered_map<NetworkCommand, CommandHandler> client_command_handlers;
@@ -31,16 +31,44 @@ NetworkConnection::~NetworkConnection()
 }
 
 NetworkReadPacket NetworkConnection::ReadPacket()
+{
+    NetworkReadPacket status;
+    if (_usesIoThread)
+    {
+        std::lock_guard<std::mutex> lock(_ioMutex);
+        if (_ioReceivedPackets.empty())
+        {
+            return _ioDisconnected ? NetworkReadPacket::Disconnected : NetworkReadPacket::NoData;
+        }
+        InboundPacket = std::move(_ioReceivedPackets.front());
+        _ioReceivedPackets.pop_front();
+        status = NetworkReadPacket::Success;
+    }
+    else
+    {
+        status = ReceivePacket(InboundPacket);
+    }
+
+    if (status == NetworkReadPacket::Success)
+    {
+        _lastPacketTime = platform_get_ticks();
+
+        RecordPacketStats(InboundPacket, false);
+    }
+    return status;
+}
+
+NetworkReadPacket NetworkConnection::ReceivePacket(NetworkPacket& packet)
 {
     size_t bytesRead = 0;
 
     // Read packet header.
-    auto& header = InboundPacket.Header;
-    if (InboundPacket.BytesTransferred < sizeof(InboundPacket.Header))
+    auto& header = packet.Header;
+    if (packet.BytesTransferred < sizeof(packet.Header))
     {
-        const size_t missingLength = sizeof(header) - InboundPacket.BytesTransferred;
+        const size_t missingLength = sizeof(header) - packet.BytesTransferred;
 
-        uint8_t* buffer = reinterpret_cast<uint8_t*>(&InboundPacket.Header);
+        uint8_t* buffer = reinterpret_cast<uint8_t*>(&packet.Header);
 
         NetworkReadPacket status = Socket->ReceiveData(buffer, missingLength, &bytesRead);
         if (status != NetworkReadPacket::Success)
@@ -48,8 +76,8 @@ NetworkReadPacket NetworkConnection::ReadPacket()
             return status;
         }
 
-        InboundPacket.BytesTransferred += bytesRead;
-        if (InboundPacket.BytesTransferred < sizeof(InboundPacket.Header))
+        packet.BytesTransferred += bytesRead;
+        if (packet.BytesTransferred < sizeof(packet.Header))
         {
             // If still not enough data for header, keep waiting.
             return NetworkReadPacket::MoreData;
@@ -68,7 +96,7 @@ NetworkReadPacket NetworkConnection::ReadPacket()
 
     // Read packet body.
     {
-        const size_t missingLength = header.Size - (InboundPacket.BytesTransferred - sizeof(header));
+        const size_t missingLength = header.Size - (packet.BytesTransferred - sizeof(header));
 
         uint8_t buffer[NetworkBufferSize];
 
@@ -80,17 +108,13 @@ NetworkReadPacket NetworkConnection::ReadPacket()
                 return status;
             }
 
-            InboundPacket.BytesTransferred += bytesRead;
-            InboundPacket.Write(buffer, bytesRead);
+            packet.BytesTransferred += bytesRead;
+            packet.Write(buffer, bytesRead);
         }
 
-        if (InboundPacket.Data.size() == header.Size)
+        if (packet.Data.size() == header.Size)
         {
             // Received complete packet.
-            _lastPacketTime = platform_get_ticks();
-
-            RecordPacketStats(InboundPacket, false);
-
             return NetworkReadPacket::Success;
         }
     }
@@ -98,13 +122,10 @@ NetworkReadPacket NetworkConnection::ReadPacket()
     return NetworkReadPacket::MoreData;
 }
 
-bool NetworkConnection::SendPacket(NetworkPacket& packet)
+void NetworkConnection::WritePacketToBuffer(const NetworkPacket& packet, std::vector<uint8_t>& buffer)
 {
     auto header = packet.Header;
 
-    std::vector<uint8_t> buffer;
-    buffer.reserve(sizeof(header) + header.Size);
-
     // NOTE: For compatibility reasons for the master server we need to add sizeof(Header.Id) to the size.
     // Previously the Id field was not part of the header rather part of the body.
     header.Size += sizeof(header.Id);
@@ -114,43 +135,32 @@ bool NetworkConnection::SendPacket(NetworkPacket& packet)
     buffer.insert(buffer.end(), reinterpret_cast<uint8_t*>(&header), reinterpret_cast<uint8_t*>(&header) + sizeof(header));
     buffer.insert(buffer.end(), packet.Data.begin(), packet.Data.end());
 
-    size_t bufferSize = buffer.size() - packet.BytesTransferred;
-    size_t sent = Socket->SendData(buffer.data() + packet.BytesTransferred, bufferSize);
-    if (sent > 0)
-    {
-        packet.BytesTransferred += sent;
-    }
-
-    bool sendComplete = packet.BytesTransferred == buffer.size();
-    if (sendComplete)
-    {
-        RecordPacketStats(packet, true);
-    }
-    return sendComplete;
+    RecordPacketStats(packet, true);
 }
 
 void NetworkConnection::QueuePacket(NetworkPacket&& packet, bool front)
 {
-    if (AuthStatus == NetworkAuth::Ok || !packet.CommandRequiresAuth())
+    packet.Header.Size = static_cast<uint16_t>(packet.Data.size());
+    QueuePacket(std::make_shared<const NetworkPacket>(std::move(packet)), front);
+}
+
+void NetworkConnection::QueuePacket(const std::shared_ptr<const NetworkPacket>& packet, bool front)
+{
+    if (AuthStatus == NetworkAuth::Ok || !packet->CommandRequiresAuth())
     {
-        packet.Header.Size = static_cast<uint16_t>(packet.Data.size());
-        if (front)
+        if (PendingMap.valid() && !front)
         {
-            // If the first packet was already partially sent add new packet to second position
-            if (!_outboundPackets.empty() && _outboundPackets.front().BytesTransferred > 0)
-            {
-                auto it = _outboundPackets.begin();
-                it++; // Second position
-                _outboundPackets.insert(it, std::move(packet));
-            }
-            else
-            {
-                _outboundPackets.push_front(std::move(packet));
-            }
+            _heldPackets.push_back(packet);
+        }
+        else if (front)
+        {
+            // Packets that are already being sent are in the outbound buffer, so this still goes out before any other
+            // queued packet.
+            _outboundPackets.push_front(packet);
         }
         else
         {
-            _outboundPackets.push_back(std::move(packet));
+            _outboundPackets.push_back(packet);
         }
     }
 }
@@ -167,10 +177,106 @@ bool NetworkConnection::IsValid() const
 
 void NetworkConnection::SendQueuedPackets()
 {
-    while (!_outboundPackets.empty() && SendPacket(_outboundPackets.front()))
+    if (_usesIoThread)
     {
-        _outboundPackets.pop_front();
+        // Hand the packets over to the I/O thread, which writes them to the socket
+        std::lock_guard<std::mutex> lock(_ioMutex);
+        for (const auto& packet : _outboundPackets)
+        {
+            WritePacketToBuffer(*packet, _ioOutboundBuffer);
+        }
+        _outboundPackets.clear();
+        return;
     }
+
+    // Write all queued packets to the socket at once rather than one call per packet. New packets are only added once
+    // the previous ones have been sent completely.
+    if (_outboundBufferSent == _outboundBuffer.size())
+    {
+        _outboundBuffer.clear();
+        _outboundBufferSent = 0;
+        for (const auto& packet : _outboundPackets)
+        {
+            WritePacketToBuffer(*packet, _outboundBuffer);
+        }
+        _outboundPackets.clear();
+    }
+
+    if (_outboundBufferSent < _outboundBuffer.size())
+    {
+        _outboundBufferSent += Socket->SendData(
+            _outboundBuffer.data() + _outboundBufferSent, _outboundBuffer.size() - _outboundBufferSent);
+    }
+}
+
+void NetworkConnection::SetUsesIoThread(bool usesIoThread)
+{
+    if (!usesIoThread && _usesIoThread)
+    {
+        // Whatever the I/O thread did not get to send yet is sent by SendQueuedPackets from now on
+        _outboundBuffer.insert(_outboundBuffer.end(), _ioOutboundBuffer.begin(), _ioOutboundBuffer.end());
+        _ioOutboundBuffer.clear();
+    }
+    _usesIoThread = usesIoThread;
+}
+
+bool NetworkConnection::UpdateIo()
+{
+    if (_ioDisconnected)
+        return false;
+
+    bool transferred = false;
+    try
+    {
+        NetworkReadPacket status;
+        do
+        {
+            status = ReceivePacket(_ioInboundPacket);
+            if (status == NetworkReadPacket::Success)
+            {
+                std::lock_guard<std::mutex> lock(_ioMutex);
+                _ioReceivedPackets.push_back(std::move(_ioInboundPacket));
+                _ioInboundPacket = NetworkPacket();
+            }
+            else if (status == NetworkReadPacket::Disconnected)
+            {
+                std::lock_guard<std::mutex> lock(_ioMutex);
+                _ioDisconnected = true;
+                return transferred;
+            }
+            transferred |= status != NetworkReadPacket::NoData;
+        } while (status == NetworkReadPacket::Success);
+
+        if (_outboundBufferSent == _outboundBuffer.size())
+        {
+            _outboundBuffer.clear();
+            _outboundBufferSent = 0;
+
+            std::lock_guard<std::mutex> lock(_ioMutex);
+            std::swap(_outboundBuffer, _ioOutboundBuffer);
+        }
+        if (_outboundBufferSent < _outboundBuffer.size())
+        {
+            size_t sent = Socket->SendData(
+                _outboundBuffer.data() + _outboundBufferSent, _outboundBuffer.size() - _outboundBufferSent);
+            _outboundBufferSent += sent;
+            transferred |= sent > 0;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        log_verbose("Network I/O failed: %s", e.what());
+
+        std::lock_guard<std::mutex> lock(_ioMutex);
+        _ioDisconnected = true;
+    }
+    return transferred;
+}
+
+void NetworkConnection::ReleaseHeldPackets()
+{
+    std::move(_heldPackets.begin(), _heldPackets.end(), std::back_inserter(_outboundPackets));
+    _heldPackets.clear();
 }
 
 void NetworkConnection::ResetLastPacketTime()
@@ -219,7 +325,7 @@ void NetworkConnection::SetLastDisconnectReason(const rct_string_id string_id, v
 
 void NetworkConnection::RecordPacketStats(const NetworkPacket& packet, bool sending)
 {
-    uint32_t packetSize = static_cast<uint32_t>(packet.BytesTransferred);
+    uint32_t packetSize = static_cast<uint32_t>(sizeof(packet.Header) + packet.Data.size());
     NetworkStatisticsGroup trafficGroup;
 
     switch (packet.GetCommand())
@@ -17,7 +17,9 @@
 #    include "Socket.h"
 
 #    include <deque>
+#    include <future>
 #    include <memory>
+#    include <mutex>
 #    include <vector>
 
 class NetworkPlayer;
@@ -37,6 +39,10 @@ public:
     std::vector<const ObjectRepositoryItem*> RequestedObjects;
     bool ShouldDisconnect = false;
 
+    // Map that is still being compressed on another thread. Until it is ready, packets queued for this connection
+    // are held back so that the client receives them after the map.
+    std::future<std::vector<uint8_t>> PendingMap;
+
     NetworkConnection();
     ~NetworkConnection();
 
@@ -47,6 +53,8 @@ public:
         auto copy = packet;
         return QueuePacket(std::move(copy), front);
     }
+    // Queues a packet that is shared with other connections, it must not be modified afterwards.
+    void QueuePacket(const std::shared_ptr<const NetworkPacket>& packet, bool front = false);
 
     // This will not immediately disconnect the client. The disconnect
     // will happen post-tick.
@@ -54,6 +62,14 @@ public:
 
     bool IsValid() const;
     void SendQueuedPackets();
+
+    // While set, the socket is only read and written by UpdateIo on the I/O thread. ReadPacket and SendQueuedPackets
+    // then exchange complete packets with that thread instead of using the socket.
+    void SetUsesIoThread(bool usesIoThread);
+    // Called by the I/O thread, returns whether any data was received or sent.
+    bool UpdateIo();
+
+    void ReleaseHeldPackets();
     void ResetLastPacketTime();
     bool ReceivedPacketRecently();
 
@@ -62,12 +78,23 @@ public:
     void SetLastDisconnectReason(const rct_string_id string_id, void* args = nullptr);
 
 private:
-    std::deque<NetworkPacket> _outboundPackets;
+    std::deque<std::shared_ptr<const NetworkPacket>> _outboundPackets;
+    std::deque<std::shared_ptr<const NetworkPacket>> _heldPackets;
+    std::vector<uint8_t> _outboundBuffer;
+    size_t _outboundBufferSent = 0;
     uint32_t _lastPacketTime = 0;
     utf8* _lastDisconnectReason = nullptr;
 
+    bool _usesIoThread = false;
+    std::mutex _ioMutex;
+    NetworkPacket _ioInboundPacket;
+    std::deque<NetworkPacket> _ioReceivedPackets;
+    std::vector<uint8_t> _ioOutboundBuffer;
+    bool _ioDisconnected = false;
+
+    NetworkReadPacket ReceivePacket(NetworkPacket& packet);
     void RecordPacketStats(const NetworkPacket& packet, bool sending);
-    bool SendPacket(NetworkPacket& packet);
+    void WritePacketToBuffer(const NetworkPacket& packet, std::vector<uint8_t>& buffer);
 };
 
 #endif // DISABLE_NETWORK
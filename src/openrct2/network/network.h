@@ -52,6 +52,7 @@ int32_t network_get_status();
 bool network_is_desynchronised();
 bool network_check_desynchronisation();
 void network_request_gamestate_snapshot();
+void network_request_state_hash();
 void network_send_tick();
 bool network_gamestate_snapshots_enabled();
 void network_update();
@@ -77,6 +77,13 @@ static constexpr int32_t CalculatePositionHash(const paint_struct& ps, uint8_t r
 
 static void PaintSessionAddPSToQuadrant(paint_session* session, paint_struct* ps)
 {
+    if (session->BandStructs != nullptr)
+    {
+        // Sorted into the quadrants of each column later, see PaintBandGenerateColumn
+        session->BandStructs->push_back(ps);
+        return;
+    }
+
     auto positionHash = CalculatePositionHash(*ps, session->CurrentRotation);
     uint32_t paintQuadrantIndex = std::clamp(positionHash / 32, 0, MAX_PAINT_QUADRANTS - 1);
     ps->quadrant_index = paintQuadrantIndex;
@@ -186,11 +193,11 @@ static paint_struct* CreateNormalPaintStruct(
     return ps;
 }
 
-template<uint8_t direction> void PaintSessionGenerateRotate(paint_session* session)
+template<uint8_t direction, typename TTileFn, typename TSpriteFn>
+static void PaintWalkTilesRotate(const rct_drawpixelinfo& dpi, TTileFn&& tileFn, TSpriteFn&& spriteFn)
 {
     // Optimised modified version of viewport_coord_to_map_coord
-    ScreenCoordsXY screenCoord = { static_cast<int16_t>((session->DPI.x) & 0xFFE0),
-                                   static_cast<int16_t>((session->DPI.y - 16) & 0xFFE0) };
+    ScreenCoordsXY screenCoord = { static_cast<int16_t>((dpi.x) & 0xFFE0), static_cast<int16_t>((dpi.y - 16) & 0xFFE0) };
     CoordsXY mapTile = { screenCoord.y - screenCoord.x / 2, screenCoord.y + screenCoord.x / 2 };
     mapTile = mapTile.Rotate(direction);
 
@@ -200,7 +207,7 @@ template<uint8_t direction> void PaintSessionGenerateRotate(paint_session* sessi
     }
     mapTile = mapTile.ToTileStart();
 
-    uint16_t numVerticalTiles = (session->DPI.height + 2128) >> 5;
+    uint16_t numVerticalTiles = (dpi.height + 2128) >> 5;
 
     // Adjacent tiles to also check due to overlapping of sprites
     constexpr CoordsXY adjacentTiles[] = { CoordsXY{ -32, 32 }.Rotate(direction), CoordsXY{ 0, 32 }.Rotate(direction),
@@ -209,50 +216,151 @@ template<uint8_t direction> void PaintSessionGenerateRotate(paint_session* sessi
 
     for (; numVerticalTiles > 0; --numVerticalTiles)
     {
-        tile_element_paint_setup(session, mapTile);
-        sprite_paint_setup(session, mapTile.x, mapTile.y);
+        tileFn(mapTile);
+        spriteFn(mapTile);
 
         auto loc1 = mapTile + adjacentTiles[0];
-        sprite_paint_setup(session, loc1.x, loc1.y);
+        spriteFn(loc1);
 
         auto loc2 = mapTile + adjacentTiles[1];
-        tile_element_paint_setup(session, loc2);
-        sprite_paint_setup(session, loc2.x, loc2.y);
+        tileFn(loc2);
+        spriteFn(loc2);
 
         auto loc3 = mapTile + adjacentTiles[2];
-        sprite_paint_setup(session, loc3.x, loc3.y);
+        spriteFn(loc3);
 
         mapTile += nextVerticalTile;
     }
 }
 
 /**
- *
- *  rct2: 0x0068B6C2
+ * Calls tileFn and spriteFn for each tile that has to be set up to paint a column of at most 32 pixels wide, in the
+ * order they are painted.
  */
-void PaintSessionGenerate(paint_session* session)
+template<typename TTileFn, typename TSpriteFn>
+static void PaintWalkTiles(uint8_t rotation, const rct_drawpixelinfo& dpi, TTileFn&& tileFn, TSpriteFn&& spriteFn)
 {
-    session->CurrentRotation = get_current_rotation();
-
     // Extracted from viewport_coord_to_map_coord
     constexpr uint8_t inverseRotationMapping[NumOrthogonalDirections] = { 0, 3, 2, 1 };
-    switch (inverseRotationMapping[session->CurrentRotation])
+    switch (inverseRotationMapping[rotation])
     {
         case 0:
-            PaintSessionGenerateRotate<0>(session);
+            PaintWalkTilesRotate<0>(dpi, tileFn, spriteFn);
             break;
         case 1:
-            PaintSessionGenerateRotate<1>(session);
+            PaintWalkTilesRotate<1>(dpi, tileFn, spriteFn);
             break;
         case 2:
-            PaintSessionGenerateRotate<2>(session);
+            PaintWalkTilesRotate<2>(dpi, tileFn, spriteFn);
             break;
         case 3:
-            PaintSessionGenerateRotate<3>(session);
+            PaintWalkTilesRotate<3>(dpi, tileFn, spriteFn);
             break;
     }
 }
 
+/**
+ *
+ *  rct2: 0x0068B6C2
+ */
+void PaintSessionGenerate(paint_session* session)
+{
+    session->CurrentRotation = get_current_rotation();
+    PaintWalkTiles(
+        session->CurrentRotation, session->DPI, [session](const CoordsXY& loc) { tile_element_paint_setup(session, loc); },
+        [session](const CoordsXY& loc) { sprite_paint_setup(session, loc.x, loc.y); });
+}
+
+void PaintBandGenerate(PaintBand* band)
+{
+    auto* session = band->Session;
+    session->CurrentRotation = get_current_rotation();
+
+    band->Structs.clear();
+    band->Calls.clear();
+    band->CallIndex.clear();
+    band->ColumnCalls.resize(band->Columns.size());
+
+    session->BandStructs = &band->Structs;
+    for (size_t i = 0; i < band->Columns.size(); i++)
+    {
+        auto& columnCalls = band->ColumnCalls[i];
+        columnCalls.clear();
+
+        // Tile coordinates are multiples of 32, so the lowest bit tells tile elements and sprites apart
+        auto visit = [band, &columnCalls](const CoordsXY& loc, uint32_t isSprite, auto&& setupFn) {
+            auto key = (static_cast<uint64_t>(static_cast<uint32_t>(loc.x)) << 32) | static_cast<uint32_t>(loc.y) | isSprite;
+            auto [it, inserted] = band->CallIndex.try_emplace(key, static_cast<uint32_t>(band->Calls.size()));
+            if (inserted)
+            {
+                auto begin = static_cast<uint32_t>(band->Structs.size());
+                setupFn();
+                band->Calls.emplace_back(begin, static_cast<uint32_t>(band->Structs.size()));
+            }
+            columnCalls.push_back(it->second);
+        };
+        PaintWalkTiles(
+            session->CurrentRotation, band->Columns[i]->DPI,
+            [session, &visit](const CoordsXY& loc) { visit(loc, 0, [&]() { tile_element_paint_setup(session, loc); }); },
+            [session, &visit](const CoordsXY& loc) { visit(loc, 1, [&]() { sprite_paint_setup(session, loc.x, loc.y); }); });
+    }
+    session->BandStructs = nullptr;
+}
+
+/**
+ * Checks whether anything drawn for a parent paint struct, including its children and attached images, is inside dpi.
+ */
+static bool PaintStructWithinDPI(const paint_struct& parent, const rct_drawpixelinfo& dpi)
+{
+    for (const auto* ps = &parent; ps != nullptr; ps = ps->children)
+    {
+        const auto* g1 = gfx_get_g1_element(ps->image_id & 0x7FFFF);
+        if (g1 != nullptr && ImageWithinDPI({ ps->x, ps->y }, *g1, dpi))
+        {
+            return true;
+        }
+
+        // Attached images are only drawn for the last child, see PaintDrawStruct
+        if (ps->children == nullptr)
+        {
+            for (const auto* attached = ps->attached_ps; attached != nullptr; attached = attached->next)
+            {
+                g1 = gfx_get_g1_element(attached->image_id & 0x7FFFF);
+                if (g1 != nullptr && ImageWithinDPI({ ps->x + attached->x, ps->y + attached->y }, *g1, dpi))
+                {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+void PaintBandGenerateColumn(const PaintBand* band, size_t columnIndex)
+{
+    auto* session = band->Columns[columnIndex];
+    session->CurrentRotation = band->Session->CurrentRotation;
+    for (auto callIndex : band->ColumnCalls[columnIndex])
+    {
+        const auto& [begin, end] = band->Calls[callIndex];
+        for (auto i = begin; i < end; i++)
+        {
+            const auto* ps = band->Structs[i];
+            if (!PaintStructWithinDPI(*ps, session->DPI))
+                continue;
+
+            // Sorting links the structs of each column together, so every column needs its own copy. The children and
+            // attached images are only read and can stay shared.
+            auto* copy = session->AllocateNormalPaintEntry();
+            if (copy == nullptr)
+                return;
+
+            *copy = *ps;
+            PaintSessionAddPSToQuadrant(session, copy);
+        }
+    }
+}
+
 template<uint8_t>
 static bool CheckBoundingBox(const paint_struct_bound_box& initialBBox, const paint_struct_bound_box& currentBBox)
 {
@@ -299,8 +407,16 @@ template<> bool CheckBoundingBox<3>(const paint_struct_bound_box& initialBBox, c
     return false;
 }
 
+struct PaintArrangeEntry
+{
+    paint_struct* Struct;
+    paint_struct_bound_box Bounds;
+    uint8_t QuadrantFlags;
+};
+
 template<uint8_t _TRotation>
-static paint_struct* PaintArrangeStructsHelperRotation(paint_struct* ps_next, uint16_t quadrantIndex, uint8_t flag)
+static paint_struct* PaintArrangeStructsHelperRotation(
+    std::vector<PaintArrangeEntry>& window, paint_struct* ps_next, uint16_t quadrantIndex, uint8_t flag)
 {
     paint_struct* ps;
     paint_struct* ps_temp;
@@ -335,58 +451,67 @@ static paint_struct* PaintArrangeStructsHelperRotation(paint_struct* ps_next, ui
             ps->quadrant_flags = flag | PAINT_QUADRANT_FLAG_IDENTICAL;
         }
     } while (ps->quadrant_index <= quadrantIndex + 1);
-    ps = ps_temp;
 
-    while (true)
+    // Copy the structs up to the first bigger one into an array, so that the comparisons below walk contiguous
+    // memory instead of chasing the list
+    window.clear();
+    paint_struct* ps_end = ps_temp->next_quadrant_ps;
+    while (ps_end != nullptr && !(ps_end->quadrant_flags & PAINT_QUADRANT_FLAG_BIGGER))
     {
-        while (true)
-        {
-            ps_next = ps->next_quadrant_ps;
-            if (ps_next == nullptr)
-                return ps_cache;
-            if (ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_BIGGER)
-                return ps_cache;
-            if (ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_IDENTICAL)
-                break;
-            ps = ps_next;
-        }
+        window.push_back({ ps_end, ps_end->bounds, ps_end->quadrant_flags });
+        ps_end = ps_end->next_quadrant_ps;
+    }
 
-        ps_next->quadrant_flags &= ~PAINT_QUADRANT_FLAG_IDENTICAL;
-        ps_temp = ps;
+    // Every struct that has to be drawn before an identical one is moved in front of it. Each one goes in front of the
+    // ones moved before it, so they end up in the reverse of the order they were found, as in the original list code.
+    // Moved structs are then checked again from the front.
+    const size_t count = window.size();
+    size_t first = 0;
+    while (true)
+    {
+        size_t i = first;
+        while (i < count && !(window[i].QuadrantFlags & PAINT_QUADRANT_FLAG_IDENTICAL))
+            i++;
+        if (i == count)
+            break;
 
-        const paint_struct_bound_box& initialBBox = ps_next->bounds;
+        window[i].QuadrantFlags &= ~PAINT_QUADRANT_FLAG_IDENTICAL;
+        const paint_struct_bound_box initialBBox = window[i].Bounds;
 
-        while (true)
+        for (size_t j = i + 1; j < count; j++)
         {
-            ps = ps_next;
-            ps_next = ps_next->next_quadrant_ps;
-            if (ps_next == nullptr)
-                break;
-            if (ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_BIGGER)
-                break;
-            if (!(ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_NEXT))
+            if (!(window[j].QuadrantFlags & PAINT_QUADRANT_FLAG_NEXT))
                 continue;
 
-            const paint_struct_bound_box& currentBBox = ps_next->bounds;
+            const paint_struct_bound_box& currentBBox = window[j].Bounds;
 
             const bool compareResult = CheckBoundingBox<_TRotation>(initialBBox, currentBBox);
 
             if (compareResult)
             {
-                ps->next_quadrant_ps = ps_next->next_quadrant_ps;
-                paint_struct* ps_temp2 = ps_temp->next_quadrant_ps;
-                ps_temp->next_quadrant_ps = ps_next;
-                ps_next->next_quadrant_ps = ps_temp2;
-                ps_next = ps;
+                std::rotate(window.begin() + i, window.begin() + j, window.begin() + j + 1);
             }
         }
 
-        ps = ps_temp;
+        first = i;
     }
+
+    for (const auto& entry : window)
+    {
+        ps_temp->next_quadrant_ps = entry.Struct;
+        entry.Struct->quadrant_flags = entry.QuadrantFlags;
+        ps_temp = entry.Struct;
+    }
+    ps_temp->next_quadrant_ps = ps_end;
+
+    return ps_cache;
 }
 
 template<int TRotation> static void PaintSessionArrange(PaintSessionCore* session, bool)
 {
+    // Columns are arranged on several threads at once
+    thread_local std::vector<PaintArrangeEntry> window;
+
     paint_struct* psHead = &session->PaintHead;
 
     paint_struct* ps = psHead;
@@ -411,12 +536,12 @@ template<int TRotation> static void PaintSessionArrange(PaintSessionCore* sessio
         } while (++quadrantIndex <= session->QuadrantFrontIndex);
 
         paint_struct* ps_cache = PaintArrangeStructsHelperRotation<TRotation>(
-            psHead, session->QuadrantBackIndex & 0xFFFF, PAINT_QUADRANT_FLAG_NEXT);
+            window, psHead, session->QuadrantBackIndex & 0xFFFF, PAINT_QUADRANT_FLAG_NEXT);
 
         quadrantIndex = session->QuadrantBackIndex;
         while (++quadrantIndex < session->QuadrantFrontIndex)
         {
-            ps_cache = PaintArrangeStructsHelperRotation<TRotation>(ps_cache, quadrantIndex & 0xFFFF, 0);
+            ps_cache = PaintArrangeStructsHelperRotation<TRotation>(window, ps_cache, quadrantIndex & 0xFFFF, 0);
         }
     }
 }
@@ -17,6 +17,9 @@
 
 #include <mutex>
 #include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 struct TileElement;
 enum class ViewportInteractionItem : uint8_t;
@@ -225,6 +228,8 @@ struct paint_session : public PaintSessionCore
 {
     rct_drawpixelinfo DPI;
     PaintEntryPool::Chain PaintEntryChain;
+    // When set, parent paint structs are collected here instead of being added to the quadrants
+    std::vector<paint_struct*>* BandStructs{};
 
     paint_struct* AllocateNormalPaintEntry() noexcept
     {
@@ -269,6 +274,25 @@ struct paint_session : public PaintSessionCore
     }
 };
 
+/**
+ * The paint structs of a band of neighbouring columns. Every tile the columns cover is set up once for the whole band,
+ * then each column takes the structs that reach into it, in the order its own tiles would have been set up.
+ */
+struct PaintBand
+{
+    // Paint session covering all the columns, owns the structs
+    paint_session* Session{};
+    std::vector<paint_session*> Columns;
+    // Parent structs in the order they were created
+    std::vector<paint_struct*> Structs;
+    // The range of Structs created by each tile element or sprite setup
+    std::vector<std::pair<uint32_t, uint32_t>> Calls;
+    // Index of the setup for each tile, see PaintBandGenerate
+    std::unordered_map<uint64_t, uint32_t> CallIndex;
+    // The setups each column uses, in the order the column uses them
+    std::vector<std::vector<uint32_t>> ColumnCalls;
+};
+
 struct RecordedPaintSession
 {
     PaintSessionCore Session;
@@ -336,6 +360,8 @@ void PaintFloatingMoneyEffect(
 paint_session* PaintSessionAlloc(rct_drawpixelinfo* dpi, uint32_t viewFlags);
 void PaintSessionFree(paint_session* session);
 void PaintSessionGenerate(paint_session* session);
+void PaintBandGenerate(PaintBand* band);
+void PaintBandGenerateColumn(const PaintBand* band, size_t columnIndex);
 void PaintSessionArrange(PaintSessionCore* session);
 void PaintDrawStructs(paint_session* session);
 void PaintDrawMoneyStructs(rct_drawpixelinfo* dpi, paint_string_struct* ps);
@@ -13,6 +13,7 @@
 #include "../audio/audio.h"
 #include "../config/Config.h"
 #include "../core/Guard.hpp"
+#include "../core/JobPool.h"
 #include "../interface/Window_internal.h"
 #include "../localisation/Localisation.h"
 #include "../management/Finance.h"
@@ -420,7 +421,18 @@ static void peep_update_ride_nausea_growth(Guest* peep, Ride* ride);
 static bool peep_should_go_on_ride_again(Guest* peep, Ride* ride);
 static bool peep_should_preferred_intensity_increase(Guest* peep);
 static bool peep_really_liked_ride(Guest* peep, Ride* ride);
-static PeepThoughtType peep_assess_surroundings(int16_t centre_x, int16_t centre_y, int16_t centre_z);
+struct GuestSurroundingsScan
+{
+    uint16_t NumScenery{};
+    uint16_t NumFountains{};
+    uint16_t NumRubbish{};
+    uint8_t NearbyMusic{};
+    bool NoThought{};
+};
+
+static GuestSurroundingsScan peep_scan_surroundings(int16_t centre_x, int16_t centre_y, int16_t centre_z);
+static std::bitset<MAX_RIDES> peep_scan_nearby_rides(const CoordsXY& loc);
+static PeepThoughtType peep_assess_surroundings(const Guest* peep);
 static void peep_update_hunger(Guest* peep);
 static void peep_decide_whether_to_leave_park(Guest* peep);
 static void peep_leave_park(Guest* peep);
@@ -433,6 +445,94 @@ template<> bool SpriteBase::Is<Guest>() const
     return Type == EntityType::Guest;
 }
 
+// Map scans made ahead of the guest update loop for the guests that are due to think this tick
+struct GuestThinkingPrefetch
+{
+    uint16_t SpriteIndex{};
+    CoordsXYZ Location;
+    bool HasSurroundings{};
+    bool HasNearbyRides{};
+    GuestSurroundingsScan Surroundings;
+    std::bitset<MAX_RIDES> NearbyRides;
+};
+
+static std::vector<GuestThinkingPrefetch> _guestThinkingPrefetch;
+static std::unique_ptr<JobPool> _guestThinkingJobs;
+
+static const GuestThinkingPrefetch* guest_thinking_get_prefetch(const Guest* peep)
+{
+    auto it = std::lower_bound(
+        _guestThinkingPrefetch.begin(), _guestThinkingPrefetch.end(), peep->sprite_index,
+        [](const GuestThinkingPrefetch& prefetch, uint16_t spriteIndex) { return prefetch.SpriteIndex < spriteIndex; });
+    if (it == _guestThinkingPrefetch.end() || it->SpriteIndex != peep->sprite_index)
+        return nullptr;
+
+    // The scan is only valid for the location it was made from
+    if (!(it->Location == peep->GetLocation()))
+        return nullptr;
+
+    return &(*it);
+}
+
+/**
+ * Runs the map scans of the guests that are going to think this tick (surroundings assessment and nearby ride
+ * search) on the job pool. The scans only read the map, and guests do not change anything they read apart from
+ * vandalism, which discards the scans. The guests themselves are then updated serially in the usual order, so RNG
+ * draws and game state checksums are identical to not prefetching.
+ */
+void guest_thinking_prefetch()
+{
+    _guestThinkingPrefetch.clear();
+
+    // Mirrors the index counting of peep_update_all / Guest::Tick128UpdateGuest
+    uint32_t index = 0;
+    for (auto* guest : EntityList<Guest>())
+    {
+        if ((index & 0x1FF) == (gCurrentTicks & 0x1FF) && guest->x != LOCATION_NULL)
+        {
+            GuestThinkingPrefetch prefetch;
+            prefetch.SpriteIndex = guest->sprite_index;
+            prefetch.Location = guest->GetLocation();
+            prefetch.HasSurroundings = (guest->State == PeepState::Walking || guest->State == PeepState::Sitting)
+                && guest->SurroundingsThoughtTimeout + 1 >= 18;
+            prefetch.HasNearbyRides = guest->State == PeepState::Walking && guest->GuestHeadingToRideId == RIDE_ID_NULL
+                && !(guest->PeepFlags & PEEP_FLAGS_LEAVING_PARK) && !guest->HasFoodOrDrink()
+                && !guest->HasItem(ShopItem::Map);
+            if (prefetch.HasSurroundings || prefetch.HasNearbyRides)
+            {
+                _guestThinkingPrefetch.push_back(prefetch);
+            }
+        }
+        index++;
+    }
+
+    if (_guestThinkingPrefetch.empty())
+        return;
+
+    if (_guestThinkingJobs == nullptr)
+    {
+        _guestThinkingJobs = std::make_unique<JobPool>();
+    }
+
+    _guestThinkingJobs->ParallelFor(0, _guestThinkingPrefetch.size(), [](size_t i) {
+        auto& prefetch = _guestThinkingPrefetch[i];
+        const auto& loc = prefetch.Location;
+        if (prefetch.HasSurroundings)
+        {
+            prefetch.Surroundings = peep_scan_surroundings(loc.x & 0xFFE0, loc.y & 0xFFE0, loc.z);
+        }
+        if (prefetch.HasNearbyRides)
+        {
+            prefetch.NearbyRides = peep_scan_nearby_rides(loc);
+        }
+    });
+}
+
+void guest_thinking_prefetch_clear()
+{
+    _guestThinkingPrefetch.clear();
+}
+
 static bool IsValidLocation(const CoordsXYZ& coords)
 {
     if (coords.x != LOCATION_NULL)
@@ -945,7 +1045,7 @@ void Guest::Tick128UpdateGuest(int32_t index)
                 SurroundingsThoughtTimeout = 0;
                 if (x != LOCATION_NULL)
                 {
-                    PeepThoughtType thought_type = peep_assess_surroundings(x & 0xFFE0, y & 0xFFE0, z);
+                    PeepThoughtType thought_type = peep_assess_surroundings(this);
 
                     if (thought_type != PeepThoughtType::None)
                     {
@@ -1859,23 +1959,14 @@ std::bitset<MAX_RIDES> Guest::FindRidesToGoOn()
     else
     {
         // Take nearby rides into consideration
-        constexpr auto radius = 10 * 32;
-        int32_t cx = floor2(x, 32);
-        int32_t cy = floor2(y, 32);
-        for (int32_t tileX = cx - radius; tileX <= cx + radius; tileX += COORDS_XY_STEP)
+        auto* prefetch = guest_thinking_get_prefetch(this);
+        if (prefetch != nullptr && prefetch->HasNearbyRides)
         {
-            for (int32_t tileY = cy - radius; tileY <= cy + radius; tileY += COORDS_XY_STEP)
-            {
-                auto location = CoordsXY{ tileX, tileY };
-                if (!map_is_location_valid(location))
-                    continue;
-
-                for (auto* trackElement : TileElementsView<TrackElement>(location))
-                {
-                    auto rideIndex = trackElement->GetRideIndex();
-                    rideConsideration[rideIndex] = true;
-                }
-            }
+            rideConsideration = prefetch->NearbyRides;
+        }
+        else
+        {
+            rideConsideration = peep_scan_nearby_rides({ x, y });
         }
 
         // Always take the tall rides into consideration (realistic as you can usually see them from anywhere in the park)
@@ -2862,18 +2953,17 @@ static bool peep_really_liked_ride(Guest* peep, Ride* ride)
 }
 
 /**
- *
- *  rct2: 0x0069BC9A
+ * Counts the scenery, fountains, broken path additions and ride music around a location.
+ * Only reads the map, so it may be called from worker threads while the guests are not being updated.
  */
-static PeepThoughtType peep_assess_surroundings(int16_t centre_x, int16_t centre_y, int16_t centre_z)
+static GuestSurroundingsScan peep_scan_surroundings(int16_t centre_x, int16_t centre_y, int16_t centre_z)
 {
+    GuestSurroundingsScan scan;
     if ((tile_element_height({ centre_x, centre_y })) > centre_z)
-        return PeepThoughtType::None;
-
-    uint16_t num_scenery = 0;
-    uint16_t num_fountains = 0;
-    uint16_t nearby_music = 0;
-    uint16_t num_rubbish = 0;
+    {
+        scan.NoThought = true;
+        return scan;
+    }
 
     int16_t initial_x = std::max(centre_x - 160, 0);
     int16_t initial_y = std::max(centre_y - 160, 0);
@@ -2898,25 +2988,26 @@ static PeepThoughtType peep_assess_surroundings(int16_t centre_x, int16_t centre
                         auto* pathAddEntry = tileElement->AsPath()->GetAdditionEntry();
                         if (pathAddEntry == nullptr)
                         {
-                            return PeepThoughtType::None;
+                            scan.NoThought = true;
+                            return scan;
                         }
                         if (tileElement->AsPath()->AdditionIsGhost())
                             break;
 
                         if (pathAddEntry->flags & (PATH_BIT_FLAG_JUMPING_FOUNTAIN_WATER | PATH_BIT_FLAG_JUMPING_FOUNTAIN_SNOW))
                         {
-                            num_fountains++;
+                            scan.NumFountains++;
                             break;
                         }
                         if (tileElement->AsPath()->IsBroken())
                         {
-                            num_rubbish++;
+                            scan.NumRubbish++;
                         }
                         break;
                     }
                     case TILE_ELEMENT_TYPE_LARGE_SCENERY:
                     case TILE_ELEMENT_TYPE_SMALL_SCENERY:
-                        num_scenery++;
+                        scan.NumScenery++;
                         break;
                     case TILE_ELEMENT_TYPE_TRACK:
                         ride = get_ride(tileElement->AsTrack()->GetRideIndex());
@@ -2927,20 +3018,20 @@ static PeepThoughtType peep_assess_surroundings(int16_t centre_x, int16_t centre
                             {
                                 if (ride->type == RIDE_TYPE_MERRY_GO_ROUND)
                                 {
-                                    nearby_music |= 1;
+                                    scan.NearbyMusic |= 1;
                                     break;
                                 }
 
                                 if (ride->music == MUSIC_STYLE_ORGAN)
                                 {
-                                    nearby_music |= 1;
+                                    scan.NearbyMusic |= 1;
                                     break;
                                 }
 
                                 if (ride->type == RIDE_TYPE_DODGEMS)
                                 {
                                     // Dodgems drown out music?
-                                    nearby_music |= 2;
+                                    scan.NearbyMusic |= 2;
                                 }
                             }
                         }
@@ -2950,6 +3041,66 @@ static PeepThoughtType peep_assess_surroundings(int16_t centre_x, int16_t centre
         }
     }
 
+    return scan;
+}
+
+/**
+ * Finds the rides with track within 10 tiles of a location.
+ * Only reads the map, so it may be called from worker threads while the guests are not being updated.
+ */
+static std::bitset<MAX_RIDES> peep_scan_nearby_rides(const CoordsXY& loc)
+{
+    std::bitset<MAX_RIDES> nearbyRides;
+
+    constexpr auto radius = 10 * 32;
+    int32_t cx = floor2(loc.x, 32);
+    int32_t cy = floor2(loc.y, 32);
+    for (int32_t tileX = cx - radius; tileX <= cx + radius; tileX += COORDS_XY_STEP)
+    {
+        for (int32_t tileY = cy - radius; tileY <= cy + radius; tileY += COORDS_XY_STEP)
+        {
+            auto location = CoordsXY{ tileX, tileY };
+            if (!map_is_location_valid(location))
+                continue;
+
+            for (auto* trackElement : TileElementsView<TrackElement>(location))
+            {
+                auto rideIndex = trackElement->GetRideIndex();
+                nearbyRides[rideIndex] = true;
+            }
+        }
+    }
+    return nearbyRides;
+}
+
+/**
+ *
+ *  rct2: 0x0069BC9A
+ */
+static PeepThoughtType peep_assess_surroundings(const Guest* peep)
+{
+    int16_t centre_x = peep->x & 0xFFE0;
+    int16_t centre_y = peep->y & 0xFFE0;
+
+    GuestSurroundingsScan scan;
+    auto* prefetch = guest_thinking_get_prefetch(peep);
+    if (prefetch != nullptr && prefetch->HasSurroundings)
+    {
+        scan = prefetch->Surroundings;
+    }
+    else
+    {
+        scan = peep_scan_surroundings(centre_x, centre_y, peep->z);
+    }
+    if (scan.NoThought)
+        return PeepThoughtType::None;
+
+    uint16_t num_scenery = scan.NumScenery;
+    uint16_t num_fountains = scan.NumFountains;
+    uint16_t nearby_music = scan.NearbyMusic;
+    uint16_t num_rubbish = scan.NumRubbish;
+
+    // Litter is dropped by guests during the update loop, so it is always counted here
     for (auto litter : EntityList<Litter>())
     {
         int16_t dist_x = abs(litter->x - centre_x);
@@ -6117,6 +6268,8 @@ static void peep_update_walking_break_scenery(Guest* peep)
     }
 
     tileElement->SetIsBroken(true);
+    // Broken path additions count as rubbish, so any surroundings prefetched for later guests are out of date
+    guest_thinking_prefetch_clear();
 
     map_invalidate_tile_zoom1({ peep->NextLoc, tileElement->GetBaseZ(), tileElement->GetBaseZ() + 32 });
 
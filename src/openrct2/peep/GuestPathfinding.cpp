@@ -20,7 +20,10 @@
 #include "Peep.h"
 #include "Staff.h"
 
+#include <array>
 #include <cstring>
+#include <unordered_map>
+#include <vector>
 
 static bool _peepPathFindIsStaff;
 static int8_t _peepPathFindNumJunctions;
@@ -93,10 +96,8 @@ static TileElement* get_banner_on_path(TileElement* path_element)
     return nullptr;
 }
 
-static int32_t banner_clear_path_edges(PathElement* pathElement, int32_t edges)
+static int32_t banner_clear_path_edges_for_guests(PathElement* pathElement, int32_t edges)
 {
-    if (_peepPathFindIsStaff)
-        return edges;
     TileElement* bannerElement = get_banner_on_path(reinterpret_cast<TileElement*>(pathElement));
     if (bannerElement != nullptr)
     {
@@ -108,6 +109,13 @@ static int32_t banner_clear_path_edges(PathElement* pathElement, int32_t edges)
     return edges;
 }
 
+static int32_t banner_clear_path_edges(PathElement* pathElement, int32_t edges)
+{
+    if (_peepPathFindIsStaff)
+        return edges;
+    return banner_clear_path_edges_for_guests(pathElement, edges);
+}
+
 /**
  * Gets the connected edges of a path that are permitted (i.e. no 'no entry' signs)
  */
@@ -551,6 +559,246 @@ static bool path_is_thin_junction(PathElement* path, const TileCoordsXYZ& loc)
     return thin_junction;
 }
 
+/**
+ * What the heuristic search needs to know about a tile element a peep could walk onto. The nodes for a tile are
+ * gathered once and reused by every search passing through it until the tile is invalidated, rather than scanning
+ * the tile elements, banners and neighbouring tiles again for each peep.
+ */
+struct PathfindNode
+{
+    uint16_t ElementIndex;
+    ride_id_t RideIndex;
+    uint8_t Type;
+    uint8_t BaseHeight;
+    Direction ElementDirection;
+    uint8_t EntranceType;
+    uint8_t Edges;
+    uint8_t ConnectedEdges;
+    uint8_t PermittedEdges;
+    Direction SlopeDirection;
+    bool IsSloped;
+    bool IsWide;
+    bool IsQueue;
+    bool IsThinJunction;
+
+    bool operator==(const PathfindNode& other) const
+    {
+        return std::memcmp(this, &other, sizeof(PathfindNode)) == 0;
+    }
+};
+
+struct PathfindGraphTile
+{
+    uint32_t Generation;
+    uint16_t ElementCount;
+    std::vector<PathfindNode> Nodes;
+};
+
+static std::vector<PathfindGraphTile> _pathfindGraph;
+static uint32_t _pathfindGraphGeneration = 1;
+
+/**
+ * Guests at the same place heading for the same goal pick the same edge, as long as the map has not changed and they
+ * remember the same junctions. The edge chosen for each such combination is kept, so crowds walking to the same
+ * ride or park exit only search once per junction.
+ */
+struct PathfindEdgeKey
+{
+    TileCoordsXYZ Location;
+    TileCoordsXYZ Goal;
+    std::array<rct12_xyzd8, 4> History;
+    ride_id_t QueueRideIndex;
+    uint8_t Edges;
+    uint8_t MaxJunctions;
+    bool IgnoreForeignQueues;
+
+    bool operator==(const PathfindEdgeKey& other) const
+    {
+        return Location == other.Location && Goal == other.Goal && QueueRideIndex == other.QueueRideIndex
+            && Edges == other.Edges && MaxJunctions == other.MaxJunctions && IgnoreForeignQueues == other.IgnoreForeignQueues
+            && std::memcmp(History.data(), other.History.data(), sizeof(History)) == 0;
+    }
+};
+
+struct PathfindEdgeKeyHash
+{
+    size_t operator()(const PathfindEdgeKey& key) const
+    {
+        size_t hash = 0;
+        auto combine = [&hash](size_t value) { hash ^= value + 0x9E3779B9 + (hash << 6) + (hash >> 2); };
+        combine((key.Location.x << 16) ^ (key.Location.y << 8) ^ key.Location.z);
+        combine((key.Goal.x << 16) ^ (key.Goal.y << 8) ^ key.Goal.z);
+        for (const auto& junction : key.History)
+        {
+            combine((static_cast<size_t>(junction.x) << 24) | (junction.y << 16) | (junction.z << 8) | junction.direction);
+        }
+        combine((key.QueueRideIndex << 16) | (key.Edges << 8) | (key.MaxJunctions << 1) | key.IgnoreForeignQueues);
+        return hash;
+    }
+};
+
+static constexpr size_t PathfindEdgeCacheMaxSize = 32768;
+static std::unordered_map<PathfindEdgeKey, Direction, PathfindEdgeKeyHash> _pathfindEdgeCache;
+
+static uint16_t pathfind_graph_count_elements(const TileCoordsXY& loc)
+{
+    const TileElement* tileElement = map_get_first_element_at(loc.ToCoordsXY());
+    if (tileElement == nullptr)
+        return 0;
+
+    uint16_t count = 1;
+    while (!(tileElement++)->IsLastForTile())
+    {
+        count++;
+    }
+    return count;
+}
+
+static void pathfind_graph_build_tile(const TileCoordsXY& loc, std::vector<PathfindNode>& nodes)
+{
+    nodes.clear();
+
+    TileElement* const firstTileElement = map_get_first_element_at(loc.ToCoordsXY());
+    if (firstTileElement == nullptr)
+        return;
+
+    TileElement* tileElement = firstTileElement;
+    do
+    {
+        if (tileElement->IsGhost())
+            continue;
+
+        PathfindNode node{};
+        node.ElementIndex = static_cast<uint16_t>(tileElement - firstTileElement);
+        node.RideIndex = RIDE_ID_NULL;
+        node.Type = tileElement->GetType();
+        node.BaseHeight = tileElement->base_height;
+        switch (node.Type)
+        {
+            case TILE_ELEMENT_TYPE_TRACK:
+                node.RideIndex = tileElement->AsTrack()->GetRideIndex();
+                break;
+            case TILE_ELEMENT_TYPE_ENTRANCE:
+                node.RideIndex = tileElement->AsEntrance()->GetRideIndex();
+                node.ElementDirection = tileElement->GetDirection();
+                node.EntranceType = tileElement->AsEntrance()->GetEntranceType();
+                break;
+            case TILE_ELEMENT_TYPE_PATH:
+            {
+                auto* pathElement = tileElement->AsPath();
+                node.RideIndex = pathElement->GetRideIndex();
+                node.Edges = pathElement->GetEdges();
+                node.ConnectedEdges = pathElement->GetEdgesAndCorners() & 0x0F;
+                node.PermittedEdges = banner_clear_path_edges_for_guests(pathElement, pathElement->GetEdgesAndCorners()) & 0x0F;
+                node.IsSloped = pathElement->IsSloped();
+                node.SlopeDirection = pathElement->GetSlopeDirection();
+                node.IsWide = pathElement->IsWide();
+                node.IsQueue = pathElement->IsQueue();
+                node.IsThinJunction = bitcount(node.Edges) > 2
+                    && path_is_thin_junction(pathElement, { loc.x, loc.y, tileElement->base_height });
+                break;
+            }
+            default:
+                continue;
+        }
+        nodes.push_back(node);
+    } while (!(tileElement++)->IsLastForTile());
+}
+
+static const std::vector<PathfindNode>* pathfind_graph_get_tile(const TileCoordsXY& loc)
+{
+    if (loc.x < 0 || loc.y < 0 || loc.x >= MAXIMUM_MAP_SIZE_TECHNICAL || loc.y >= MAXIMUM_MAP_SIZE_TECHNICAL)
+        return nullptr;
+
+    if (_pathfindGraph.empty())
+    {
+        _pathfindGraph.resize(MAXIMUM_MAP_SIZE_TECHNICAL * MAXIMUM_MAP_SIZE_TECHNICAL);
+    }
+
+    // Inserting an element always invalidates its tile, but removing one (scenery, walls) only shifts the indices of the
+    // elements above it, so a different count also means the nodes are out of date.
+    auto& tile = _pathfindGraph[loc.y * MAXIMUM_MAP_SIZE_TECHNICAL + loc.x];
+    auto elementCount = pathfind_graph_count_elements(loc);
+    if (tile.Generation != _pathfindGraphGeneration || tile.ElementCount != elementCount)
+    {
+        pathfind_graph_build_tile(loc, tile.Nodes);
+        tile.Generation = _pathfindGraphGeneration;
+        tile.ElementCount = elementCount;
+    }
+#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+    else
+    {
+        // A mismatch means the tile was changed without invalidating the graph, which would desync network games
+        std::vector<PathfindNode> nodes;
+        pathfind_graph_build_tile(loc, nodes);
+        if (nodes != tile.Nodes)
+        {
+            log_error("Pathfinding graph for tile %d,%d is out of date.", loc.x, loc.y);
+            tile.Nodes = std::move(nodes);
+        }
+    }
+#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+    return &tile.Nodes;
+}
+
+void pathfind_graph_invalidate(const CoordsXY& coords)
+{
+    _pathfindEdgeCache.clear();
+    if (_pathfindGraph.empty())
+        return;
+
+    // Whether a path is a thin junction depends on the paths on the neighbouring tiles
+    auto loc = TileCoordsXY(coords);
+    for (const auto& offset : { TileCoordsXY{ 0, 0 }, TileCoordsXY{ -1, 0 }, TileCoordsXY{ 0, 1 }, TileCoordsXY{ 1, 0 },
+                                TileCoordsXY{ 0, -1 } })
+    {
+        auto tile = loc + offset;
+        if (tile.x >= 0 && tile.y >= 0 && tile.x < MAXIMUM_MAP_SIZE_TECHNICAL && tile.y < MAXIMUM_MAP_SIZE_TECHNICAL)
+        {
+            _pathfindGraph[tile.y * MAXIMUM_MAP_SIZE_TECHNICAL + tile.x].Generation = 0;
+        }
+    }
+}
+
+void pathfind_graph_reset()
+{
+    _pathfindEdgeCache.clear();
+    _pathfindGraphGeneration++;
+    if (_pathfindGraphGeneration == 0)
+    {
+        // Generation 0 marks an invalidated tile, start again rather than wrapping around onto it
+        _pathfindGraph.clear();
+        _pathfindGraphGeneration = 1;
+    }
+}
+
+static bool IsValidPathZAndDirection(const PathfindNode& node, int32_t currentZ, int32_t currentDirection)
+{
+    if (node.IsSloped)
+    {
+        int32_t slopeDirection = node.SlopeDirection;
+        if (slopeDirection == currentDirection)
+        {
+            if (currentZ != node.BaseHeight)
+                return false;
+        }
+        else
+        {
+            slopeDirection = direction_reverse(slopeDirection);
+            if (slopeDirection != currentDirection)
+                return false;
+            if (currentZ != node.BaseHeight + 2)
+                return false;
+        }
+    }
+    else
+    {
+        if (currentZ != node.BaseHeight)
+            return false;
+    }
+    return true;
+}
+
 static int32_t CalculateHeuristicPathingScore(const TileCoordsXYZ& loc1, const TileCoordsXYZ& loc2)
 {
     auto xDelta = abs(loc1.x - loc2.x) * 32;
@@ -734,29 +982,29 @@ static void peep_pathfind_heuristic_search(
 
     /* Get the next map element of interest in the direction of test_edge. */
     bool found = false;
-    TileElement* tileElement = map_get_first_element_at(loc.ToCoordsXY());
-    if (tileElement == nullptr)
+    const auto* tileNodes = pathfind_graph_get_tile(TileCoordsXY{ loc.x, loc.y });
+    if (tileNodes == nullptr)
     {
         return;
     }
-    do
+    TileElement* const firstTileElement = map_get_first_element_at(loc.ToCoordsXY());
+    for (const auto& node : *tileNodes)
     {
         /* Look for all map elements that the peep could walk onto while
-         * navigating to the goal, including the goal tile. */
-
-        if (tileElement->IsGhost())
-            continue;
+         * navigating to the goal, including the goal tile.
+         * Ghost elements are already left out of the graph. */
+        TileElement* const tileElement = firstTileElement + node.ElementIndex;
 
         ride_id_t rideIndex = RIDE_ID_NULL;
-        switch (tileElement->GetType())
+        switch (node.Type)
         {
             case TILE_ELEMENT_TYPE_TRACK:
             {
-                if (loc.z != tileElement->base_height)
+                if (loc.z != node.BaseHeight)
                     continue;
                 /* For peeps heading for a shop, the goal is the shop
                  * tile. */
-                rideIndex = tileElement->AsTrack()->GetRideIndex();
+                rideIndex = node.RideIndex;
                 auto ride = get_ride(rideIndex);
                 if (ride == nullptr || !ride->GetRideTypeDescriptor().HasFlag(RIDE_TYPE_FLAG_IS_SHOP))
                     continue;
@@ -766,11 +1014,11 @@ static void peep_pathfind_heuristic_search(
                 break;
             }
             case TILE_ELEMENT_TYPE_ENTRANCE:
-                if (loc.z != tileElement->base_height)
+                if (loc.z != node.BaseHeight)
                     continue;
                 Direction direction;
                 searchResult = PATH_SEARCH_OTHER;
-                switch (tileElement->AsEntrance()->GetEntranceType())
+                switch (node.EntranceType)
                 {
                     case ENTRANCE_TYPE_RIDE_ENTRANCE:
                         /* For peeps heading for a ride without a queue, the
@@ -778,12 +1026,12 @@ static void peep_pathfind_heuristic_search(
                          * For mechanics heading for the ride entrance
                          * (in the case when the station has no exit),
                          * the goal is the ride entrance tile. */
-                        direction = tileElement->GetDirection();
+                        direction = node.ElementDirection;
                         if (direction == test_edge)
                         {
                             /* The rideIndex will be useful for
                              * adding transport rides later. */
-                            rideIndex = tileElement->AsEntrance()->GetRideIndex();
+                            rideIndex = node.RideIndex;
                             searchResult = PATH_SEARCH_RIDE_ENTRANCE;
                             found = true;
                             break;
@@ -798,7 +1046,7 @@ static void peep_pathfind_heuristic_search(
                     case ENTRANCE_TYPE_RIDE_EXIT:
                         /* For mechanics heading for the ride exit, the
                          * goal is the ride exit tile. */
-                        direction = tileElement->GetDirection();
+                        direction = node.ElementDirection;
                         if (direction == test_edge)
                         {
                             searchResult = PATH_SEARCH_RIDE_EXIT;
@@ -816,13 +1064,13 @@ static void peep_pathfind_heuristic_search(
                  * queue path.
                  * Otherwise, peeps walk on path tiles to get to the goal. */
 
-                if (!IsValidPathZAndDirection(tileElement, loc.z, test_edge))
+                if (!IsValidPathZAndDirection(node, loc.z, test_edge))
                     continue;
 
                 // Path may be sloped, so set z to path base height.
-                loc.z = tileElement->base_height;
+                loc.z = node.BaseHeight;
 
-                if (tileElement->AsPath()->IsWide())
+                if (node.IsWide)
                 {
                     /* Check if staff can ignore this wide flag. */
                     if (staff == nullptr || !staff->CanIgnoreWideFlag(loc.ToCoordsXYZ(), tileElement))
@@ -835,7 +1083,7 @@ static void peep_pathfind_heuristic_search(
 
                 searchResult = PATH_SEARCH_THIN;
 
-                uint8_t numEdges = bitcount(tileElement->AsPath()->GetEdges());
+                uint8_t numEdges = bitcount(node.Edges);
 
                 if (numEdges < 2)
                 {
@@ -847,15 +1095,14 @@ static void peep_pathfind_heuristic_search(
                 }
                 else
                 { // numEdges == 2
-                    if (tileElement->AsPath()->IsQueue()
-                        && tileElement->AsPath()->GetRideIndex() != gPeepPathFindQueueRideIndex)
+                    if (node.IsQueue && node.RideIndex != gPeepPathFindQueueRideIndex)
                     {
-                        if (gPeepPathFindIgnoreForeignQueues && (tileElement->AsPath()->GetRideIndex() != RIDE_ID_NULL))
+                        if (gPeepPathFindIgnoreForeignQueues && (node.RideIndex != RIDE_ID_NULL))
                         {
                             // Path is a queue we aren't interested in
                             /* The rideIndex will be useful for
                              * adding transport rides later. */
-                            rideIndex = tileElement->AsPath()->GetRideIndex();
+                            rideIndex = node.RideIndex;
                             searchResult = PATH_SEARCH_RIDE_QUEUE;
                         }
                     }
@@ -984,8 +1231,7 @@ static void peep_pathfind_heuristic_search(
         /* At this point the map element is a non-wide path.*/
 
         /* Get all the permitted_edges of the map element. */
-        Guard::Assert(tileElement->AsPath() != nullptr);
-        uint8_t edges = path_get_permitted_edges(tileElement->AsPath());
+        uint8_t edges = _peepPathFindIsStaff ? node.ConnectedEdges : node.PermittedEdges;
 
 #if defined(DEBUG_LEVEL_2) && DEBUG_LEVEL_2
         if (gPathFindDebug)
@@ -1056,7 +1302,7 @@ static void peep_pathfind_heuristic_search(
         {
             /* Check if this is a thin junction. And perform additional
              * necessary checks. */
-            thin_junction = path_is_thin_junction(tileElement->AsPath(), loc);
+            thin_junction = node.IsThinJunction;
 
             if (thin_junction)
             {
@@ -1180,7 +1426,7 @@ static void peep_pathfind_heuristic_search(
             uint8_t savedNumJunctions = _peepPathFindNumJunctions;
 
             uint8_t height = loc.z;
-            if (tileElement->AsPath()->IsSloped() && tileElement->AsPath()->GetSlopeDirection() == next_test_edge)
+            if (node.IsSloped && node.SlopeDirection == next_test_edge)
             {
                 height += 2;
             }
@@ -1227,8 +1473,7 @@ static void peep_pathfind_heuristic_search(
             }
 #endif // defined(DEBUG_LEVEL_2) && DEBUG_LEVEL_2
         } while ((next_test_edge = bitscanforward(edges)) != -1);
-
-    } while (!(tileElement++)->IsLastForTile());
+    }
 
     if (!found)
     {
@@ -1252,6 +1497,212 @@ static void peep_pathfind_heuristic_search(
     }
 }
 
+/**
+ * Runs the heuristic search down each of the given edges and returns the edge leading closest to the goal, or
+ * INVALID_DIRECTION if the search failed on all of them.
+ */
+static Direction peep_pathfind_choose_edge(
+    const TileCoordsXYZ& loc, Peep* peep, TileElement* first_tile_element, uint8_t edges, int32_t maxTilesChecked)
+{
+    [[maybe_unused]] const TileCoordsXYZ& goal = gPeepPathFindGoalPosition;
+    int32_t chosen_edge = bitscanforward(edges);
+
+    uint16_t best_score = 0xFFFF;
+    uint8_t best_sub = 0xFF;
+
+#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+    uint8_t bestJunctions = 0;
+    TileCoordsXYZ bestJunctionList[16];
+    uint8_t bestDirectionList[16];
+    TileCoordsXYZ bestXYZ;
+
+    if (_pathFindDebug)
+    {
+        log_verbose("Pathfind start for goal %d,%d,%d from %d,%d,%d", goal.x, goal.y, goal.z, loc.x, loc.y, loc.z);
+    }
+#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+
+    /* Call the search heuristic on each edge, keeping track of the
+     * edge that gives the best (i.e. smallest) value (best_score)
+     * or for different edges with equal value, the edge with the
+     * least steps (best_sub). */
+    int32_t numEdges = bitcount(edges);
+    for (int32_t test_edge = chosen_edge; test_edge != -1; test_edge = bitscanforward(edges))
+    {
+        edges &= ~(1 << test_edge);
+        uint8_t height = loc.z;
+
+        if (first_tile_element->AsPath()->IsSloped() && first_tile_element->AsPath()->GetSlopeDirection() == test_edge)
+        {
+            height += 0x2;
+        }
+
+        _peepPathFindFewestNumSteps = 255;
+        /* Divide the maxTilesChecked global search limit
+         * between the remaining edges to ensure the search
+         * covers all of the remaining edges. */
+        _peepPathFindTilesChecked = maxTilesChecked / numEdges;
+        _peepPathFindNumJunctions = _peepPathFindMaxJunctions;
+
+        // Initialise _peepPathFindHistory.
+        std::memset(static_cast<void*>(_peepPathFindHistory), 0xFF, sizeof(_peepPathFindHistory));
+
+        /* The pathfinding will only use elements
+         * 1.._peepPathFindMaxJunctions, so the starting point
+         * is placed in element 0 */
+        _peepPathFindHistory[0].location.x = static_cast<uint8_t>(loc.x);
+        _peepPathFindHistory[0].location.y = static_cast<uint8_t>(loc.y);
+        _peepPathFindHistory[0].location.z = loc.z;
+        _peepPathFindHistory[0].direction = 0xF;
+
+        uint16_t score = 0xFFFF;
+        /* Variable endXYZ contains the end location of the
+         * search path. */
+        TileCoordsXYZ endXYZ;
+        endXYZ.x = 0;
+        endXYZ.y = 0;
+        endXYZ.z = 0;
+
+        uint8_t endSteps = 255;
+
+        /* Variable endJunctions is the number of junctions
+         * passed through in the search path.
+         * Variables endJunctionList and endDirectionList
+         * contain the junctions and corresponding directions
+         * of the search path.
+         * In the future these could be used to visualise the
+         * pathfinding on the map. */
+        uint8_t endJunctions = 0;
+        TileCoordsXYZ endJunctionList[16];
+        uint8_t endDirectionList[16] = { 0 };
+
+        bool inPatrolArea = false;
+        auto* staff = peep->As<Staff>();
+        if (staff != nullptr && staff->IsMechanic())
+        {
+            /* Mechanics are the only staff type that
+             * pathfind to a destination. Determine if the
+             * mechanic is in their patrol area. */
+            inPatrolArea = staff->IsLocationInPatrol(peep->NextLoc);
+        }
+
+#if defined(DEBUG_LEVEL_2) && DEBUG_LEVEL_2
+        if (gPathFindDebug)
+        {
+            log_verbose("Pathfind searching in direction: %d from %d,%d,%d", test_edge, loc.x >> 5, loc.y >> 5, loc.z);
+        }
+#endif // defined(DEBUG_LEVEL_2) && DEBUG_LEVEL_2
+
+        peep_pathfind_heuristic_search(
+            { loc.x, loc.y, height }, peep, first_tile_element, inPatrolArea, 0, &score, test_edge, &endJunctions,
+            endJunctionList, endDirectionList, &endXYZ, &endSteps);
+
+#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+        if (_pathFindDebug)
+        {
+            log_verbose(
+                "Pathfind test edge: %d score: %d steps: %d end: %d,%d,%d junctions: %d", test_edge, score, endSteps,
+                endXYZ.x, endXYZ.y, endXYZ.z, endJunctions);
+            for (uint8_t listIdx = 0; listIdx < endJunctions; listIdx++)
+            {
+                log_info(
+                    "Junction#%d %d,%d,%d Direction %d", listIdx + 1, endJunctionList[listIdx].x,
+                    endJunctionList[listIdx].y, endJunctionList[listIdx].z, endDirectionList[listIdx]);
+            }
+        }
+#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+
+        if (score < best_score || (score == best_score && endSteps < best_sub))
+        {
+            chosen_edge = test_edge;
+            best_score = score;
+            best_sub = endSteps;
+#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+            bestJunctions = endJunctions;
+            for (uint8_t index = 0; index < endJunctions; index++)
+            {
+                bestJunctionList[index].x = endJunctionList[index].x;
+                bestJunctionList[index].y = endJunctionList[index].y;
+                bestJunctionList[index].z = endJunctionList[index].z;
+                bestDirectionList[index] = endDirectionList[index];
+            }
+            bestXYZ.x = endXYZ.x;
+            bestXYZ.y = endXYZ.y;
+            bestXYZ.z = endXYZ.z;
+#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+        }
+    }
+
+    /* Check if the heuristic search failed. e.g. all connected
+     * paths are within the search limits and none reaches the
+     * goal. */
+    if (best_score == 0xFFFF)
+    {
+#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+        if (_pathFindDebug)
+        {
+            log_verbose("Pathfind heuristic search failed.");
+        }
+#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+        return INVALID_DIRECTION;
+    }
+#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+    if (_pathFindDebug)
+    {
+        log_verbose("Pathfind best edge %d with score %d steps %d", chosen_edge, best_score, best_sub);
+        for (uint8_t listIdx = 0; listIdx < bestJunctions; listIdx++)
+        {
+            log_verbose(
+                "Junction#%d %d,%d,%d Direction %d", listIdx + 1, bestJunctionList[listIdx].x, bestJunctionList[listIdx].y,
+                bestJunctionList[listIdx].z, bestDirectionList[listIdx]);
+        }
+        log_verbose("End at %d,%d,%d", bestXYZ.x, bestXYZ.y, bestXYZ.z);
+    }
+#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+    return chosen_edge;
+}
+
+static Direction peep_pathfind_choose_edge_cached(
+    const TileCoordsXYZ& loc, Peep* peep, TileElement* first_tile_element, uint8_t edges, int32_t maxTilesChecked)
+{
+    // Staff searches also depend on their patrol area
+    if (_peepPathFindIsStaff)
+        return peep_pathfind_choose_edge(loc, peep, first_tile_element, edges, maxTilesChecked);
+#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+    if (_pathFindDebug)
+        return peep_pathfind_choose_edge(loc, peep, first_tile_element, edges, maxTilesChecked);
+#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+
+    PathfindEdgeKey key{ loc,
+                         gPeepPathFindGoalPosition,
+                         peep->PathfindHistory,
+                         gPeepPathFindQueueRideIndex,
+                         edges,
+                         static_cast<uint8_t>(_peepPathFindMaxJunctions),
+                         gPeepPathFindIgnoreForeignQueues };
+    auto it = _pathfindEdgeCache.find(key);
+    if (it != _pathfindEdgeCache.end())
+    {
+#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+        auto searchedEdge = peep_pathfind_choose_edge(loc, peep, first_tile_element, edges, maxTilesChecked);
+        if (searchedEdge != it->second)
+        {
+            log_error(
+                "Cached pathfinding edge %d at %d,%d,%d does not match searched edge %d.", it->second, loc.x, loc.y, loc.z,
+                searchedEdge);
+        }
+#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+        return it->second;
+    }
+
+    if (_pathfindEdgeCache.size() >= PathfindEdgeCacheMaxSize)
+    {
+        _pathfindEdgeCache.clear();
+    }
+    auto chosenEdge = peep_pathfind_choose_edge(loc, peep, first_tile_element, edges, maxTilesChecked);
+    _pathfindEdgeCache.emplace(key, chosenEdge);
+    return chosenEdge;
+}
 /**
  * Returns:
  *   -1   - no direction chosen
@@ -1428,158 +1879,9 @@ Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
     // Peep has multiple edges still to try.
     if (edges & ~(1 << chosen_edge))
     {
-        uint16_t best_score = 0xFFFF;
-        uint8_t best_sub = 0xFF;
-
-#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
-        uint8_t bestJunctions = 0;
-        TileCoordsXYZ bestJunctionList[16];
-        uint8_t bestDirectionList[16];
-        TileCoordsXYZ bestXYZ;
-
-        if (_pathFindDebug)
-        {
-            log_verbose("Pathfind start for goal %d,%d,%d from %d,%d,%d", goal.x, goal.y, goal.z, loc.x, loc.y, loc.z);
-        }
-#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
-
-        /* Call the search heuristic on each edge, keeping track of the
-         * edge that gives the best (i.e. smallest) value (best_score)
-         * or for different edges with equal value, the edge with the
-         * least steps (best_sub). */
-        int32_t numEdges = bitcount(edges);
-        for (int32_t test_edge = chosen_edge; test_edge != -1; test_edge = bitscanforward(edges))
-        {
-            edges &= ~(1 << test_edge);
-            uint8_t height = loc.z;
-
-            if (first_tile_element->AsPath()->IsSloped() && first_tile_element->AsPath()->GetSlopeDirection() == test_edge)
-            {
-                height += 0x2;
-            }
-
-            _peepPathFindFewestNumSteps = 255;
-            /* Divide the maxTilesChecked global search limit
-             * between the remaining edges to ensure the search
-             * covers all of the remaining edges. */
-            _peepPathFindTilesChecked = maxTilesChecked / numEdges;
-            _peepPathFindNumJunctions = _peepPathFindMaxJunctions;
-
-            // Initialise _peepPathFindHistory.
-            std::memset(static_cast<void*>(_peepPathFindHistory), 0xFF, sizeof(_peepPathFindHistory));
-
-            /* The pathfinding will only use elements
-             * 1.._peepPathFindMaxJunctions, so the starting point
-             * is placed in element 0 */
-            _peepPathFindHistory[0].location.x = static_cast<uint8_t>(loc.x);
-            _peepPathFindHistory[0].location.y = static_cast<uint8_t>(loc.y);
-            _peepPathFindHistory[0].location.z = loc.z;
-            _peepPathFindHistory[0].direction = 0xF;
-
-            uint16_t score = 0xFFFF;
-            /* Variable endXYZ contains the end location of the
-             * search path. */
-            TileCoordsXYZ endXYZ;
-            endXYZ.x = 0;
-            endXYZ.y = 0;
-            endXYZ.z = 0;
-
-            uint8_t endSteps = 255;
-
-            /* Variable endJunctions is the number of junctions
-             * passed through in the search path.
-             * Variables endJunctionList and endDirectionList
-             * contain the junctions and corresponding directions
-             * of the search path.
-             * In the future these could be used to visualise the
-             * pathfinding on the map. */
-            uint8_t endJunctions = 0;
-            TileCoordsXYZ endJunctionList[16];
-            uint8_t endDirectionList[16] = { 0 };
-
-            bool inPatrolArea = false;
-            auto* staff = peep->As<Staff>();
-            if (staff != nullptr && staff->IsMechanic())
-            {
-                /* Mechanics are the only staff type that
-                 * pathfind to a destination. Determine if the
-                 * mechanic is in their patrol area. */
-                inPatrolArea = staff->IsLocationInPatrol(peep->NextLoc);
-            }
-
-#if defined(DEBUG_LEVEL_2) && DEBUG_LEVEL_2
-            if (gPathFindDebug)
-            {
-                log_verbose("Pathfind searching in direction: %d from %d,%d,%d", test_edge, loc.x >> 5, loc.y >> 5, loc.z);
-            }
-#endif // defined(DEBUG_LEVEL_2) && DEBUG_LEVEL_2
-
-            peep_pathfind_heuristic_search(
-                { loc.x, loc.y, height }, peep, first_tile_element, inPatrolArea, 0, &score, test_edge, &endJunctions,
-                endJunctionList, endDirectionList, &endXYZ, &endSteps);
-
-#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
-            if (_pathFindDebug)
-            {
-                log_verbose(
-                    "Pathfind test edge: %d score: %d steps: %d end: %d,%d,%d junctions: %d", test_edge, score, endSteps,
-                    endXYZ.x, endXYZ.y, endXYZ.z, endJunctions);
-                for (uint8_t listIdx = 0; listIdx < endJunctions; listIdx++)
-                {
-                    log_info(
-                        "Junction#%d %d,%d,%d Direction %d", listIdx + 1, endJunctionList[listIdx].x,
-                        endJunctionList[listIdx].y, endJunctionList[listIdx].z, endDirectionList[listIdx]);
-                }
-            }
-#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
-
-            if (score < best_score || (score == best_score && endSteps < best_sub))
-            {
-                chosen_edge = test_edge;
-                best_score = score;
-                best_sub = endSteps;
-#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
-                bestJunctions = endJunctions;
-                for (uint8_t index = 0; index < endJunctions; index++)
-                {
-                    bestJunctionList[index].x = endJunctionList[index].x;
-                    bestJunctionList[index].y = endJunctionList[index].y;
-                    bestJunctionList[index].z = endJunctionList[index].z;
-                    bestDirectionList[index] = endDirectionList[index];
-                }
-                bestXYZ.x = endXYZ.x;
-                bestXYZ.y = endXYZ.y;
-                bestXYZ.z = endXYZ.z;
-#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
-            }
-        }
-
-        /* Check if the heuristic search failed. e.g. all connected
-         * paths are within the search limits and none reaches the
-         * goal. */
-        if (best_score == 0xFFFF)
-        {
-#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
-            if (_pathFindDebug)
-            {
-                log_verbose("Pathfind heuristic search failed.");
-            }
-#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+        chosen_edge = peep_pathfind_choose_edge_cached(loc, peep, first_tile_element, edges, maxTilesChecked);
+        if (chosen_edge == INVALID_DIRECTION)
             return INVALID_DIRECTION;
-        }
-#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
-        if (_pathFindDebug)
-        {
-            log_verbose("Pathfind best edge %d with score %d steps %d", chosen_edge, best_score, best_sub);
-            for (uint8_t listIdx = 0; listIdx < bestJunctions; listIdx++)
-            {
-                log_verbose(
-                    "Junction#%d %d,%d,%d Direction %d", listIdx + 1, bestJunctionList[listIdx].x, bestJunctionList[listIdx].y,
-                    bestJunctionList[listIdx].z, bestDirectionList[listIdx]);
-            }
-            log_verbose("End at %d,%d,%d", bestXYZ.x, bestXYZ.y, bestXYZ.z);
-        }
-#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
     }
 
     if (isThin)
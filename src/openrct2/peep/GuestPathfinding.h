@@ -51,6 +51,11 @@ bool IsValidPathZAndDirection(TileElement* tileElement, int32_t currentZ, int32_
 // Returns 0 if the guest has successfully had a new destination set up, nonzero otherwise.
 int32_t guest_path_finding(Guest* peep);
 
+// The heuristic search reads footpaths, entrances and shops through a graph cached per tile. Executing a game action
+// resets the whole graph; any other change to those elements must invalidate the tile it was made on.
+void pathfind_graph_invalidate(const CoordsXY& coords);
+void pathfind_graph_reset();
+
 #if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
 #    define PATHFIND_DEBUG                                                                                                     \
         0 // Set to 0 to disable pathfinding debugging;
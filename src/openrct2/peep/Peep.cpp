@@ -202,6 +202,11 @@ void peep_update_all()
     if (gScreenFlags & SCREEN_FLAGS_EDITOR)
         return;
 
+    if (gConfigGeneral.multithreading)
+    {
+        guest_thinking_prefetch();
+    }
+
     int32_t i = 0;
     // Warning this loop can delete peeps
     for (auto peep : EntityList<Guest>())
@@ -222,6 +227,7 @@ void peep_update_all()
 
         i++;
     }
+    guest_thinking_prefetch_clear();
 
     for (auto staff : EntityList<Staff>())
     {
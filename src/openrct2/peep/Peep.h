@@ -998,6 +998,8 @@ extern uint8_t gPeepWarningThrottle[16];
 
 int32_t peep_get_staff_count();
 void peep_update_all();
+void guest_thinking_prefetch();
+void guest_thinking_prefetch_clear();
 void peep_problem_warnings_update();
 void peep_stop_crowd_noise();
 void peep_update_crowd_noise();
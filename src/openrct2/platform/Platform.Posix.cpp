@@ -131,7 +131,7 @@ namespace Platform
             size_t readBytes;
             while ((readBytes = fread(buffer, 1, sizeof(buffer), fpipe)) > 0)
             {
-                outputBuffer.insert(outputBuffer.begin(), buffer, buffer + readBytes);
+                outputBuffer.insert(outputBuffer.end(), buffer, buffer + readBytes);
             }
 
             // Trim line breaks
@@ -12,9 +12,6 @@
 #include "../core/IStream.hpp"
 #include "../util/SawyerCoding.h"
 
-// Maximum buffer size to store compressed data, maximum of 16 MiB
-constexpr size_t MAX_COMPRESSED_CHUNK_SIZE = 16 * 1024 * 1024;
-
 SawyerChunkWriter::SawyerChunkWriter(OpenRCT2::IStream* stream)
     : _stream(stream)
 {
@@ -26,15 +23,26 @@ void SawyerChunkWriter::WriteChunk(const SawyerChunk* chunk)
 }
 
 void SawyerChunkWriter::WriteChunk(const void* src, size_t length, SAWYER_ENCODING encoding)
+{
+    WriteEncodedChunk(EncodeChunk(src, length, encoding));
+}
+
+std::vector<uint8_t> SawyerChunkWriter::EncodeChunk(const void* src, size_t length, SAWYER_ENCODING encoding)
 {
     sawyercoding_chunk_header header;
     header.encoding = static_cast<uint8_t>(encoding);
     header.length = static_cast<uint32_t>(length);
 
-    auto data = std::make_unique<uint8_t[]>(MAX_COMPRESSED_CHUNK_SIZE);
+    // Not value initialised, the encoder writes every byte it returns
+    auto data = std::unique_ptr<uint8_t[]>(new uint8_t[sawyercoding_get_max_chunk_buffer_length(length, header.encoding)]);
     size_t dataLength = sawyercoding_write_chunk_buffer(data.get(), static_cast<const uint8_t*>(src), header);
 
-    _stream->Write(data.get(), dataLength);
+    return std::vector<uint8_t>(data.get(), data.get() + dataLength);
+}
+
+void SawyerChunkWriter::WriteEncodedChunk(const std::vector<uint8_t>& encodedChunk)
+{
+    _stream->Write(encodedChunk.data(), encodedChunk.size());
 }
 
 /**
@@ -91,7 +99,7 @@ static size_t EncodeChunkRLE(const uint8_t* src_buffer, uint8_t* dst_buffer, siz
 
 void SawyerChunkWriter::WriteChunkTrack(const void* src, size_t length)
 {
-    auto data = std::make_unique<uint8_t[]>(MAX_COMPRESSED_CHUNK_SIZE);
+    auto data = std::unique_ptr<uint8_t[]>(new uint8_t[sawyercoding_get_max_rle_length(length)]);
     size_t dataLength = EncodeChunkRLE(static_cast<const uint8_t*>(src), data.get(), length);
 
     uint32_t checksum = 0;
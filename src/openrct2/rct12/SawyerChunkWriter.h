@@ -13,6 +13,7 @@
 #include "SawyerChunk.h"
 
 #include <memory>
+#include <vector>
 
 namespace OpenRCT2
 {
@@ -43,6 +44,19 @@ public:
      */
     void WriteChunk(const void* src, size_t length, SAWYER_ENCODING encoding);
 
+    /**
+     * Encodes a chunk containing the given buffer without writing it. Chunks do not depend on each other, so several
+     * chunks can be encoded at the same time and then written in order with WriteEncodedChunk.
+     * @param src The source buffer.
+     * @param length The size of the source buffer.
+     */
+    static std::vector<uint8_t> EncodeChunk(const void* src, size_t length, SAWYER_ENCODING encoding);
+
+    /**
+     * Writes a chunk returned by EncodeChunk to the stream.
+     */
+    void WriteEncodedChunk(const std::vector<uint8_t>& encodedChunk);
+
     /**
      * Writes a track chunk to the stream containing the given buffer.
      * @param src The source buffer.
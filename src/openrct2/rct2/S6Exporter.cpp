@@ -17,6 +17,8 @@
 #include "../config/Config.h"
 #include "../core/FileStream.h"
 #include "../core/IStream.hpp"
+#include "../core/JobPool.h"
+#include "../core/MemoryStream.h"
 #include "../core/String.hpp"
 #include "../interface/Viewport.h"
 #include "../interface/Window.h"
@@ -71,7 +73,14 @@ S6Exporter::S6Exporter()
 void S6Exporter::SaveGame(const utf8* path)
 {
     auto fs = OpenRCT2::FileStream(path, OpenRCT2::FILE_MODE_WRITE);
-    SaveGame(&fs);
+    if (ParkFileReader::ExtensionIsParkFile(path))
+    {
+        SaveParkFile(&fs, false);
+    }
+    else
+    {
+        SaveGame(&fs);
+    }
 }
 
 void S6Exporter::SaveGame(OpenRCT2::IStream* stream)
@@ -82,7 +91,14 @@ void S6Exporter::SaveGame(OpenRCT2::IStream* stream)
 void S6Exporter::SaveScenario(const utf8* path)
 {
     auto fs = OpenRCT2::FileStream(path, OpenRCT2::FILE_MODE_WRITE);
-    SaveScenario(&fs);
+    if (ParkFileReader::ExtensionIsParkFile(path))
+    {
+        SaveParkFile(&fs, true);
+    }
+    else
+    {
+        SaveScenario(&fs);
+    }
 }
 
 void S6Exporter::SaveScenario(OpenRCT2::IStream* stream)
@@ -90,7 +106,7 @@ void S6Exporter::SaveScenario(OpenRCT2::IStream* stream)
     Save(stream, true);
 }
 
-void S6Exporter::Save(OpenRCT2::IStream* stream, bool isScenario)
+void S6Exporter::ExportHeader(bool isScenario)
 {
     _s6.header.type = isScenario ? S6_TYPE_SCENARIO : S6_TYPE_SAVEDGAME;
     _s6.header.classic_flag = 0;
@@ -98,50 +114,86 @@ void S6Exporter::Save(OpenRCT2::IStream* stream, bool isScenario)
     _s6.header.version = S6_RCT2_VERSION;
     _s6.header.magic_number = S6_MAGIC_NUMBER;
     _s6.game_version_number = 201028;
+}
 
-    auto chunkWriter = SawyerChunkWriter(stream);
+void S6Exporter::Save(OpenRCT2::IStream* stream, bool isScenario)
+{
+    ExportHeader(isScenario);
 
-    // 0: Write header chunk
-    chunkWriter.WriteChunk(&_s6.header, SAWYER_ENCODING::ROTATE);
+    struct ChunkSource
+    {
+        const void* Data;
+        size_t Length;
+        SAWYER_ENCODING Encoding;
+    };
+    std::vector<ChunkSource> chunks;
+
+    // 0: Header chunk
+    chunks.push_back({ &_s6.header, sizeof(_s6.header), SAWYER_ENCODING::ROTATE });
 
-    // 1: Write scenario info chunk
+    // 1: Scenario info chunk
     if (_s6.header.type == S6_TYPE_SCENARIO)
     {
-        chunkWriter.WriteChunk(&_s6.info, SAWYER_ENCODING::ROTATE);
+        chunks.push_back({ &_s6.info, sizeof(_s6.info), SAWYER_ENCODING::ROTATE });
     }
 
-    // 2: Write packed objects
-    if (_s6.header.num_packed_objects > 0)
-    {
-        auto& objRepo = OpenRCT2::GetContext()->GetObjectRepository();
-        objRepo.WritePackedObjects(stream, ExportObjectsList);
-    }
+    // 2: Packed objects are written after the chunks above
+    const size_t numChunksBeforeObjects = chunks.size();
 
-    // 3: Write available objects chunk
-    chunkWriter.WriteChunk(_s6.objects, sizeof(_s6.objects), SAWYER_ENCODING::ROTATE);
+    // 3: Available objects chunk
+    chunks.push_back({ _s6.objects, sizeof(_s6.objects), SAWYER_ENCODING::ROTATE });
 
     // 4: Misc fields (data, rand...) chunk
-    chunkWriter.WriteChunk(&_s6.elapsed_months, 16, SAWYER_ENCODING::RLECOMPRESSED);
+    chunks.push_back({ &_s6.elapsed_months, 16, SAWYER_ENCODING::RLECOMPRESSED });
 
     // 5: Map elements + sprites and other fields chunk
-    chunkWriter.WriteChunk(&_s6.tile_elements, 0x180000, SAWYER_ENCODING::RLECOMPRESSED);
+    chunks.push_back({ &_s6.tile_elements, 0x180000, SAWYER_ENCODING::RLECOMPRESSED });
 
     if (_s6.header.type == S6_TYPE_SCENARIO)
     {
         // 6 to 13:
-        chunkWriter.WriteChunk(&_s6.next_free_tile_element_pointer_index, 0x27104C, SAWYER_ENCODING::RLECOMPRESSED);
-        chunkWriter.WriteChunk(&_s6.guests_in_park, 4, SAWYER_ENCODING::RLECOMPRESSED);
-        chunkWriter.WriteChunk(&_s6.last_guests_in_park, 8, SAWYER_ENCODING::RLECOMPRESSED);
-        chunkWriter.WriteChunk(&_s6.park_rating, 2, SAWYER_ENCODING::RLECOMPRESSED);
-        chunkWriter.WriteChunk(&_s6.active_research_types, 1082, SAWYER_ENCODING::RLECOMPRESSED);
-        chunkWriter.WriteChunk(&_s6.current_expenditure, 16, SAWYER_ENCODING::RLECOMPRESSED);
-        chunkWriter.WriteChunk(&_s6.park_value, 4, SAWYER_ENCODING::RLECOMPRESSED);
-        chunkWriter.WriteChunk(&_s6.completed_company_value, 0x761E8, SAWYER_ENCODING::RLECOMPRESSED);
+        chunks.push_back({ &_s6.next_free_tile_element_pointer_index, 0x27104C, SAWYER_ENCODING::RLECOMPRESSED });
+        chunks.push_back({ &_s6.guests_in_park, 4, SAWYER_ENCODING::RLECOMPRESSED });
+        chunks.push_back({ &_s6.last_guests_in_park, 8, SAWYER_ENCODING::RLECOMPRESSED });
+        chunks.push_back({ &_s6.park_rating, 2, SAWYER_ENCODING::RLECOMPRESSED });
+        chunks.push_back({ &_s6.active_research_types, 1082, SAWYER_ENCODING::RLECOMPRESSED });
+        chunks.push_back({ &_s6.current_expenditure, 16, SAWYER_ENCODING::RLECOMPRESSED });
+        chunks.push_back({ &_s6.park_value, 4, SAWYER_ENCODING::RLECOMPRESSED });
+        chunks.push_back({ &_s6.completed_company_value, 0x761E8, SAWYER_ENCODING::RLECOMPRESSED });
     }
     else
     {
         // 6: Everything else...
-        chunkWriter.WriteChunk(&_s6.next_free_tile_element_pointer_index, 0x2E8570, SAWYER_ENCODING::RLECOMPRESSED);
+        chunks.push_back({ &_s6.next_free_tile_element_pointer_index, 0x2E8570, SAWYER_ENCODING::RLECOMPRESSED });
+    }
+
+    // The chunks are encoded independently, so encode them all at once and write them out in order afterwards
+    std::vector<std::vector<uint8_t>> encodedChunks(chunks.size());
+    JobPool jobPool;
+    jobPool.ParallelFor(
+        0, chunks.size(),
+        [&chunks, &encodedChunks](size_t i) {
+            const auto& chunk = chunks[i];
+            encodedChunks[i] = SawyerChunkWriter::EncodeChunk(chunk.Data, chunk.Length, chunk.Encoding);
+        },
+        1);
+
+    auto chunkWriter = SawyerChunkWriter(stream);
+    for (size_t i = 0; i < encodedChunks.size(); i++)
+    {
+        if (i == numChunksBeforeObjects && _s6.header.num_packed_objects > 0)
+        {
+            if (_packedObjects.has_value())
+            {
+                stream->Write(_packedObjects->data(), _packedObjects->size());
+            }
+            else
+            {
+                auto& objRepo = OpenRCT2::GetContext()->GetObjectRepository();
+                objRepo.WritePackedObjects(stream, ExportObjectsList);
+            }
+        }
+        chunkWriter.WriteEncodedChunk(encodedChunks[i]);
     }
 
     // Determine number of bytes written
@@ -157,6 +209,45 @@ void S6Exporter::Save(OpenRCT2::IStream* stream, bool isScenario)
     stream->WriteValue(checksum);
 }
 
+/**
+ * Writes the exported park as a park file. The sections hold the same data as the SV6 chunks, but each of them can be
+ * read on its own.
+ */
+void S6Exporter::SaveParkFile(OpenRCT2::IStream* stream, bool isScenario)
+{
+    ExportHeader(isScenario);
+    _preview.Type = _s6.header.type;
+
+    ParkFileWriter writer(_s6.header.type);
+    writer.AddPreview(_preview);
+    if (_s6.header.num_packed_objects > 0)
+    {
+        if (!_packedObjects.has_value())
+        {
+            ExportPackedObjects();
+        }
+        writer.AddSection(ParkFileSection::PackedObjects, _packedObjects->data(), _packedObjects->size());
+    }
+    writer.AddS6Data(_s6);
+    writer.Write(stream);
+}
+
+/**
+ * Packs the objects in ExportObjectsList now rather than when saving, so that the save does not need the object
+ * repository and can be written from another thread.
+ */
+void S6Exporter::ExportPackedObjects()
+{
+    OpenRCT2::MemoryStream ms;
+    if (!ExportObjectsList.empty())
+    {
+        auto& objRepo = OpenRCT2::GetContext()->GetObjectRepository();
+        objRepo.WritePackedObjects(&ms, ExportObjectsList);
+    }
+    const auto* data = static_cast<const uint8_t*>(ms.GetData());
+    _packedObjects = std::vector<uint8_t>(data, data + ms.GetLength());
+}
+
 void S6Exporter::Export()
 {
     _s6.info = gS6Info;
@@ -199,6 +290,7 @@ void S6Exporter::Export()
     ExportTileElements();
     ExportEntities();
     ExportParkName();
+    ExportPreview();
 
     _s6.initial_cash = gInitialCash;
     _s6.current_loan = gBankLoan;
@@ -481,6 +573,27 @@ void S6Exporter::ExportParkName()
     }
 }
 
+/**
+ * Keeps what the load dialogs show about the park, as the park may be saved on another thread.
+ */
+void S6Exporter::ExportPreview()
+{
+    _preview = {};
+    _preview.ParkName = OpenRCT2::GetContext()->GetGameState()->GetPark().Name;
+    _preview.ScenarioName = gS6Info.name;
+    _preview.ScenarioDetails = gS6Info.details;
+    _preview.Category = gS6Info.category;
+    _preview.ObjectiveType = gS6Info.objective_type;
+    _preview.ObjectiveArg1 = gS6Info.objective_arg_1;
+    _preview.ObjectiveArg2 = gS6Info.objective_arg_2;
+    _preview.ObjectiveArg3 = gS6Info.objective_arg_3;
+    _preview.MonthsElapsed = gDateMonthsElapsed;
+    _preview.Cash = gCash;
+    _preview.NumGuests = gNumGuestsInPark;
+    _preview.ParkRating = gParkRating;
+    _preview.MapSize = gMapSize;
+}
+
 void S6Exporter::ExportRides()
 {
     const Ride nullRide{};
@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include "../ParkFile.h"
 #include "../common.h"
 #include "../object/ObjectList.h"
 #include "../scenario/Scenario.h"
@@ -30,7 +31,8 @@ union rct_sprite;
 struct SpriteBase;
 
 /**
- * Class to export RollerCoaster Tycoon 2 scenarios (*.SC6) and saved games (*.SV6).
+ * Class to export RollerCoaster Tycoon 2 scenarios (*.SC6) and saved games (*.SV6), or either as a native park file
+ * (*.park) when the path ends in .park.
  */
 class S6Exporter final
 {
@@ -44,7 +46,9 @@ public:
     void SaveGame(OpenRCT2::IStream* stream);
     void SaveScenario(const utf8* path);
     void SaveScenario(OpenRCT2::IStream* stream);
+    void SaveParkFile(OpenRCT2::IStream* stream, bool isScenario);
     void Export();
+    void ExportPackedObjects();
     void ExportParkName();
     void ExportRides();
     void ExportRide(rct2_ride* dst, const Ride* src);
@@ -56,8 +60,12 @@ public:
 private:
     rct_s6_data _s6{};
     std::vector<std::string> _userStrings;
+    std::optional<std::vector<uint8_t>> _packedObjects;
+    ParkPreview _preview;
 
     void Save(OpenRCT2::IStream* stream, bool isScenario);
+    void ExportHeader(bool isScenario);
+    void ExportPreview();
     static uint32_t GetLoanHash(money32 initialCash, money32 bankLoan, uint32_t maxBankLoan);
     void ExportResearchedRideTypes();
     void ExportResearchedRideEntries();
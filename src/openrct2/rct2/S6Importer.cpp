@@ -12,11 +12,13 @@
 #include "../Game.h"
 #include "../GameState.h"
 #include "../OpenRCT2.h"
+#include "../ParkFile.h"
 #include "../ParkImporter.h"
 #include "../config/Config.h"
 #include "../core/Console.hpp"
 #include "../core/FileStream.h"
 #include "../core/IStream.hpp"
+#include "../core/MemoryStream.h"
 #include "../core/Path.hpp"
 #include "../core/Random.hpp"
 #include "../core/String.hpp"
@@ -98,6 +100,12 @@ public:
         {
             return LoadSavedGame(path);
         }
+        else if (ParkFileReader::ExtensionIsParkFile(path))
+        {
+            // Park files can be either, the header says which
+            auto reader = ParkFileReader(path);
+            return LoadFromParkFile(reader, reader.GetHeader().Type == S6_TYPE_SCENARIO, path);
+        }
         else
         {
             throw std::runtime_error("Invalid RCT2 park extension.");
@@ -106,6 +114,10 @@ public:
 
     ParkLoadResult LoadSavedGame(const utf8* path, bool skipObjectCheck = false) override
     {
+        if (ParkFileReader::ExtensionIsParkFile(path))
+        {
+            return LoadFromParkFile(ParkFileReader(path), false, path);
+        }
         auto fs = OpenRCT2::FileStream(path, OpenRCT2::FILE_MODE_OPEN);
         auto result = LoadFromStream(&fs, false, skipObjectCheck);
         _s6Path = path;
@@ -114,6 +126,10 @@ public:
 
     ParkLoadResult LoadScenario(const utf8* path, bool skipObjectCheck = false) override
     {
+        if (ParkFileReader::ExtensionIsParkFile(path))
+        {
+            return LoadFromParkFile(ParkFileReader(path), true, path);
+        }
         auto fs = OpenRCT2::FileStream(path, OpenRCT2::FILE_MODE_OPEN);
         auto result = LoadFromStream(&fs, true, skipObjectCheck);
         _s6Path = path;
@@ -124,6 +140,11 @@ public:
         OpenRCT2::IStream* stream, bool isScenario, [[maybe_unused]] bool skipObjectCheck = false,
         const utf8* path = String::Empty) override
     {
+        if (ParkFileReader::IsParkFile(stream))
+        {
+            return LoadFromParkFile(ParkFileReader(stream), isScenario, path);
+        }
+
         if (isScenario && !gConfigGeneral.allow_loading_with_incorrect_checksum && !SawyerEncoding::ValidateChecksum(stream))
         {
             throw IOException("Invalid checksum.");
@@ -194,6 +215,44 @@ public:
         return ParkLoadResult(GetRequiredObjects());
     }
 
+    /**
+     * Park files hold the same data as the SV6 chunks, so once read they are imported the same way. Each section is
+     * checked against its checksum as it is read.
+     */
+    ParkLoadResult LoadFromParkFile(const ParkFileReader& reader, bool isScenario, const utf8* path)
+    {
+        const auto type = reader.GetHeader().Type;
+        if (isScenario && type != S6_TYPE_SCENARIO)
+        {
+            throw std::runtime_error("Park is not a scenario.");
+        }
+        if (!isScenario && type != S6_TYPE_SAVEDGAME)
+        {
+            throw std::runtime_error("Park is not a saved game.");
+        }
+
+        reader.ReadS6Data(_s6);
+        if (_s6.header.classic_flag == 0xf)
+        {
+            throw UnsupportedRCTCFlagException(_s6.header.classic_flag);
+        }
+
+        if (_s6.header.num_packed_objects > 0)
+        {
+            auto packedObjects = reader.ReadSection(ParkFileSection::PackedObjects);
+            auto ms = OpenRCT2::MemoryStream(packedObjects.data(), packedObjects.size());
+            for (uint16_t i = 0; i < _s6.header.num_packed_objects; i++)
+            {
+                _objectRepository.ExportPackedObject(&ms);
+            }
+        }
+
+        _isSV7 = false;
+        _s6Path = path;
+
+        return ParkLoadResult(GetRequiredObjects());
+    }
+
     bool GetDetails(scenario_index_entry* dst) override
     {
         *dst = {};
@@ -15,17 +15,45 @@
 
 namespace TrainManager
 {
+    static Vehicle* GetTrainHead(uint16_t spriteIndex)
+    {
+        auto* vehicle = GetEntity<Vehicle>(spriteIndex);
+        if (vehicle != nullptr && !vehicle->IsHead())
+        {
+            return nullptr;
+        }
+        return vehicle;
+    }
+
+    View::Iterator::Iterator(const std::vector<uint16_t>& _vec, size_t _index)
+        : vec(&_vec)
+        , index(_index)
+        , lastId(SPRITE_INDEX_NULL)
+    {
+        if (index < vec->size())
+        {
+            lastId = (*vec)[index];
+            Entity = GetTrainHead(lastId);
+            if (Entity == nullptr)
+            {
+                ++(*this);
+            }
+        }
+    }
+
     View::Iterator& View::Iterator::operator++()
     {
         Entity = nullptr;
 
-        while (iter != end && Entity == nullptr)
+        while (Entity == nullptr)
         {
-            Entity = GetEntity<Vehicle>(*iter++);
-            if (Entity && !Entity->IsHead())
+            index = GetEntityListNextIndex(*vec, index, lastId);
+            if (index >= vec->size())
             {
-                Entity = nullptr;
+                break;
             }
+            lastId = (*vec)[index];
+            Entity = GetTrainHead(lastId);
         }
         return *this;
     }
@@ -252,6 +252,8 @@ static void scenario_entrance_fee_too_high_check()
 
 void scenario_autosave_check()
 {
+    game_autosave_update();
+
     if (gLastAutoSaveUpdate == AUTOSAVE_PAUSE)
         return;
 
@@ -11,6 +11,7 @@
 
 #include "../Context.h"
 #include "../Game.h"
+#include "../ParkFile.h"
 #include "../ParkImporter.h"
 #include "../PlatformEnvironment.h"
 #include "../config/Config.h"
@@ -129,8 +130,8 @@ class ScenarioFileIndex final : public FileIndex<scenario_index_entry>
 {
 private:
     static constexpr uint32_t MAGIC_NUMBER = 0x58444953; // SIDX
-    static constexpr uint16_t VERSION = 5;
-    static constexpr auto PATTERN = "*.sc4;*.sc6;*.sea";
+    static constexpr uint16_t VERSION = 6;
+    static constexpr auto PATTERN = "*.sc4;*.sc6;*.sea;*.park";
 
 public:
     explicit ScenarioFileIndex(const IPlatformEnvironment& env)
@@ -223,6 +224,30 @@ private:
                 }
                 return result;
             }
+            else if (ParkFileReader::ExtensionIsParkFile(path))
+            {
+                // Only the header and the preview are read, the rest of the file is not even loaded from disk
+                auto reader = ParkFileReader(path);
+                if (reader.GetHeader().Type == S6_TYPE_SCENARIO)
+                {
+                    auto preview = reader.ReadPreview();
+                    rct_s6_info info{};
+                    info.category = preview.Category;
+                    info.objective_type = preview.ObjectiveType;
+                    info.objective_arg_1 = preview.ObjectiveArg1;
+                    info.objective_arg_2 = preview.ObjectiveArg2;
+                    info.objective_arg_3 = preview.ObjectiveArg3;
+                    String::Set(info.name, sizeof(info.name), preview.ScenarioName.c_str());
+                    String::Set(info.details, sizeof(info.details), preview.ScenarioDetails.c_str());
+
+                    *entry = CreateNewScenarioEntry(path, timestamp, &info);
+                    return true;
+                }
+                else
+                {
+                    log_verbose("%s is not a scenario", path.c_str());
+                }
+            }
             else
             {
                 // RCT2 or RCTC scenario
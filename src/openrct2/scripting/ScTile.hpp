@@ -14,8 +14,10 @@
 #    include "../Context.h"
 #    include "../common.h"
 #    include "../core/Guard.hpp"
+#    include "../peep/GuestPathfinding.h"
 #    include "../ride/Track.h"
 #    include "../world/Footpath.h"
+#    include "../world/Park.h"
 #    include "../world/Scenery.h"
 #    include "../world/Sprite.h"
 #    include "../world/Surface.h"
@@ -99,6 +101,7 @@ namespace OpenRCT2::Scripting
             }
 
             _element->type = type;
+            park_size_invalidate(_coords);
             Invalidate();
         }
 
@@ -320,6 +323,7 @@ namespace OpenRCT2::Scripting
             if (el != nullptr)
             {
                 el->SetOwnership(value);
+                park_size_invalidate(_coords);
                 Invalidate();
             }
         }
@@ -1475,6 +1479,8 @@ namespace OpenRCT2::Scripting
 
         void Invalidate()
         {
+            map_update_tile_element_types(_coords);
+            pathfind_graph_invalidate(_coords);
             map_invalidate_tile_full(_coords);
         }
 
@@ -1681,6 +1687,9 @@ namespace OpenRCT2::Scripting
                         first[numElements - 1].SetLastForTile(true);
                     }
                 }
+                map_update_tile_element_types(_coords);
+                pathfind_graph_invalidate(_coords);
+                park_size_invalidate(_coords);
                 map_invalidate_tile_full(_coords);
             }
         }
@@ -1733,6 +1742,8 @@ namespace OpenRCT2::Scripting
                         first[i].SetLastForTile(false);
                     }
                     first[origNumElements].SetLastForTile(true);
+                    pathfind_graph_invalidate(_coords);
+                    park_size_invalidate(_coords);
                     map_invalidate_tile_full(_coords);
                     result = std::make_shared<ScTileElement>(_coords, &first[index]);
                 }
@@ -1752,6 +1763,9 @@ namespace OpenRCT2::Scripting
             if (index < GetNumElements(first))
             {
                 tile_element_remove(&first[index]);
+                map_update_tile_element_types(_coords);
+                pathfind_graph_invalidate(_coords);
+                park_size_invalidate(_coords);
                 map_invalidate_tile_full(_coords);
             }
         }
@@ -16,6 +16,12 @@
 #include <algorithm>
 #include <cstring>
 
+// MSVC does not define __SSE2__, but SSE2 is always available on x64 and with /arch:SSE2 or above on x86
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define SAWYERCODING_SSE2
+#    include <emmintrin.h>
+#endif
+
 static size_t decode_chunk_rle(const uint8_t* src_buffer, uint8_t* dst_buffer, size_t length);
 static size_t decode_chunk_rle_with_size(const uint8_t* src_buffer, uint8_t* dst_buffer, size_t length, size_t dstSize);
 
@@ -95,6 +101,34 @@ size_t sawyercoding_write_chunk_buffer(uint8_t* dst_file, const uint8_t* buffer,
     return chunkHeader.length + sizeof(sawyercoding_chunk_header);
 }
 
+/**
+ * Returns the most bytes sawyercoding_write_chunk_buffer can write for a chunk of the given length and encoding,
+ * including the chunk header.
+ */
+size_t sawyercoding_get_max_chunk_buffer_length(size_t length, uint8_t encoding)
+{
+    size_t maxLength = length;
+    if (encoding == CHUNK_ENCODING_RLECOMPRESSED)
+    {
+        // Each byte that does not repeat an earlier one is written as two bytes
+        maxLength = sawyercoding_get_max_rle_length(length * 2);
+    }
+    else if (encoding == CHUNK_ENCODING_RLE)
+    {
+        maxLength = sawyercoding_get_max_rle_length(length);
+    }
+    return maxLength + sizeof(sawyercoding_chunk_header);
+}
+
+/**
+ * Returns the most bytes encode_chunk_rle can write for the given length. Runs never get longer, but each group of
+ * literal bytes gets a count byte and two groups are at least a two byte run apart.
+ */
+size_t sawyercoding_get_max_rle_length(size_t length)
+{
+    return length + (length + 2) / 3;
+}
+
 size_t sawyercoding_decode_sv4(const uint8_t* src, uint8_t* dst, size_t length, size_t bufferLength)
 {
     // (0 to length - 4): RLE chunk
@@ -258,6 +292,59 @@ static size_t decode_chunk_rle_with_size(const uint8_t* src_buffer, uint8_t* dst
 
 #pragma region Encoding
 
+/**
+ * Returns how many bytes from the start of src are the same as the first one, checking at most maxLength bytes.
+ */
+static size_t encode_chunk_rle_run_length(const uint8_t* src, size_t maxLength)
+{
+    size_t length = 0;
+#ifdef SAWYERCODING_SSE2
+    const __m128i value = _mm_set1_epi8(static_cast<char>(src[0]));
+    for (; length + 16 <= maxLength; length += 16)
+    {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + length));
+        const uint32_t different = ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, value))) & 0xFFFF;
+        if (different != 0)
+        {
+            return length + bitscanforward(static_cast<int32_t>(different));
+        }
+    }
+#endif
+    for (; length < maxLength; length++)
+    {
+        if (src[length] != src[0])
+            break;
+    }
+    return length;
+}
+
+/**
+ * Returns the index of the first byte in src that is the same as the byte after it, checking at most maxLength bytes.
+ * src must have at least maxLength + 1 bytes.
+ */
+static size_t encode_chunk_rle_literal_length(const uint8_t* src, size_t maxLength)
+{
+    size_t length = 0;
+#ifdef SAWYERCODING_SSE2
+    for (; length + 16 <= maxLength; length += 16)
+    {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + length));
+        const __m128i nextBlock = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + length + 1));
+        const uint32_t repeated = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, nextBlock)));
+        if (repeated != 0)
+        {
+            return length + bitscanforward(static_cast<int32_t>(repeated));
+        }
+    }
+#endif
+    for (; length < maxLength; length++)
+    {
+        if (src[length] == src[length + 1])
+            break;
+    }
+    return length;
+}
+
 /**
  * Ensure dst_buffer is bigger than src_buffer then resize afterwards
  * returns length of dst_buffer
@@ -282,11 +369,7 @@ static size_t encode_chunk_rle(const uint8_t* src_buffer, uint8_t* dst_buffer, s
         }
         if (*src == src[1])
         {
-            for (; (count < 125) && ((src + count) < end_src); count++)
-            {
-                if (*src != src[count])
-                    break;
-            }
+            count = static_cast<uint8_t>(encode_chunk_rle_run_length(src, std::min<size_t>(125, end_src - src)));
             *dst++ = 257 - count;
             *dst++ = *src;
             src += count;
@@ -295,8 +378,10 @@ static size_t encode_chunk_rle(const uint8_t* src_buffer, uint8_t* dst_buffer, s
         }
         else
         {
-            count++;
-            src++;
+            // Take all the bytes up to the next repeated byte at once, but no more than a literal run can hold
+            size_t literalLength = encode_chunk_rle_literal_length(src, std::min<size_t>(126 - count, end_src - 1 - src));
+            count += static_cast<uint8_t>(literalLength);
+            src += literalLength;
         }
     }
     if (src == end_src - 1)
@@ -310,6 +395,42 @@ static size_t encode_chunk_rle(const uint8_t* src_buffer, uint8_t* dst_buffer, s
     return dst - dst_buffer;
 }
 
+#ifdef SAWYERCODING_SSE2
+/**
+ * Finds the longest match of up to 8 bytes for src_buffer[i] that starts within the 32 bytes before it, picking the
+ * earliest one of the longest matches, the same as the scalar search in encode_chunk_repeat.
+ * Requires i >= 32 and i + 8 <= length.
+ */
+static size_t encode_chunk_repeat_find_sse2(const uint8_t* src_buffer, size_t i, size_t* bestRepeatIndex)
+{
+    // Bit p of a mask stands for the match starting at i - 32 + p
+    const uint8_t* window = src_buffer + i - 32;
+    uint32_t matching = 0xFFFFFFFF;
+    size_t bestRepeatCount = 0;
+    for (size_t j = 0; j < 8; j++)
+    {
+        const __m128i needle = _mm_set1_epi8(static_cast<char>(src_buffer[i + j]));
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(window + j));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(window + j + 16));
+        const uint32_t equal = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(lo, needle)))
+            | (static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(hi, needle))) << 16);
+
+        // A match can not run into the bytes being matched, so the matches closest to i drop out first
+        const uint32_t stillMatching = matching & equal & (0xFFFFFFFFu >> j);
+        if (stillMatching == 0)
+            break;
+
+        matching = stillMatching;
+        bestRepeatCount = j + 1;
+    }
+    if (bestRepeatCount != 0)
+    {
+        *bestRepeatIndex = i - 32 + bitscanforward(static_cast<int32_t>(matching));
+    }
+    return bestRepeatCount;
+}
+#endif
+
 static size_t encode_chunk_repeat(const uint8_t* src_buffer, uint8_t* dst_buffer, size_t length)
 {
     if (length == 0)
@@ -330,32 +451,41 @@ static size_t encode_chunk_repeat(const uint8_t* src_buffer, uint8_t* dst_buffer
 
         size_t bestRepeatIndex = 0;
         size_t bestRepeatCount = 0;
-        for (size_t repeatIndex = searchIndex; repeatIndex <= searchEnd; repeatIndex++)
+#ifdef SAWYERCODING_SSE2
+        if (i >= 32 && i + 8 <= length)
+        {
+            bestRepeatCount = encode_chunk_repeat_find_sse2(src_buffer, i, &bestRepeatIndex);
+        }
+        else
+#endif
         {
-            size_t repeatCount = 0;
-            size_t maxRepeatCount = std::min(std::min(static_cast<size_t>(7), searchEnd - repeatIndex), length - i - 1);
-            // maxRepeatCount should not exceed length
-            assert(repeatIndex + maxRepeatCount < length);
-            assert(i + maxRepeatCount < length);
-            for (size_t j = 0; j <= maxRepeatCount; j++)
+            for (size_t repeatIndex = searchIndex; repeatIndex <= searchEnd; repeatIndex++)
             {
-                if (src_buffer[repeatIndex + j] == src_buffer[i + j])
+                size_t repeatCount = 0;
+                size_t maxRepeatCount = std::min(std::min(static_cast<size_t>(7), searchEnd - repeatIndex), length - i - 1);
+                // maxRepeatCount should not exceed length
+                assert(repeatIndex + maxRepeatCount < length);
+                assert(i + maxRepeatCount < length);
+                for (size_t j = 0; j <= maxRepeatCount; j++)
                 {
-                    repeatCount++;
+                    if (src_buffer[repeatIndex + j] == src_buffer[i + j])
+                    {
+                        repeatCount++;
+                    }
+                    else
+                    {
+                        break;
+                    }
                 }
-                else
+                if (repeatCount > bestRepeatCount)
                 {
-                    break;
-                }
-            }
-            if (repeatCount > bestRepeatCount)
-            {
-                bestRepeatIndex = repeatIndex;
-                bestRepeatCount = repeatCount;
+                    bestRepeatIndex = repeatIndex;
+                    bestRepeatCount = repeatCount;
 
-                // Maximum repeat count is 8
-                if (repeatCount == 8)
-                    break;
+                    // Maximum repeat count is 8
+                    if (repeatCount == 8)
+                        break;
+                }
             }
         }
 
@@ -379,15 +509,68 @@ static size_t encode_chunk_repeat(const uint8_t* src_buffer, uint8_t* dst_buffer
 
 static void encode_chunk_rotate(uint8_t* buffer, size_t length)
 {
-    size_t i;
+    sawyercoding_encode_rotate(buffer, buffer, length);
+}
+
+/**
+ * Rotates every byte left by 1, 3, 5 and 7 bits in turn, or right by the same amounts when decoding. src and dst may be
+ * the same buffer.
+ */
+template<bool TDecode> static void rotate_chunk(uint8_t* dst, const uint8_t* src, size_t length)
+{
+    size_t i = 0;
+#ifdef SAWYERCODING_SSE2
+    // The amounts repeat every four bytes, so each 32 bit lane of a block rotates its bytes by the same four amounts.
+    // A rotation is made of a left and right shift of the whole lane, masked to the bits that stayed within each byte.
+    constexpr int32_t shift0 = TDecode ? 7 : 1;
+    constexpr int32_t shift1 = TDecode ? 5 : 3;
+    constexpr int32_t shift2 = TDecode ? 3 : 5;
+    constexpr int32_t shift3 = TDecode ? 1 : 7;
+    const __m128i leftMask0 = _mm_set1_epi32((0xFF << shift0) & 0xFF);
+    const __m128i leftMask1 = _mm_set1_epi32(((0xFF << shift1) & 0xFF) << 8);
+    const __m128i leftMask2 = _mm_set1_epi32(((0xFF << shift2) & 0xFF) << 16);
+    const __m128i leftMask3 = _mm_set1_epi32(static_cast<int32_t>(((0xFFu << shift3) & 0xFFu) << 24));
+    const __m128i rightMask0 = _mm_set1_epi32(0xFF >> (8 - shift0));
+    const __m128i rightMask1 = _mm_set1_epi32((0xFF >> (8 - shift1)) << 8);
+    const __m128i rightMask2 = _mm_set1_epi32((0xFF >> (8 - shift2)) << 16);
+    const __m128i rightMask3 = _mm_set1_epi32((0xFF >> (8 - shift3)) << 24);
+    for (; i + 16 <= length; i += 16)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i left = _mm_or_si128(
+            _mm_or_si128(
+                _mm_and_si128(_mm_slli_epi32(v, shift0), leftMask0), _mm_and_si128(_mm_slli_epi32(v, shift1), leftMask1)),
+            _mm_or_si128(
+                _mm_and_si128(_mm_slli_epi32(v, shift2), leftMask2), _mm_and_si128(_mm_slli_epi32(v, shift3), leftMask3)));
+        const __m128i right = _mm_or_si128(
+            _mm_or_si128(
+                _mm_and_si128(_mm_srli_epi32(v, 8 - shift0), rightMask0),
+                _mm_and_si128(_mm_srli_epi32(v, 8 - shift1), rightMask1)),
+            _mm_or_si128(
+                _mm_and_si128(_mm_srli_epi32(v, 8 - shift2), rightMask2),
+                _mm_and_si128(_mm_srli_epi32(v, 8 - shift3), rightMask3)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(left, right));
+    }
+#endif
+    // i is a multiple of 4 here, so the amounts start from the first one again
     uint8_t code = 1;
-    for (i = 0; i < length; i++)
+    for (; i < length; i++)
     {
-        buffer[i] = rol8(buffer[i], code);
+        dst[i] = TDecode ? ror8(src[i], code) : rol8(src[i], code);
         code = (code + 2) % 8;
     }
 }
 
+void sawyercoding_encode_rotate(uint8_t* dst, const uint8_t* src, size_t length)
+{
+    rotate_chunk<false>(dst, src, length);
+}
+
+void sawyercoding_decode_rotate(uint8_t* dst, const uint8_t* src, size_t length)
+{
+    rotate_chunk<true>(dst, src, length);
+}
+
 #pragma endregion
 
 int32_t sawyercoding_detect_file_type(const uint8_t* src, size_t length)
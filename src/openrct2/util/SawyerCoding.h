@@ -46,12 +46,16 @@ extern bool gUseRLE;
 
 uint32_t sawyercoding_calculate_checksum(const uint8_t* buffer, size_t length);
 size_t sawyercoding_write_chunk_buffer(uint8_t* dst_file, const uint8_t* src_buffer, sawyercoding_chunk_header chunkHeader);
+size_t sawyercoding_get_max_chunk_buffer_length(size_t length, uint8_t encoding);
+size_t sawyercoding_get_max_rle_length(size_t length);
 size_t sawyercoding_decode_sv4(const uint8_t* src, uint8_t* dst, size_t length, size_t bufferLength);
 size_t sawyercoding_decode_sc4(const uint8_t* src, uint8_t* dst, size_t length, size_t bufferLength);
 size_t sawyercoding_encode_sv4(const uint8_t* src, uint8_t* dst, size_t length);
 size_t sawyercoding_decode_td6(const uint8_t* src, uint8_t* dst, size_t length);
 size_t sawyercoding_encode_td6(const uint8_t* src, uint8_t* dst, size_t length);
 int32_t sawyercoding_validate_track_checksum(const uint8_t* src, size_t length);
+void sawyercoding_encode_rotate(uint8_t* dst, const uint8_t* src, size_t length);
+void sawyercoding_decode_rotate(uint8_t* dst, const uint8_t* src, size_t length);
 
 int32_t sawyercoding_detect_file_type(const uint8_t* src, size_t length);
 int32_t sawyercoding_detect_rct1_version(int32_t gameVersion);
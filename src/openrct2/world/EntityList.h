@@ -15,7 +15,7 @@
 #include "Location.hpp"
 #include "SpriteBase.h"
 
-#include <list>
+#include <algorithm>
 #include <vector>
 
 enum class EntityListId : uint8_t
@@ -23,13 +23,27 @@ enum class EntityListId : uint8_t
     Count = 6,
 };
 
-const std::list<uint16_t>& GetEntityList(const EntityType id);
+const std::vector<uint16_t>& GetEntityList(const EntityType id);
 
 uint16_t GetEntityListCount(EntityType list);
 uint16_t GetMiscEntityCount();
 uint16_t GetNumFreeEntities();
 const std::vector<uint16_t>& GetEntityTileList(const CoordsXY& spritePos);
 
+/**
+ * Returns the position in an entity list of the first entity after lastId. Entity lists are kept in
+ * sprite_index order, so iteration can carry on correctly even if entities were added or removed
+ * since lastId was visited at position index.
+ */
+inline size_t GetEntityListNextIndex(const std::vector<uint16_t>& list, size_t index, uint16_t lastId)
+{
+    if (index < list.size() && list[index] == lastId)
+    {
+        return index + 1;
+    }
+    return std::upper_bound(std::begin(list), std::end(list), lastId) - std::begin(list);
+}
+
 template<typename T> class EntityTileIterator
 {
 private:
@@ -105,24 +119,40 @@ public:
 template<typename T> class EntityListIterator
 {
 private:
-    std::list<uint16_t>::const_iterator iter;
-    std::list<uint16_t>::const_iterator end;
+    const std::vector<uint16_t>* vec;
+    size_t index;
+    uint16_t lastId = SPRITE_INDEX_NULL;
     T* Entity = nullptr;
 
 public:
-    EntityListIterator(std::list<uint16_t>::const_iterator _iter, std::list<uint16_t>::const_iterator _end)
-        : iter(_iter)
-        , end(_end)
+    EntityListIterator(const std::vector<uint16_t>& _vec, size_t _index)
+        : vec(&_vec)
+        , index(_index)
     {
-        ++(*this);
+        if (index < vec->size())
+        {
+            lastId = (*vec)[index];
+            Entity = GetEntity<T>(lastId);
+            if (Entity == nullptr)
+            {
+                ++(*this);
+            }
+        }
     }
     EntityListIterator& operator++()
     {
         Entity = nullptr;
 
-        while (iter != end && Entity == nullptr)
+        while (Entity == nullptr)
         {
-            Entity = GetEntity<T>(*iter++);
+            // The list may have changed since the last entity was visited (e.g. it was removed)
+            index = GetEntityListNextIndex(*vec, index, lastId);
+            if (index >= vec->size())
+            {
+                break;
+            }
+            lastId = (*vec)[index];
+            Entity = GetEntity<T>(lastId);
         }
         return *this;
     }
@@ -131,7 +161,7 @@ public:
     {
         EntityListIterator retval = *this;
         ++(*this);
-        return *iter;
+        return retval;
     }
     bool operator==(EntityListIterator other) const
     {
@@ -157,7 +187,7 @@ template<typename T = SpriteBase> class EntityList
 {
 private:
     using EntityListIterator_t = EntityListIterator<T>;
-    const std::list<uint16_t>& vec;
+    const std::vector<uint16_t>& vec;
 
 public:
     EntityList()
@@ -167,10 +197,10 @@ public:
 
     EntityListIterator_t begin()
     {
-        return EntityListIterator_t(std::cbegin(vec), std::cend(vec));
+        return EntityListIterator_t(vec, 0);
     }
     EntityListIterator_t end()
     {
-        return EntityListIterator_t(std::cend(vec), std::cend(vec));
+        return EntityListIterator_t(vec, vec.size());
     }
 };
@@ -23,6 +23,7 @@
 #include "../object/ObjectList.h"
 #include "../object/ObjectManager.h"
 #include "../paint/VirtualFloor.h"
+#include "../peep/GuestPathfinding.h"
 #include "../ride/RideData.h"
 #include "../ride/Station.h"
 #include "../ride/Track.h"
@@ -108,7 +109,7 @@ static bool entrance_has_direction(TileElement* tileElement, int32_t direction)
 
 TileElement* map_get_footpath_element(const CoordsXYZ& coords)
 {
-    TileElement* tileElement = map_get_first_element_at(coords);
+    TileElement* tileElement = map_get_first_element_of_type_at(coords, TileElementType::Path);
     do
     {
         if (tileElement == nullptr)
@@ -714,7 +715,11 @@ static bool footpath_reconnect_queue_to_path(
             targetQueueElement->SetEdges(targetQueueElement->GetEdges() | (1 << (direction_reverse(direction) & 3)));
         }
         if (action != 0)
+        {
             map_invalidate_tile_full(targetQueuePos);
+            pathfind_graph_invalidate(footpathPos);
+            pathfind_graph_invalidate(targetQueuePos);
+        }
         return true;
     }
     return false;
@@ -763,6 +768,7 @@ static void loc_6A6FD2(const CoordsXYZ& initialTileElementPos, int32_t direction
         {
             initialTileElement->AsPath()->SetEdges(initialTileElement->AsPath()->GetEdges() | (1 << direction));
             map_invalidate_element(initialTileElementPos, initialTileElement);
+            pathfind_graph_invalidate(initialTileElementPos);
         }
     }
 }
@@ -808,6 +814,7 @@ static void loc_6A6F1F(
     {
         footpath_disconnect_queue_from_path(targetPos, tileElement, 1 + ((flags >> 6) & 1));
         tileElement->AsPath()->SetEdges(tileElement->AsPath()->GetEdges() | (1 << direction_reverse(direction)));
+        pathfind_graph_invalidate(targetPos);
         if (tileElement->AsPath()->IsQueue())
         {
             footpath_queue_chain_push(tileElement->AsPath()->GetRideIndex());
@@ -1146,6 +1153,7 @@ void footpath_chain_ride_queue(
 
             curQueuePos = targetQueuePos;
             map_invalidate_element(targetQueuePos, tileElement);
+            pathfind_graph_invalidate(targetQueuePos);
 
             if (lastQueuePathElement == nullptr)
             {
@@ -1713,6 +1721,30 @@ static void footpath_clear_wide(const CoordsXY& footpathPos)
     } while (!(tileElement++)->IsLastForTile());
 }
 
+/**
+ * Returns a mask with bit n set when the nth element on the tile is a wide path. The top bit stands for all elements
+ * that do not have a bit of their own.
+ */
+static uint64_t footpath_get_wide_mask(const CoordsXY& footpathPos)
+{
+    constexpr uint64_t overflowBit = 1ULL << 63;
+
+    uint64_t mask = 0;
+    TileElement* tileElement = map_get_first_element_at(footpathPos);
+    if (tileElement == nullptr)
+        return mask;
+    uint32_t index = 0;
+    do
+    {
+        if (tileElement->GetType() == TILE_ELEMENT_TYPE_PATH && tileElement->AsPath()->IsWide())
+        {
+            mask |= index < 63 ? (1ULL << index) : overflowBit;
+        }
+        index++;
+    } while (!(tileElement++)->IsLastForTile());
+    return mask;
+}
+
 /**
  *
  *  rct2: 0x006A8ACF
@@ -1749,6 +1781,7 @@ void footpath_update_path_wide_flags(const CoordsXY& footpathPos)
     if (map_is_location_at_edge(footpathPos))
         return;
 
+    auto oldWideMask = footpath_get_wide_mask(footpathPos);
     footpath_clear_wide(footpathPos);
     /* Rather than clearing the wide flag of the following tiles and
      * checking the state of them later, leave them intact and assume
@@ -1927,6 +1960,14 @@ void footpath_update_path_wide_flags(const CoordsXY& footpathPos)
                 tileElement->AsPath()->SetWide(true);
         }
     } while (!(tileElement++)->IsLastForTile());
+
+    // Peeps treat wide paths differently, so the cached pathfinding graph has to be told about any change. Elements
+    // sharing the overflow bit can't be told apart, so those always count as changed.
+    auto newWideMask = footpath_get_wide_mask(footpathPos);
+    if (newWideMask != oldWideMask || (newWideMask >> 63) != 0)
+    {
+        pathfind_graph_invalidate(footpathPos);
+    }
 }
 
 bool footpath_is_blocked_by_vehicle(const TileCoordsXYZ& position)
@@ -1956,6 +1997,7 @@ void footpath_update_queue_entrance_banner(const CoordsXY& footpathPos, TileElem
                     }
                 }
                 tileElement->AsPath()->SetRideIndex(RIDE_ID_NULL);
+                pathfind_graph_invalidate(footpathPos);
             }
             break;
         case TILE_ELEMENT_TYPE_ENTRANCE:
@@ -1988,6 +2030,7 @@ static void footpath_remove_edges_towards_here(
     cd = ((cd + 1) & 3);
     tileElement->AsPath()->SetCorners(tileElement->AsPath()->GetCorners() & ~(1 << cd));
     map_invalidate_tile({ footpathPos, tileElement->GetBaseZ(), tileElement->GetClearanceZ() });
+    pathfind_graph_invalidate(footpathPos);
 
     if (isQueue)
         footpath_disconnect_queue_from_path(footpathPos, tileElement, -1);
@@ -2241,7 +2284,10 @@ void footpath_remove_edges_at(const CoordsXY& footpathPos, TileElement* tileElem
     }
 
     if (tileElement->GetType() == TILE_ELEMENT_TYPE_PATH)
+    {
         tileElement->AsPath()->SetEdgesAndCorners(0);
+        pathfind_graph_invalidate(footpathPos);
+    }
 }
 
 PathSurfaceEntry* get_path_surface_entry(PathSurfaceIndex entryIndex)
@@ -36,6 +36,7 @@
 #include "../network/network.h"
 #include "../object/ObjectManager.h"
 #include "../object/TerrainSurfaceObject.h"
+#include "../peep/GuestPathfinding.h"
 #include "../ride/RideData.h"
 #include "../ride/Track.h"
 #include "../ride/TrackData.h"
@@ -57,6 +58,7 @@
 #include "Wall.h"
 
 #include <algorithm>
+#include <array>
 #include <iterator>
 #include <memory>
 
@@ -124,6 +126,31 @@ static int32_t _mapSizeMinus2Stash;
 static int32_t _mapSizeStash;
 static int32_t _currentRotationStash;
 
+struct TileElementBlock
+{
+    uint32_t Index;
+    uint32_t Size;
+};
+
+// Blocks left behind by tiles that have been moved to make room for a new element. Windows, tools and plugins can hold
+// on to element pointers for a long time, so the blocks are held back until the end of the array is full, where the
+// array would otherwise have been reorganised and every pointer invalidated anyway. They are then reused for other
+// tiles of up to this size.
+constexpr uint32_t MaxFreeTileElementBlockSize = 32;
+static std::vector<TileElementBlock> _tileElementsFreed;
+static std::array<std::vector<uint32_t>, MaxFreeTileElementBlockSize + 1> _tileElementsFreeBlocks;
+static std::vector<TileElementBlock> _tileElementsFreedStash;
+static std::array<std::vector<uint32_t>, MaxFreeTileElementBlockSize + 1> _tileElementsFreeBlocksStash;
+
+static void ClearFreeTileElementBlocks()
+{
+    _tileElementsFreed.clear();
+    for (auto& blocks : _tileElementsFreeBlocks)
+    {
+        blocks.clear();
+    }
+}
+
 void StashMap()
 {
     _tileIndexStash = std::move(_tileIndex);
@@ -133,6 +160,9 @@ void StashMap()
     _mapSizeStash = gMapSize;
     _currentRotationStash = gCurrentRotation;
     _tileElementsInUseStash = _tileElementsInUse;
+    _tileElementsFreedStash = std::move(_tileElementsFreed);
+    _tileElementsFreeBlocksStash = std::move(_tileElementsFreeBlocks);
+    ClearFreeTileElementBlocks();
 }
 
 void UnstashMap()
@@ -144,6 +174,8 @@ void UnstashMap()
     gMapSize = _mapSizeStash;
     gCurrentRotation = _currentRotationStash;
     _tileElementsInUse = _tileElementsInUseStash;
+    _tileElementsFreed = std::move(_tileElementsFreedStash);
+    _tileElementsFreeBlocks = std::move(_tileElementsFreeBlocksStash);
 }
 
 const std::vector<TileElement>& GetTileElements()
@@ -156,6 +188,9 @@ void SetTileElements(std::vector<TileElement>&& tileElements)
     _tileElements = std::move(tileElements);
     _tileIndex = TilePointerIndex<TileElement>(MAXIMUM_MAP_SIZE_TECHNICAL, _tileElements.data());
     _tileElementsInUse = _tileElements.size();
+    ClearFreeTileElementBlocks();
+    park_size_invalidate_all();
+    pathfind_graph_reset();
 }
 
 static void ReorganiseTileElements(size_t capacity)
@@ -304,6 +339,56 @@ TileElement* map_get_first_element_at(const CoordsXY& elementPos)
     return _tileIndex.GetFirstElementAt(tileElementPos);
 }
 
+/**
+ * Gets the first element of the given type on a tile, skipping tiles that are known to contain no such element
+ * without reading their elements.
+ */
+TileElement* map_get_first_element_of_type_at(const CoordsXY& elementPos, TileElementType type)
+{
+    if (!map_is_location_valid(elementPos))
+    {
+        log_verbose("Trying to access element outside of range");
+        return nullptr;
+    }
+    auto tileElementPos = TileCoordsXY{ elementPos };
+    auto* tileElement = _tileIndex.GetFirstElementAt(tileElementPos);
+    if (!_tileIndex.MayContainType(tileElementPos, static_cast<uint8_t>(type)))
+    {
+#if DEBUG_LEVEL_1
+        if (tileElement != nullptr
+            && (TilePointerIndex<TileElement>::GetElementTypes(tileElement)
+                & TilePointerIndex<TileElement>::GetElementTypeMask(static_cast<uint8_t>(type)))
+                != 0)
+        {
+            log_error("Tile element type index out of date at %d, %d", tileElementPos.x, tileElementPos.y);
+            _tileIndex.UpdateTypes(tileElementPos);
+        }
+        else
+#endif
+        {
+            return nullptr;
+        }
+    }
+    if (tileElement == nullptr)
+        return nullptr;
+    do
+    {
+        if (tileElement->GetType() == static_cast<uint8_t>(type))
+            return tileElement;
+    } while (!(tileElement++)->IsLastForTile());
+    return nullptr;
+}
+
+/**
+ * Rebuilds the element types of a tile after an element on it has been replaced or changed type in place.
+ */
+void map_update_tile_element_types(const CoordsXY& elementPos)
+{
+    if (!map_is_location_valid(elementPos))
+        return;
+    _tileIndex.UpdateTypes(TileCoordsXY{ elementPos });
+}
+
 TileElement* map_get_nth_element_at(const CoordsXY& coords, int32_t n)
 {
     TileElement* tileElement = map_get_first_element_at(coords);
@@ -339,6 +424,7 @@ void map_set_tile_element(const TileCoordsXY& tilePos, TileElement* elements)
         return;
     }
     _tileIndex.SetTile(tilePos, elements);
+    _tileIndex.UpdateTypes(tilePos);
 }
 
 SurfaceElement* map_get_surface_element_at(const CoordsXY& coords)
@@ -472,6 +558,7 @@ void map_strip_ghost_flag_from_elements()
     {
         element.SetGhost(false);
     }
+    pathfind_graph_reset();
 }
 
 /**
@@ -1039,6 +1126,8 @@ void tile_element_remove(TileElement* tileElement)
  */
 void map_remove_all_rides()
 {
+    pathfind_graph_reset();
+
     tile_element_iterator it;
 
     tile_element_iterator_begin(&it);
@@ -1142,8 +1231,84 @@ static size_t CountElementsOnTile(const CoordsXY& loc)
     return count;
 }
 
+/**
+ * Makes the blocks freed since the last call available for reuse. Blocks at the end of the element array are given
+ * back by shrinking it instead.
+ */
+static void ReleaseFreedTileElements()
+{
+    // Latest blocks first, so that a run of blocks at the end of the array can be trimmed together
+    std::sort(_tileElementsFreed.begin(), _tileElementsFreed.end(), [](const auto& a, const auto& b) {
+        return a.Index > b.Index;
+    });
+    for (const auto& block : _tileElementsFreed)
+    {
+        if (block.Index + block.Size == _tileElements.size())
+        {
+            _tileElements.resize(block.Index);
+        }
+        else
+        {
+            _tileElementsFreeBlocks[block.Size].push_back(block.Index);
+        }
+    }
+    _tileElementsFreed.clear();
+}
+
+static void FreeTileElements(const TileElement* tileElement, size_t numElements)
+{
+    auto index = static_cast<uint32_t>(tileElement - _tileElements.data());
+    while (numElements > 0)
+    {
+        auto size = static_cast<uint32_t>(std::min<size_t>(numElements, MaxFreeTileElementBlockSize));
+        _tileElementsFreed.push_back({ index, size });
+        index += size;
+        numElements -= size;
+    }
+}
+
+static TileElement* AllocateFreeTileElements(size_t numElements)
+{
+    // Take the smallest free block that fits, returning what is left of it
+    for (size_t size = numElements; size <= MaxFreeTileElementBlockSize; size++)
+    {
+        auto& blocks = _tileElementsFreeBlocks[size];
+        if (!blocks.empty())
+        {
+            auto index = blocks.back();
+            blocks.pop_back();
+            if (size > numElements)
+            {
+                _tileElementsFreeBlocks[size - numElements].push_back(static_cast<uint32_t>(index + numElements));
+            }
+            return &_tileElements[index];
+        }
+    }
+    return nullptr;
+}
+
 static TileElement* AllocateTileElements(size_t numElementsOnTile, size_t numNewElements)
 {
+    if (_tileElementsInUse + numNewElements <= MAX_TILE_ELEMENTS)
+    {
+        auto totalElementsRequired = numElementsOnTile + numNewElements;
+        auto* tileElement = AllocateFreeTileElements(totalElementsRequired);
+        if (tileElement == nullptr && _tileElements.capacity() - _tileElements.size() < totalElementsRequired)
+        {
+            // Reusing the held back blocks now is no worse for stale pointers than reorganising would be
+            ReleaseFreedTileElements();
+            if (_tileElements.capacity() - _tileElements.size() < totalElementsRequired)
+            {
+                tileElement = AllocateFreeTileElements(totalElementsRequired);
+            }
+        }
+        if (tileElement != nullptr)
+        {
+            _tileElementsInUse += numNewElements;
+            return tileElement;
+        }
+    }
+
     if (!map_check_free_elements_and_reorganise(numElementsOnTile, numNewElements))
     {
         log_error("Cannot insert new element");
@@ -1174,6 +1339,7 @@ TileElement* tile_element_insert(const CoordsXYZ& loc, int32_t occupiedQuadrants
 
     // Set tile index pointer to point to new element block
     _tileIndex.SetTile(tileLoc, newTileElement);
+    pathfind_graph_invalidate(loc);
 
     bool isLastForTile = false;
     if (originalTileElement == nullptr)
@@ -1202,6 +1368,7 @@ TileElement* tile_element_insert(const CoordsXYZ& loc, int32_t occupiedQuadrants
     }
 
     // Insert new map element
+    _tileIndex.AddType(tileLoc, static_cast<uint8_t>(type));
     auto* insertedElement = newTileElement;
     newTileElement->type = 0;
     newTileElement->SetType(static_cast<uint8_t>(type));
@@ -1228,6 +1395,11 @@ TileElement* tile_element_insert(const CoordsXYZ& loc, int32_t occupiedQuadrants
         } while (!((newTileElement - 1)->IsLastForTile()));
     }
 
+    if (originalTileElement != nullptr)
+    {
+        FreeTileElements(originalTileElement - numElementsOnTileOld, numElementsOnTileOld);
+    }
+
     return insertedElement;
 }
 
@@ -1715,6 +1887,7 @@ static void clear_element_at(const CoordsXY& loc, TileElement** elementPtr)
             element->AsSurface()->SetOwnership(OWNERSHIP_UNOWNED);
             element->AsSurface()->SetParkFences(0);
             element->AsSurface()->SetWaterHeight(0);
+            park_size_invalidate(loc);
             // Because this element is not completely removed, the pointer must be updated manually
             // The rest of the elements are removed from the array, so the pointer doesn't need to be updated.
             (*elementPtr)++;
@@ -1779,6 +1952,7 @@ static void clear_element_at(const CoordsXY& loc, TileElement** elementPtr)
         }
         default:
             tile_element_remove(element);
+            pathfind_graph_invalidate(loc);
             break;
     }
 }
@@ -2189,7 +2363,7 @@ void map_clear_all_elements()
  */
 TrackElement* map_get_track_element_at(const CoordsXYZ& trackPos)
 {
-    TileElement* tileElement = map_get_first_element_at(trackPos);
+    TileElement* tileElement = map_get_first_element_of_type_at(trackPos, TileElementType::Track);
     if (tileElement == nullptr)
         return nullptr;
     do
@@ -2213,7 +2387,7 @@ TrackElement* map_get_track_element_at(const CoordsXYZ& trackPos)
  */
 TileElement* map_get_track_element_at_of_type(const CoordsXYZ& trackPos, track_type_t trackType)
 {
-    TileElement* tileElement = map_get_first_element_at(trackPos);
+    TileElement* tileElement = map_get_first_element_of_type_at(trackPos, TileElementType::Track);
     if (tileElement == nullptr)
         return nullptr;
     auto trackTilePos = TileCoordsXYZ{ trackPos };
@@ -2240,7 +2414,7 @@ TileElement* map_get_track_element_at_of_type(const CoordsXYZ& trackPos, track_t
  */
 TileElement* map_get_track_element_at_of_type_seq(const CoordsXYZ& trackPos, track_type_t trackType, int32_t sequence)
 {
-    TileElement* tileElement = map_get_first_element_at(trackPos);
+    TileElement* tileElement = map_get_first_element_of_type_at(trackPos, TileElementType::Track);
     auto trackTilePos = TileCoordsXYZ{ trackPos };
     do
     {
@@ -2263,7 +2437,7 @@ TileElement* map_get_track_element_at_of_type_seq(const CoordsXYZ& trackPos, tra
 
 TrackElement* map_get_track_element_at_of_type(const CoordsXYZD& location, track_type_t trackType)
 {
-    auto tileElement = map_get_first_element_at(location);
+    auto tileElement = map_get_first_element_of_type_at(location, TileElementType::Track);
     if (tileElement != nullptr)
     {
         do
@@ -2286,7 +2460,7 @@ TrackElement* map_get_track_element_at_of_type(const CoordsXYZD& location, track
 
 TrackElement* map_get_track_element_at_of_type_seq(const CoordsXYZD& location, track_type_t trackType, int32_t sequence)
 {
-    auto tileElement = map_get_first_element_at(location);
+    auto tileElement = map_get_first_element_of_type_at(location, TileElementType::Track);
     if (tileElement != nullptr)
     {
         do
@@ -2317,7 +2491,7 @@ TrackElement* map_get_track_element_at_of_type_seq(const CoordsXYZD& location, t
  */
 TileElement* map_get_track_element_at_of_type_from_ride(const CoordsXYZ& trackPos, track_type_t trackType, ride_id_t rideIndex)
 {
-    TileElement* tileElement = map_get_first_element_at(trackPos);
+    TileElement* tileElement = map_get_first_element_of_type_at(trackPos, TileElementType::Track);
     if (tileElement == nullptr)
         return nullptr;
     auto trackTilePos = TileCoordsXYZ{ trackPos };
@@ -2346,7 +2520,7 @@ TileElement* map_get_track_element_at_of_type_from_ride(const CoordsXYZ& trackPo
  */
 TileElement* map_get_track_element_at_from_ride(const CoordsXYZ& trackPos, ride_id_t rideIndex)
 {
-    TileElement* tileElement = map_get_first_element_at(trackPos);
+    TileElement* tileElement = map_get_first_element_of_type_at(trackPos, TileElementType::Track);
     if (tileElement == nullptr)
         return nullptr;
     auto trackTilePos = TileCoordsXYZ{ trackPos };
@@ -2374,7 +2548,7 @@ TileElement* map_get_track_element_at_from_ride(const CoordsXYZ& trackPos, ride_
  */
 TileElement* map_get_track_element_at_with_direction_from_ride(const CoordsXYZD& trackPos, ride_id_t rideIndex)
 {
-    TileElement* tileElement = map_get_first_element_at(trackPos);
+    TileElement* tileElement = map_get_first_element_of_type_at(trackPos, TileElementType::Track);
     if (tileElement == nullptr)
         return nullptr;
     auto trackTilePos = TileCoordsXYZ{ trackPos };
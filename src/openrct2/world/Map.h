@@ -138,6 +138,10 @@ extern const uint8_t tile_element_raise_styles[9][32];
 template<typename T> class TilePointerIndex
 {
     std::vector<T*> TilePointers;
+    // One bit per element type that may be on each tile. Bits are only cleared when the tile is rebuilt, so a
+    // set bit does not guarantee that the tile still holds an element of that type but a clear bit does guarantee
+    // that it does not.
+    std::vector<uint16_t> TileElementTypes;
     uint16_t MapSize{};
 
 public:
@@ -146,8 +150,9 @@ public:
     explicit TilePointerIndex(const uint16_t mapSize, T* tileElements)
     {
         MapSize = mapSize;
-        const uint16_t MaxTileElementPointers = MapSize * MapSize;
+        const size_t MaxTileElementPointers = MapSize * MapSize;
         TilePointers.reserve(MaxTileElementPointers);
+        TileElementTypes.reserve(MaxTileElementPointers);
 
         T* tileElement = tileElements;
         for (size_t y = 0; y < MapSize; y++)
@@ -155,12 +160,31 @@ public:
             for (size_t x = 0; x < MapSize; x++)
             {
                 TilePointers.emplace_back(tileElement);
+                TileElementTypes.emplace_back(GetElementTypes(tileElement));
                 while (!(tileElement++)->IsLastForTile())
                     ;
             }
         }
     }
 
+    static constexpr uint16_t GetElementTypeMask(uint8_t type)
+    {
+        return static_cast<uint16_t>(1 << (type >> 2));
+    }
+
+    static uint16_t GetElementTypes(const T* tileElement)
+    {
+        uint16_t types = 0;
+        if (tileElement != nullptr)
+        {
+            do
+            {
+                types |= GetElementTypeMask(tileElement->GetType());
+            } while (!(tileElement++)->IsLastForTile());
+        }
+        return types;
+    }
+
     T* GetFirstElementAt(TileCoordsXY coords)
     {
         return TilePointers[coords.x + (coords.y * MapSize)];
@@ -170,6 +194,24 @@ public:
     {
         TilePointers[coords.x + (coords.y * MapSize)] = tileElement;
     }
+
+    /**
+     * Returns false only if the tile definitely contains no element of the given type.
+     */
+    bool MayContainType(TileCoordsXY coords, uint8_t type) const
+    {
+        return (TileElementTypes[coords.x + (coords.y * MapSize)] & GetElementTypeMask(type)) != 0;
+    }
+
+    void AddType(TileCoordsXY coords, uint8_t type)
+    {
+        TileElementTypes[coords.x + (coords.y * MapSize)] |= GetElementTypeMask(type);
+    }
+
+    void UpdateTypes(TileCoordsXY coords)
+    {
+        TileElementTypes[coords.x + (coords.y * MapSize)] = GetElementTypes(GetFirstElementAt(coords));
+    }
 };
 
 void ReorganiseTileElements();
@@ -185,6 +227,8 @@ void map_strip_ghost_flag_from_elements();
 TileElement* map_get_first_element_at(const CoordsXY& elementPos);
 TileElement* map_get_nth_element_at(const CoordsXY& coords, int32_t n);
 void map_set_tile_element(const TileCoordsXY& tilePos, TileElement* elements);
+TileElement* map_get_first_element_of_type_at(const CoordsXY& elementPos, TileElementType type);
+void map_update_tile_element_types(const CoordsXY& elementPos);
 int32_t map_height_from_slope(const CoordsXY& coords, int32_t slopeDirection, bool isSloped);
 BannerElement* map_get_banner_element_at(const CoordsXYZ& bannerPos, uint8_t direction);
 SurfaceElement* map_get_surface_element_at(const CoordsXY& coords);
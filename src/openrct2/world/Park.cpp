@@ -12,6 +12,7 @@
 #include "../Cheats.h"
 #include "../Context.h"
 #include "../Date.h"
+#include "../Diagnostic.h"
 #include "../Game.h"
 #include "../GameState.h"
 #include "../OpenRCT2.h"
@@ -41,6 +42,8 @@
 #include "Surface.h"
 
 #include <algorithm>
+#include <array>
+#include <bitset>
 #include <limits>
 
 using namespace OpenRCT2;
@@ -65,6 +68,14 @@ uint8_t gGuestsInParkHistory[32];
 // If this value is more than or equal to 0, the park rating is forced to this value. Used for cheat
 static int32_t _forcedParkRating = -1;
 
+// The park size is kept as a count of owned tiles for each square region of the map. Only regions that have been
+// invalidated since the last calculation are scanned again.
+static constexpr int32_t ParkSizeRegionShift = 4;
+static constexpr int32_t ParkSizeRegionsPerRow = MAXIMUM_MAP_SIZE_TECHNICAL >> ParkSizeRegionShift;
+static constexpr int32_t ParkSizeRegionCount = ParkSizeRegionsPerRow * ParkSizeRegionsPerRow;
+static std::array<uint16_t, ParkSizeRegionCount> _parkSizeRegionTiles;
+static std::bitset<ParkSizeRegionCount> _parkSizeRegionDirty = std::bitset<ParkSizeRegionCount>().set();
+
 /**
  * In a difficult guest generation scenario, no guests will be generated if over this value.
  */
@@ -105,6 +116,9 @@ void park_set_open(bool open)
  */
 void update_park_fences(const CoordsXY& coords)
 {
+    // Fences are updated wherever the ownership of a tile changes
+    park_size_invalidate(coords);
+
     if (map_is_edge(coords))
         return;
 
@@ -337,21 +351,79 @@ void Park::Update(const Date& date)
     GenerateGuests();
 }
 
-int32_t Park::CalculateParkSize() const
+static bool park_size_is_tile_owned(const TileElement* element)
+{
+    return element->GetType() == TILE_ELEMENT_TYPE_SURFACE
+        && (element->AsSurface()->GetOwnership() & (OWNERSHIP_CONSTRUCTION_RIGHTS_OWNED | OWNERSHIP_OWNED));
+}
+
+static uint16_t park_size_count_region(int32_t region)
+{
+    const int32_t regionSize = 1 << ParkSizeRegionShift;
+    const int32_t left = (region % ParkSizeRegionsPerRow) << ParkSizeRegionShift;
+    const int32_t top = (region / ParkSizeRegionsPerRow) << ParkSizeRegionShift;
+
+    uint16_t tiles = 0;
+    for (int32_t y = top; y < top + regionSize; y++)
+    {
+        for (int32_t x = left; x < left + regionSize; x++)
+        {
+            const auto* element = map_get_first_element_at(TileCoordsXY{ x, y }.ToCoordsXY());
+            if (element == nullptr)
+                continue;
+
+            do
+            {
+                if (park_size_is_tile_owned(element))
+                {
+                    tiles++;
+                }
+            } while (!(element++)->IsLastForTile());
+        }
+    }
+    return tiles;
+}
+
+#if DEBUG_LEVEL_1
+static int32_t park_size_count_all()
 {
     int32_t tiles = 0;
     tile_element_iterator it;
     tile_element_iterator_begin(&it);
     do
     {
-        if (it.element->GetType() == TILE_ELEMENT_TYPE_SURFACE)
+        if (park_size_is_tile_owned(it.element))
         {
-            if (it.element->AsSurface()->GetOwnership() & (OWNERSHIP_CONSTRUCTION_RIGHTS_OWNED | OWNERSHIP_OWNED))
-            {
-                tiles++;
-            }
+            tiles++;
         }
     } while (tile_element_iterator_next(&it));
+    return tiles;
+}
+#endif
+
+int32_t Park::CalculateParkSize() const
+{
+    int32_t tiles = 0;
+    for (int32_t region = 0; region < ParkSizeRegionCount; region++)
+    {
+        if (_parkSizeRegionDirty[region])
+        {
+            _parkSizeRegionTiles[region] = park_size_count_region(region);
+        }
+        tiles += _parkSizeRegionTiles[region];
+    }
+    _parkSizeRegionDirty.reset();
+
+#if DEBUG_LEVEL_1
+    // Any mismatch means an ownership change was made without invalidating its region
+    auto fullMapTiles = park_size_count_all();
+    if (tiles != fullMapTiles)
+    {
+        log_error("Park size of %d tiles does not match the %d tiles found by scanning the whole map.", tiles, fullMapTiles);
+        park_size_invalidate_all();
+        tiles = fullMapTiles;
+    }
+#endif
 
     if (tiles != gParkSize)
     {
@@ -794,6 +866,22 @@ int32_t park_is_open()
     return GetContext()->GetGameState()->GetPark().IsOpen();
 }
 
+void park_size_invalidate(const CoordsXY& coords)
+{
+    auto tileCoords = TileCoordsXY(coords);
+    if (tileCoords.x < 0 || tileCoords.y < 0 || tileCoords.x >= MAXIMUM_MAP_SIZE_TECHNICAL
+        || tileCoords.y >= MAXIMUM_MAP_SIZE_TECHNICAL)
+        return;
+
+    auto region = (tileCoords.y >> ParkSizeRegionShift) * ParkSizeRegionsPerRow + (tileCoords.x >> ParkSizeRegionShift);
+    _parkSizeRegionDirty.set(region);
+}
+
+void park_size_invalidate_all()
+{
+    _parkSizeRegionDirty.set();
+}
+
 int32_t park_calculate_size()
 {
     auto tiles = GetContext()->GetGameState()->GetPark().CalculateParkSize();
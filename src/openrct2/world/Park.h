@@ -112,6 +112,13 @@ int32_t get_forced_park_rating();
 int32_t park_is_open();
 int32_t park_calculate_size();
 
+/**
+ * Marks the tile as needing to be scanned again for the next park size calculation. Must be called after changing the
+ * ownership of a surface element or adding / removing one. update_park_fences does this for the tile it is given.
+ */
+void park_size_invalidate(const CoordsXY& coords);
+void park_size_invalidate_all();
+
 void update_park_fences(const CoordsXY& coords);
 void update_park_fences_around_tile(const CoordsXY& coords);
 
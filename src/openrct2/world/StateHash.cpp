@@ -0,0 +1,269 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "StateHash.h"
+
+#include "../Game.h"
+#include "../core/ChecksumStream.h"
+#include "../core/DataSerialiser.h"
+#include "../core/JobPool.h"
+#include "../peep/Peep.h"
+#include "../ride/Vehicle.h"
+#include "Entity.h"
+#include "Litter.h"
+#include "Map.h"
+#include "Sprite.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#ifndef DISABLE_NETWORK
+
+// Number of ticks kept, so a client running behind the server can still compare its hashes with the server's
+constexpr size_t StateHashHistorySize = 256;
+
+constexpr uint64_t StateHashSeed = 0xcbf29ce484222325ULL;
+constexpr uint64_t StateHashPrime = 0x00000100000001B3ULL;
+
+struct EntityHashCache
+{
+    // The entity's memory when it was last serialised, Size is 0 if the slot held no hashed entity
+    std::array<std::byte, sizeof(rct_sprite)> Memory;
+    size_t Size;
+    uint64_t Hash;
+};
+
+static std::vector<EntityHashCache> _entityHashCache;
+static std::array<StateHashNodes, StateHashHistorySize> _stateHashHistory;
+
+static uint64_t StateHashCombine(uint64_t hash, uint64_t value)
+{
+    return (hash ^ value) * StateHashPrime;
+}
+
+template<typename T> static uint64_t StateHashEntity(SpriteBase* entity)
+{
+    rct_sprite_checksum checksum{};
+    OpenRCT2::ChecksumStream ms(checksum.raw);
+    DataSerialiser ds(true, ms);
+    static_cast<T*>(entity)->Serialise(ds);
+
+    uint64_t hash;
+    std::memcpy(&hash, checksum.raw.data(), sizeof(hash));
+    return hash;
+}
+
+/**
+ * Returns the hash of the entity in the given slot, or 0 if the slot does not hold one of the hashed types. These are
+ * the same types as in sprite_checksum.
+ */
+static uint64_t StateHashEntitySlot(size_t index)
+{
+    auto* entity = get_sprite(index);
+    auto& cache = _entityHashCache[index];
+
+    size_t size = 0;
+    uint64_t (*hashFn)(SpriteBase*) = nullptr;
+    switch (entity->Type)
+    {
+        case EntityType::Guest:
+            size = sizeof(Guest);
+            hashFn = StateHashEntity<Guest>;
+            break;
+        case EntityType::Staff:
+            size = sizeof(Staff);
+            hashFn = StateHashEntity<Staff>;
+            break;
+        case EntityType::Vehicle:
+            size = sizeof(Vehicle);
+            hashFn = StateHashEntity<Vehicle>;
+            break;
+        case EntityType::Litter:
+            size = sizeof(Litter);
+            hashFn = StateHashEntity<Litter>;
+            break;
+        default:
+            cache.Size = 0;
+            return 0;
+    }
+
+    // Entities are written to directly all over the game, so changes are found by comparing the memory with the copy
+    // taken when the entity was last serialised. That is much cheaper than serialising it again.
+    if (cache.Size != size || std::memcmp(cache.Memory.data(), entity, size) != 0)
+    {
+        std::memcpy(cache.Memory.data(), entity, size);
+        cache.Size = size;
+        cache.Hash = hashFn(entity);
+    }
+    return cache.Hash;
+}
+
+static uint64_t StateHashEntityBlock(size_t block)
+{
+    uint64_t hash = StateHashSeed;
+    const size_t begin = block * STATE_HASH_ENTITY_BLOCK_SIZE;
+    const size_t end = std::min<size_t>(begin + STATE_HASH_ENTITY_BLOCK_SIZE, MAX_ENTITIES);
+    for (size_t i = begin; i < end; i++)
+    {
+        auto entityHash = StateHashEntitySlot(i);
+        if (_entityHashCache[i].Size != 0)
+        {
+            hash = StateHashCombine(hash, i);
+            hash = StateHashCombine(hash, entityHash);
+        }
+    }
+    return hash;
+}
+
+static uint64_t StateHashTileElement(uint64_t hash, const TileElement& element)
+{
+    // Clear what the local player's construction previews change, the other peers do not have those
+    TileElement canonical = element;
+    canonical.SetLastForTile(false);
+    switch (canonical.GetType())
+    {
+        case TILE_ELEMENT_TYPE_PATH:
+        {
+            auto* pathElement = canonical.AsPath();
+            if (pathElement->AdditionIsGhost())
+            {
+                pathElement->SetAddition(0);
+                pathElement->SetAdditionIsGhost(false);
+            }
+            if (!pathElement->HasAddition())
+            {
+                pathElement->SetIsBroken(false);
+                if (!pathElement->IsQueue())
+                {
+                    pathElement->SetAdditionStatus(0);
+                }
+            }
+            break;
+        }
+        case TILE_ELEMENT_TYPE_TRACK:
+            canonical.AsTrack()->SetHighlight(false);
+            break;
+    }
+
+    uint64_t words[sizeof(TileElement) / sizeof(uint64_t)];
+    std::memcpy(words, &canonical, sizeof(words));
+    for (auto word : words)
+    {
+        hash = StateHashCombine(hash, word);
+    }
+    return hash;
+}
+
+static uint64_t StateHashMapRegion(int32_t regionX, int32_t regionY)
+{
+    uint64_t hash = StateHashSeed;
+    const int32_t endX = std::min<int32_t>((regionX + 1) * STATE_HASH_REGION_SIZE, gMapSize);
+    const int32_t endY = std::min<int32_t>((regionY + 1) * STATE_HASH_REGION_SIZE, gMapSize);
+    for (int32_t y = regionY * STATE_HASH_REGION_SIZE; y < endY; y++)
+    {
+        for (int32_t x = regionX * STATE_HASH_REGION_SIZE; x < endX; x++)
+        {
+            const auto* element = map_get_first_element_at(TileCoordsXY{ x, y }.ToCoordsXY());
+            if (element == nullptr)
+                continue;
+
+            // Ghosts only exist for the player placing them
+            uint64_t numElements = 0;
+            do
+            {
+                if (!element->IsGhost())
+                {
+                    hash = StateHashTileElement(hash, *element);
+                    numElements++;
+                }
+            } while (!(element++)->IsLastForTile());
+            hash = StateHashCombine(hash, numElements);
+        }
+    }
+    return hash;
+}
+
+void state_hash_update()
+{
+    if (_entityHashCache.empty())
+    {
+        _entityHashCache.resize(MAX_ENTITIES);
+    }
+
+    const size_t numBlocks = (MAX_ENTITIES + STATE_HASH_ENTITY_BLOCK_SIZE - 1) / STATE_HASH_ENTITY_BLOCK_SIZE;
+    const int32_t regionsPerSide = (gMapSize + STATE_HASH_REGION_SIZE - 1) / STATE_HASH_REGION_SIZE;
+    const size_t numRegions = static_cast<size_t>(regionsPerSide) * regionsPerSide;
+
+    auto& nodes = _stateHashHistory[gCurrentTicks % StateHashHistorySize];
+    nodes.Tick = gCurrentTicks;
+    nodes.EntityBlocks.resize(numBlocks);
+    nodes.MapRegions.resize(numRegions);
+
+    // Every block and region is independent of the others
+    JobPool jobs;
+    jobs.ParallelFor(
+        0, numBlocks + numRegions,
+        [&nodes, numBlocks, regionsPerSide](size_t index) {
+            if (index < numBlocks)
+            {
+                nodes.EntityBlocks[index] = StateHashEntityBlock(index);
+            }
+            else
+            {
+                const auto region = static_cast<int32_t>(index - numBlocks);
+                nodes.MapRegions[region] = StateHashMapRegion(region % regionsPerSide, region / regionsPerSide);
+            }
+        },
+        1);
+
+    uint64_t root = StateHashCombine(StateHashSeed, gMapSize);
+    for (auto blockHash : nodes.EntityBlocks)
+    {
+        root = StateHashCombine(root, blockHash);
+    }
+    for (auto regionHash : nodes.MapRegions)
+    {
+        root = StateHashCombine(root, regionHash);
+    }
+    nodes.Root = root;
+}
+
+const StateHashNodes* state_hash_get(uint32_t tick)
+{
+    const auto& nodes = _stateHashHistory[tick % StateHashHistorySize];
+    if (nodes.Tick != tick || nodes.MapRegions.empty())
+        return nullptr;
+    return &nodes;
+}
+
+void state_hash_reset()
+{
+    for (auto& nodes : _stateHashHistory)
+    {
+        nodes = {};
+    }
+}
+
+#else
+
+void state_hash_update()
+{
+}
+
+const StateHashNodes* state_hash_get(uint32_t tick)
+{
+    return nullptr;
+}
+
+void state_hash_reset()
+{
+}
+
+#endif // DISABLE_NETWORK
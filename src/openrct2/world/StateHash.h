@@ -0,0 +1,46 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+
+#include <vector>
+
+// Number of consecutive entity slots that share a block hash
+constexpr uint16_t STATE_HASH_ENTITY_BLOCK_SIZE = 64;
+// Width and length in tiles of the square map regions that each have their own hash
+constexpr int32_t STATE_HASH_REGION_SIZE = 16;
+
+/**
+ * The hashes of the guests, staff, vehicles, litter and tile elements at one tick. Each entity block and map region
+ * hash only changes when something inside it changes, so comparing them with another peer's shows where the two
+ * game states differ.
+ */
+struct StateHashNodes
+{
+    uint32_t Tick{};
+    uint64_t Root{};
+    std::vector<uint64_t> EntityBlocks;
+    std::vector<uint64_t> MapRegions;
+};
+
+/**
+ * Hashes the game state for the current tick. Entities are only serialised again when their memory has changed
+ * since the last update. Must be called while the provisional elements are removed from the map, so the hash is
+ * the same on every peer.
+ */
+void state_hash_update();
+
+/**
+ * Returns the hashes computed for the given tick, or nullptr if it is no longer in the history.
+ */
+const StateHashNodes* state_hash_get(uint32_t tick);
+
+void state_hash_reset();
@@ -111,14 +111,14 @@ namespace OpenRCT2
 
         Iterator begin() noexcept
         {
-            T* element = reinterpret_cast<T*>(map_get_first_element_at(_loc));
-
-            if constexpr (!std::is_same_v<T, TileElement>)
+            if constexpr (std::is_same_v<T, TileElement>)
             {
-                element = Detail::NextMatchingTile<T>(element);
+                return Iterator{ map_get_first_element_at(_loc) };
+            }
+            else
+            {
+                return Iterator{ reinterpret_cast<T*>(map_get_first_element_of_type_at(_loc, T::ElementType)) };
             }
-
-            return Iterator{ element };
         }
 
         Iterator end() noexcept
@@ -227,6 +227,7 @@ namespace OpenRCT2::TileInspector
 
             tile_element_remove(tileElement);
             map_invalidate_tile_full(loc);
+            park_size_invalidate(loc);
 
             if (auto* inspector = GetTileInspectorWithPos(loc); inspector != nullptr)
             {
@@ -395,7 +396,9 @@ namespace OpenRCT2::TileInspector
             *pastedElement = element;
             pastedElement->SetLastForTile(lastForTile);
 
+            map_update_tile_element_types(loc);
             map_invalidate_tile_full(loc);
+            park_size_invalidate(loc);
 
             if (auto* inspector = GetTileInspectorWithPos(loc); inspector != nullptr)
             {
@@ -0,0 +1,91 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <openrct2/world/EntityList.h>
+#include <openrct2/world/Litter.h>
+#include <openrct2/world/Sprite.h>
+#include <vector>
+
+class EntityListTests : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        reset_sprite_list();
+    }
+
+    void TearDown() override
+    {
+        reset_sprite_list();
+    }
+
+    static std::vector<uint16_t> CollectLitter()
+    {
+        std::vector<uint16_t> result;
+        for (auto* litter : EntityList<Litter>())
+        {
+            result.push_back(litter->sprite_index);
+        }
+        return result;
+    }
+};
+
+TEST_F(EntityListTests, iterates_in_sprite_index_order)
+{
+    for (uint16_t index : { 40, 3, 17, 9000, 0 })
+    {
+        ASSERT_NE(CreateEntityAt(index, EntityType::Litter), nullptr);
+    }
+
+    auto expected = std::vector<uint16_t>{ 0, 3, 17, 40, 9000 };
+    ASSERT_EQ(CollectLitter(), expected);
+    ASSERT_EQ(GetEntityList(EntityType::Litter), expected);
+    ASSERT_EQ(GetEntityListCount(EntityType::Litter), expected.size());
+}
+
+TEST_F(EntityListTests, remove_during_iteration)
+{
+    for (int32_t i = 0; i < 100; i++)
+    {
+        ASSERT_NE(CreateEntity(EntityType::Litter), nullptr);
+    }
+
+    // Removing the entity currently being visited must not skip or repeat any other entity
+    std::vector<uint16_t> visited;
+    for (auto* litter : EntityList<Litter>())
+    {
+        visited.push_back(litter->sprite_index);
+        if (litter->sprite_index % 2 == 0)
+        {
+            sprite_remove(litter);
+        }
+    }
+    ASSERT_EQ(visited.size(), 100U);
+    ASSERT_TRUE(std::is_sorted(visited.begin(), visited.end()));
+    ASSERT_EQ(GetEntityListCount(EntityType::Litter), 50);
+
+    // Removing entities ahead of the iterator means they are not visited
+    visited.clear();
+    for (auto* litter : EntityList<Litter>())
+    {
+        visited.push_back(litter->sprite_index);
+        for (auto* other : EntityList<Litter>())
+        {
+            if (other->sprite_index > litter->sprite_index)
+            {
+                sprite_remove(other);
+                break;
+            }
+        }
+    }
+    ASSERT_EQ(visited.size(), 25U);
+    ASSERT_EQ(CollectLitter(), visited);
+}
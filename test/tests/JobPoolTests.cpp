@@ -0,0 +1,121 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <openrct2/core/JobPool.h>
+#include <thread>
+#include <vector>
+
+TEST(JobPoolTest, add_task_and_join)
+{
+    std::atomic<int32_t> sum = { 0 };
+    int32_t completions = 0;
+
+    JobPool jobPool;
+    for (int32_t i = 0; i < 100; i++)
+    {
+        jobPool.AddTask([&sum, i]() { sum += i; }, [&completions]() { completions++; });
+    }
+    jobPool.Join();
+
+    ASSERT_EQ(sum, 4950);
+    // Completion callbacks are dispatched on the joining thread
+    ASSERT_EQ(completions, 100);
+    ASSERT_EQ(jobPool.CountPending(), 0U);
+}
+
+TEST(JobPoolTest, parallel_for)
+{
+    std::vector<size_t> values(10000);
+
+    JobPool jobPool;
+    jobPool.ParallelFor(0, values.size(), [&values](size_t i) { values[i] = i * 2; });
+
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        ASSERT_EQ(values[i], i * 2);
+    }
+}
+
+TEST(JobPoolTest, nested_parallel_for)
+{
+    std::atomic<size_t> count = { 0 };
+
+    JobPool jobPool;
+    jobPool.ParallelFor(
+        0, 16,
+        [&jobPool, &count](size_t) { jobPool.ParallelFor(0, 100, [&count](size_t) { count++; }); }, 1);
+
+    ASSERT_EQ(count, 1600U);
+}
+
+TEST(JobPoolTest, shared_between_threads)
+{
+    // Pools on different threads share the workers, but only wait for their own tasks
+    std::atomic<size_t> countA = { 0 };
+    std::atomic<size_t> countB = { 0 };
+
+    // gtest only reports failed assertions made on the test's own thread, so the other thread just records its count
+    size_t countBAfterJoin = 0;
+    std::thread other([&countB, &countBAfterJoin]() {
+        JobPool jobPool;
+        jobPool.ParallelFor(0, 5000, [&countB](size_t) { countB++; });
+        countBAfterJoin = countB;
+    });
+
+    JobPool jobPool;
+    jobPool.ParallelFor(0, 5000, [&countA](size_t) { countA++; });
+    ASSERT_EQ(countA, 5000U);
+
+    other.join();
+    ASSERT_EQ(countBAfterJoin, 5000U);
+}
+
+TEST(JobPoolTest, max_threads)
+{
+    std::atomic<size_t> running = { 0 };
+    std::atomic<size_t> mostRunning = { 0 };
+    std::atomic<size_t> count = { 0 };
+
+    JobPool jobPool(2);
+    for (int32_t i = 0; i < 64; i++)
+    {
+        jobPool.AddTask([&]() {
+            auto nowRunning = ++running;
+            auto previous = mostRunning.load();
+            while (nowRunning > previous && !mostRunning.compare_exchange_weak(previous, nowRunning))
+            {
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            count++;
+            running--;
+        });
+    }
+    jobPool.Join();
+
+    ASSERT_EQ(count, 64U);
+    ASSERT_LE(mostRunning, 2U);
+    ASSERT_EQ(jobPool.CountPending(), 0U);
+}
+
+TEST(JobPoolTest, serial)
+{
+    std::vector<int32_t> order;
+
+    JobPool jobPool(1);
+    for (int32_t i = 0; i < 10; i++)
+    {
+        jobPool.AddTask([&order, i]() { order.push_back(i); });
+    }
+    jobPool.Join();
+
+    ASSERT_EQ(order, (std::vector<int32_t>{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }));
+}
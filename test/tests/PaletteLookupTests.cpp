@@ -0,0 +1,82 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <openrct2/drawing/Drawing.h>
+#include <openrct2/util/Util.h>
+#include <random>
+#include <vector>
+
+using PaletteLookupFunction = decltype(palette_lookup_fn);
+
+class PaletteLookupTest : public testing::Test
+{
+protected:
+    static constexpr int32_t MaxWidth = 70;
+    static constexpr int32_t Height = 4;
+    // Space around each row, so writing past the end of a row shows up as a difference
+    static constexpr int32_t Wrap = 5;
+    static constexpr int32_t MaxOffset = 7;
+    static constexpr size_t BufferSize = (MaxWidth + Wrap) * Height + MaxOffset;
+
+    std::vector<uint8_t> _src = std::vector<uint8_t>(BufferSize);
+    std::vector<uint32_t> _dst = std::vector<uint32_t>(BufferSize);
+    std::vector<uint32_t> _palette = std::vector<uint32_t>(256);
+
+    void SetUp() override
+    {
+        // The rows of the widest image count up through every index, the bytes in between are random
+        std::mt19937 random(1234);
+        for (auto& pixel : _src)
+            pixel = static_cast<uint8_t>(random());
+        uint8_t index = 0;
+        for (int32_t y = 0; y < Height; y++)
+        {
+            for (int32_t x = 0; x < MaxWidth; x++)
+                _src[y * (MaxWidth + Wrap) + x] = index++;
+        }
+        for (auto& pixel : _dst)
+            pixel = static_cast<uint32_t>(random());
+        for (auto& entry : _palette)
+            entry = static_cast<uint32_t>(random());
+    }
+
+    void CompareWithScalar(PaletteLookupFunction function)
+    {
+        for (int32_t width = 0; width <= MaxWidth; width++)
+        {
+            // The offsets leave the source and destination rows unaligned for the vector loads and stores
+            for (int32_t srcOffset : { 0, 1, 3, 7 })
+            {
+                for (int32_t dstOffset : { 0, 1, 3 })
+                {
+                    auto expected = _dst;
+                    auto actual = _dst;
+                    palette_lookup_scalar(
+                        width, Height, _src.data() + srcOffset, expected.data() + dstOffset, _palette.data(), Wrap, Wrap);
+                    function(width, Height, _src.data() + srcOffset, actual.data() + dstOffset, _palette.data(), Wrap, Wrap);
+                    ASSERT_EQ(expected, actual) << "width " << width << ", source offset " << srcOffset
+                                                << ", destination offset " << dstOffset;
+                }
+            }
+        }
+    }
+};
+
+TEST_F(PaletteLookupTest, sse4_1_matches_scalar)
+{
+    if (sse41_available())
+        CompareWithScalar(palette_lookup_sse4_1);
+}
+
+TEST_F(PaletteLookupTest, avx2_matches_scalar)
+{
+    if (avx2_available())
+        CompareWithScalar(palette_lookup_avx2);
+}
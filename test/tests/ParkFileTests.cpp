@@ -0,0 +1,178 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <memory>
+#include <openrct2/ParkFile.h>
+#include <openrct2/core/File.h>
+#include <openrct2/core/FileSystem.hpp>
+#include <openrct2/core/MemoryStream.h>
+#include <openrct2/scenario/Scenario.h>
+#include <random>
+#include <vector>
+
+using namespace OpenRCT2;
+
+class ParkFileTest : public testing::Test
+{
+protected:
+    // Repeats, so it compresses
+    std::vector<uint8_t> _tiles = std::vector<uint8_t>(100000);
+    // Random, so it does not
+    std::vector<uint8_t> _entities = std::vector<uint8_t>(5000);
+    ParkPreview _preview;
+
+    void SetUp() override
+    {
+        for (size_t i = 0; i < _tiles.size(); i++)
+            _tiles[i] = static_cast<uint8_t>(i / 100);
+        std::mt19937 random(1234);
+        for (auto& value : _entities)
+            value = static_cast<uint8_t>(random());
+
+        _preview.Type = S6_TYPE_SCENARIO;
+        _preview.ParkName = "Test Park";
+        _preview.ScenarioName = "Test Scenario";
+        _preview.ScenarioDetails = "Details";
+        _preview.Category = 2;
+        _preview.ObjectiveType = 3;
+        _preview.ObjectiveArg1 = 4;
+        _preview.ObjectiveArg2 = 100000;
+        _preview.ObjectiveArg3 = 1000;
+        _preview.MonthsElapsed = 17;
+        _preview.Cash = 123456;
+        _preview.NumGuests = 789;
+        _preview.ParkRating = 600;
+        _preview.MapSize = 128;
+    }
+
+    MemoryStream Write()
+    {
+        ParkFileWriter writer(S6_TYPE_SCENARIO);
+        writer.AddPreview(_preview);
+        writer.AddSection(ParkFileSection::Tiles, _tiles.data(), _tiles.size());
+        writer.AddSection(ParkFileSection::Entities, std::vector<uint8_t>(_entities));
+
+        MemoryStream ms;
+        writer.Write(&ms);
+        ms.SetPosition(0);
+        return ms;
+    }
+
+    const ParkFileSectionEntry& GetEntry(const MemoryStream& ms, size_t index)
+    {
+        const auto* data = static_cast<const uint8_t*>(ms.GetData());
+        return *reinterpret_cast<const ParkFileSectionEntry*>(
+            data + sizeof(ParkFileHeader) + index * sizeof(ParkFileSectionEntry));
+    }
+};
+
+TEST_F(ParkFileTest, sections_read_back)
+{
+    auto ms = Write();
+    ASSERT_TRUE(ParkFileReader::IsParkFile(&ms));
+    ASSERT_EQ(ms.GetPosition(), 0U);
+
+    ParkFileReader reader(&ms);
+    ASSERT_EQ(reader.GetHeader().Type, S6_TYPE_SCENARIO);
+    ASSERT_EQ(reader.GetHeader().Version, PARK_FILE_CURRENT_VERSION);
+    ASSERT_TRUE(reader.HasSection(ParkFileSection::Tiles));
+    ASSERT_FALSE(reader.HasSection(ParkFileSection::Rides));
+    ASSERT_EQ(reader.ReadSection(ParkFileSection::Tiles), _tiles);
+    ASSERT_EQ(reader.ReadSection(ParkFileSection::Entities), _entities);
+    ASSERT_THROW(reader.ReadSection(ParkFileSection::Rides), IOException);
+
+    // Sections that do not get smaller are stored as they are
+    ASSERT_EQ(GetEntry(ms, 1).Compression, ParkFileCompression::Zlib);
+    ASSERT_LT(GetEntry(ms, 1).Length, _tiles.size());
+    ASSERT_EQ(GetEntry(ms, 2).Compression, ParkFileCompression::None);
+}
+
+TEST_F(ParkFileTest, preview_read_back)
+{
+    auto ms = Write();
+    ParkFileReader reader(&ms);
+    auto preview = reader.ReadPreview();
+    ASSERT_EQ(preview.Type, _preview.Type);
+    ASSERT_EQ(preview.ParkName, _preview.ParkName);
+    ASSERT_EQ(preview.ScenarioName, _preview.ScenarioName);
+    ASSERT_EQ(preview.ScenarioDetails, _preview.ScenarioDetails);
+    ASSERT_EQ(preview.Category, _preview.Category);
+    ASSERT_EQ(preview.ObjectiveType, _preview.ObjectiveType);
+    ASSERT_EQ(preview.ObjectiveArg1, _preview.ObjectiveArg1);
+    ASSERT_EQ(preview.ObjectiveArg2, _preview.ObjectiveArg2);
+    ASSERT_EQ(preview.ObjectiveArg3, _preview.ObjectiveArg3);
+    ASSERT_EQ(preview.MonthsElapsed, _preview.MonthsElapsed);
+    ASSERT_EQ(preview.Cash, _preview.Cash);
+    ASSERT_EQ(preview.NumGuests, _preview.NumGuests);
+    ASSERT_EQ(preview.ParkRating, _preview.ParkRating);
+    ASSERT_EQ(preview.MapSize, _preview.MapSize);
+}
+
+TEST_F(ParkFileTest, damaged_section_is_detected)
+{
+    auto ms = Write();
+    auto& tilesEntry = GetEntry(ms, 1);
+    auto* data = static_cast<uint8_t*>(const_cast<void*>(ms.GetData()));
+    data[tilesEntry.Offset + tilesEntry.Length / 2] ^= 0xFF;
+
+    // The other sections can still be read
+    ParkFileReader reader(&ms);
+    ASSERT_THROW(reader.ReadSection(ParkFileSection::Tiles), IOException);
+    ASSERT_EQ(reader.ReadSection(ParkFileSection::Entities), _entities);
+    ASSERT_EQ(reader.ReadPreview().ParkName, _preview.ParkName);
+}
+
+TEST_F(ParkFileTest, truncated_file_is_rejected)
+{
+    auto ms = Write();
+    MemoryStream truncated(ms.GetData(), static_cast<size_t>(ms.GetLength() - 1));
+    ASSERT_THROW(ParkFileReader reader(&truncated), IOException);
+
+    MemoryStream notParkFile(_tiles.data(), _tiles.size());
+    ASSERT_FALSE(ParkFileReader::IsParkFile(&notParkFile));
+    ASSERT_THROW(ParkFileReader reader(&notParkFile), IOException);
+}
+
+TEST_F(ParkFileTest, mapped_file_read_back)
+{
+    auto path = (fs::temp_directory_path() / "park_file_test.park").u8string();
+    {
+        auto ms = Write();
+        File::WriteAllBytes(path, ms.GetData(), static_cast<size_t>(ms.GetLength()));
+    }
+    {
+        ASSERT_TRUE(ParkFileReader::ExtensionIsParkFile(path));
+        ParkFileReader reader(path);
+        ASSERT_EQ(reader.ReadSection(ParkFileSection::Tiles), _tiles);
+        ASSERT_EQ(reader.ReadPreview().ScenarioName, _preview.ScenarioName);
+    }
+    File::Delete(path);
+}
+
+TEST_F(ParkFileTest, s6_data_read_back)
+{
+    auto s6 = std::make_unique<rct_s6_data>();
+    auto* s6Data = reinterpret_cast<uint8_t*>(s6.get());
+    std::mt19937 random(5678);
+    for (size_t i = 0; i < sizeof(rct_s6_data); i++)
+        s6Data[i] = static_cast<uint8_t>(random() % 4);
+
+    ParkFileWriter writer(S6_TYPE_SAVEDGAME);
+    writer.AddS6Data(*s6);
+    MemoryStream ms;
+    writer.Write(&ms);
+    ms.SetPosition(0);
+
+    auto readS6 = std::make_unique<rct_s6_data>();
+    ParkFileReader reader(&ms);
+    reader.ReadS6Data(*readS6);
+    ASSERT_EQ(std::memcmp(s6.get(), readS6.get(), sizeof(rct_s6_data)), 0);
+}
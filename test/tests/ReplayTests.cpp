@@ -14,7 +14,9 @@
 #include <openrct2/Game.h>
 #include <openrct2/GameState.h>
 #include <openrct2/OpenRCT2.h>
+#include <openrct2/PlatformEnvironment.h>
 #include <openrct2/ReplayManager.h>
+#include <openrct2/actions/StaffHireNewAction.h>
 #include <openrct2/audio/AudioContext.h>
 #include <openrct2/core/File.h>
 #include <openrct2/core/FileScanner.h>
@@ -22,6 +24,7 @@
 #include <openrct2/core/String.hpp>
 #include <openrct2/platform/platform.h>
 #include <openrct2/ride/Ride.h>
+#include <openrct2/world/Park.h>
 #include <string>
 
 using namespace OpenRCT2;
@@ -101,6 +104,71 @@ TEST_P(ReplayTests, RunReplay)
     ASSERT_FALSE(replayManager->IsPlaybackStateMismatching());
 }
 
+TEST(ReplaySeekTests, SeekToCheckpointWithCommandOnItsTick)
+{
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+    core_init();
+
+    auto context = CreateContext();
+    bool initialised = context->Initialise();
+    ASSERT_TRUE(initialised);
+
+    auto gs = context->GetGameState();
+    ASSERT_NE(gs, nullptr);
+
+    IReplayManager* replayManager = context->GetReplayManager();
+    ASSERT_NE(replayManager, nullptr);
+
+    std::string parkPath = TestData::GetParkPath("bpb.sv6");
+    load_from_sv6(parkPath.c_str());
+    game_load_init();
+    gParkFlags |= PARK_FLAGS_NO_MONEY;
+
+    auto replayDirectory = context->GetPlatformEnvironment()->GetDirectoryPath(DIRBASE::USER, DIRID::REPLAY);
+    Path::CreateDirectory(replayDirectory);
+    auto replayPath = Path::Combine(replayDirectory, "seek_test.sv6r");
+    bool startedRecording = replayManager->StartRecording(replayPath);
+    ASSERT_TRUE(startedRecording);
+
+    const uint32_t checkpointTick = gCurrentTicks + k_ReplayCheckpointTicks;
+    while (gCurrentTicks < checkpointTick)
+    {
+        gs->UpdateLogic();
+    }
+
+    // Issued between two ticks like any player action, so it is recorded for the checkpoint's tick and is already
+    // part of the checkpoint once that tick starts. Hiring is not idempotent, running it again changes the state.
+    StaffHireNewAction hireAction(true, StaffType::Handyman, EntertainerCostume::Count, 0);
+    auto hireResult = GameActions::Execute(&hireAction);
+    ASSERT_EQ(hireResult->Error, GameActions::Status::Ok);
+
+    for (int i = 0; i < 200; i++)
+    {
+        gs->UpdateLogic();
+    }
+
+    ReplayRecordInfo recordInfo;
+    ASSERT_TRUE(replayManager->GetCurrentReplayInfo(recordInfo));
+    ASSERT_EQ(recordInfo.NumCheckpoints, 1u);
+    ASSERT_TRUE(replayManager->StopRecording());
+
+    bool startedReplay = replayManager->StartPlayback(replayPath, checkpointTick);
+    ASSERT_TRUE(startedReplay);
+    ASSERT_EQ(gCurrentTicks, checkpointTick);
+
+    while (replayManager->IsReplaying())
+    {
+        gs->UpdateLogic();
+        if (replayManager->IsPlaybackStateMismatching())
+            break;
+    }
+    File::Delete(replayPath);
+
+    ASSERT_FALSE(replayManager->IsReplaying());
+    ASSERT_FALSE(replayManager->IsPlaybackStateMismatching());
+}
+
 static void PrintTo(const ReplayTestData& testData, std::ostream* os)
 {
     *os << testData.filePath;
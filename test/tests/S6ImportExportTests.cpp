@@ -98,6 +98,18 @@ static bool ExportSave(MemoryStream& stream, std::unique_ptr<IContext>& context)
     return true;
 }
 
+static bool ExportParkFile(MemoryStream& stream, std::unique_ptr<IContext>& context)
+{
+    auto& objManager = context->GetObjectManager();
+
+    auto exporter = std::make_unique<S6Exporter>();
+    exporter->ExportObjectsList = objManager.GetPackableObjects();
+    exporter->Export();
+    exporter->SaveParkFile(&stream, false);
+
+    return true;
+}
+
 static void RecordGameStateSnapshot(std::unique_ptr<IContext>& context, MemoryStream& snapshotStream)
 {
     auto* snapshots = context->GetGameStateSnapshots();
@@ -210,6 +222,52 @@ TEST(S6ImportExportBasic, all)
     SUCCEED();
 }
 
+TEST(ParkFileImportExportBasic, all)
+{
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    core_init();
+
+    MemoryStream importBuffer;
+    MemoryStream exportBuffer;
+    MemoryStream snapshotStream;
+
+    // Load initial park data.
+    {
+        std::unique_ptr<IContext> context = CreateContext();
+        EXPECT_NE(context, nullptr);
+
+        bool initialised = context->Initialise();
+        ASSERT_TRUE(initialised);
+
+        std::string testParkPath = TestData::GetParkPath("BigMapTest.sv6");
+        ASSERT_TRUE(LoadFileToBuffer(importBuffer, testParkPath));
+        ASSERT_TRUE(ImportSave(importBuffer, context, false));
+        RecordGameStateSnapshot(context, snapshotStream);
+
+        ASSERT_TRUE(ExportParkFile(exportBuffer, context));
+    }
+
+    // Import the exported version.
+    {
+        std::unique_ptr<IContext> context = CreateContext();
+        EXPECT_NE(context, nullptr);
+
+        bool initialised = context->Initialise();
+        ASSERT_TRUE(initialised);
+
+        ASSERT_TRUE(ImportSave(exportBuffer, context, true));
+
+        RecordGameStateSnapshot(context, snapshotStream);
+    }
+
+    snapshotStream.SetPosition(0);
+    CompareStates(importBuffer, exportBuffer, snapshotStream);
+
+    SUCCEED();
+}
+
 TEST(S6ImportExportAdvanceTicks, all)
 {
     gOpenRCT2Headless = true;
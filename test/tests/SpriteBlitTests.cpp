@@ -0,0 +1,188 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <openrct2/drawing/Drawing.h>
+#include <openrct2/util/Util.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using BlitRowTableFunction = void (*)(const uint8_t*, uint8_t*, const uint8_t*, int32_t);
+
+class SpriteBlitTest : public testing::Test
+{
+protected:
+    static constexpr int32_t RowLengths[] = { 0, 1, 15, 16, 17, 31, 32, 33, 100, 127, 1000 };
+
+    std::vector<uint8_t> _src = std::vector<uint8_t>(1024 + 8);
+    std::vector<uint8_t> _dst = std::vector<uint8_t>(1024 + 8);
+    std::vector<uint8_t> _table = std::vector<uint8_t>(256);
+
+    void SetUp() override
+    {
+        // Plenty of zeros in the source and the table so every transparency case is covered
+        std::mt19937 random(1234);
+        for (auto& pixel : _src)
+            pixel = random() % 4 == 0 ? 0 : static_cast<uint8_t>(random());
+        for (auto& pixel : _dst)
+            pixel = static_cast<uint8_t>(random());
+        for (auto& entry : _table)
+            entry = random() % 8 == 0 ? 0 : static_cast<uint8_t>(random());
+    }
+
+    void CompareTableFunctions(BlitRowTableFunction reference, BlitRowTableFunction function)
+    {
+        for (auto length : RowLengths)
+        {
+            // Also start at an unaligned offset
+            for (int32_t offset : { 0, 3 })
+            {
+                auto expected = _dst;
+                auto actual = _dst;
+                reference(_src.data() + offset, expected.data() + offset, _table.data(), length);
+                function(_src.data() + offset, actual.data() + offset, _table.data(), length);
+                ASSERT_EQ(expected, actual) << "length " << length << ", offset " << offset;
+            }
+        }
+    }
+};
+
+TEST_F(SpriteBlitTest, transparent_matches_scalar)
+{
+    std::vector<void (*)(const uint8_t*, uint8_t*, int32_t)> functions;
+    if (sse41_available())
+        functions.push_back(blit_row_transparent_sse4_1);
+    if (avx2_available())
+        functions.push_back(blit_row_transparent_avx2);
+
+    for (auto function : functions)
+    {
+        for (auto length : RowLengths)
+        {
+            auto expected = _dst;
+            auto actual = _dst;
+            blit_row_transparent_scalar(_src.data(), expected.data(), length);
+            function(_src.data(), actual.data(), length);
+            ASSERT_EQ(expected, actual) << "length " << length;
+        }
+    }
+}
+
+TEST_F(SpriteBlitTest, remap_matches_scalar)
+{
+    if (sse41_available())
+        CompareTableFunctions(blit_row_remap_scalar, blit_row_remap_sse4_1);
+    if (avx2_available())
+        CompareTableFunctions(blit_row_remap_scalar, blit_row_remap_avx2);
+}
+
+TEST_F(SpriteBlitTest, glass_matches_scalar)
+{
+    if (sse41_available())
+        CompareTableFunctions(blit_row_glass_scalar, blit_row_glass_sse4_1);
+    if (avx2_available())
+        CompareTableFunctions(blit_row_glass_scalar, blit_row_glass_avx2);
+}
+
+TEST_F(SpriteBlitTest, scalar_matches_blit_pixel)
+{
+    // The kernels are only used in place of BlitPixel, so the reference has to agree with it
+    uint8_t mapData[256];
+    std::copy(_table.begin(), _table.end(), mapData);
+    PaletteMap paletteMap(mapData);
+
+    auto expected = _dst;
+    auto actual = _dst;
+    for (size_t i = 0; i < 1024; i++)
+        BlitPixel<BLEND_TRANSPARENT | BLEND_SRC>(&_src[i], &expected[i], paletteMap);
+    blit_row_remap_scalar(_src.data(), actual.data(), _table.data(), 1024);
+    ASSERT_EQ(expected, actual);
+
+    expected = _dst;
+    actual = _dst;
+    for (size_t i = 0; i < 1024; i++)
+        BlitPixel<BLEND_TRANSPARENT | BLEND_DST>(&_src[i], &expected[i], paletteMap);
+    blit_row_glass_scalar(_src.data(), actual.data(), _table.data(), 1024);
+    ASSERT_EQ(expected, actual);
+}
+
+TEST_F(SpriteBlitTest, mipmap_matches_minify)
+{
+    blit_row_init();
+
+    // An RLE image made of short runs with gaps, using the source pixels as the run data
+    constexpr int32_t ImageWidth = 31;
+    constexpr int32_t ImageHeight = 29;
+    std::vector<uint8_t> rleData(ImageHeight * 2);
+    size_t srcIndex = 0;
+    for (int32_t y = 0; y < ImageHeight; y++)
+    {
+        rleData[y * 2] = static_cast<uint8_t>(rleData.size());
+        rleData[y * 2 + 1] = static_cast<uint8_t>(rleData.size() >> 8);
+        for (int32_t x = y % 5; x < ImageWidth; x += 9)
+        {
+            auto runLength = std::min(6, ImageWidth - x);
+            rleData.push_back(static_cast<uint8_t>(runLength | (x + 9 >= ImageWidth ? 0x80 : 0)));
+            rleData.push_back(static_cast<uint8_t>(x));
+            rleData.insert(rleData.end(), _src.begin() + srcIndex, _src.begin() + srcIndex + runLength);
+            srcIndex += runLength;
+        }
+    }
+
+    rct_g1_element rleImage{};
+    rleImage.offset = rleData.data();
+    rleImage.width = ImageWidth;
+    rleImage.height = ImageHeight;
+    rleImage.x_offset = -15;
+    rleImage.y_offset = -20;
+    rleImage.flags = G1_FLAG_RLE_COMPRESSION;
+
+    rct_g1_element bmpImage = rleImage;
+    bmpImage.offset = _src.data();
+    bmpImage.flags = G1_FLAG_BMP;
+
+    uint8_t mapData[256];
+    std::copy(_table.begin(), _table.end(), mapData);
+    PaletteMap paletteMap(mapData);
+
+    uint32_t imageIndex = 1;
+    for (const auto& image : { rleImage, bmpImage })
+    {
+        for (int8_t zoomLevel = 2; zoomLevel <= 3; zoomLevel++)
+        {
+            for (auto imageId : { ImageId(imageIndex), ImageId(imageIndex, COLOUR_BRIGHT_RED) })
+            {
+                // Cover every row phase and clipping on all sides of a small drawing area
+                rct_drawpixelinfo dpi;
+                dpi.x = 8 << zoomLevel;
+                dpi.y = 4 << zoomLevel;
+                dpi.width = 12 << zoomLevel;
+                dpi.height = 10 << zoomLevel;
+                dpi.pitch = 3;
+                dpi.zoom_level = zoomLevel;
+                for (int32_t y = dpi.y - 40; y < dpi.y + dpi.height + 40; y += 3)
+                {
+                    for (int32_t x = dpi.x - 40; x < dpi.x + dpi.width + 40; x += 7)
+                    {
+                        auto expected = _dst;
+                        auto actual = _dst;
+                        dpi.bits = expected.data();
+                        gfx_draw_sprite_element_software(&dpi, imageId, image, { x, y }, paletteMap);
+                        dpi.bits = actual.data();
+                        ASSERT_TRUE(gfx_draw_sprite_mipmap_software(&dpi, imageId, image, { x, y }, paletteMap));
+                        ASSERT_EQ(expected, actual) << "zoom " << static_cast<int32_t>(zoomLevel) << " at " << x << ", " << y;
+                    }
+                }
+            }
+        }
+        gfx_sprite_mipmap_invalidate(imageIndex);
+        imageIndex++;
+    }
+}
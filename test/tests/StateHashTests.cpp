@@ -0,0 +1,149 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+
+#include <gtest/gtest.h>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/ParkImporter.h>
+#include <openrct2/peep/Peep.h>
+#include <openrct2/world/EntityList.h>
+#include <openrct2/world/Map.h>
+#include <openrct2/world/StateHash.h>
+#include <openrct2/world/Surface.h>
+
+using namespace OpenRCT2;
+
+class StateHashTest : public testing::Test
+{
+protected:
+    static void SetUpTestCase()
+    {
+        std::string parkPath = TestData::GetParkPath("bpb.sv6");
+        gOpenRCT2Headless = true;
+        gOpenRCT2NoGraphics = true;
+        _context = CreateContext();
+        bool initialised = _context->Initialise();
+        ASSERT_TRUE(initialised);
+
+        load_from_sv6(parkPath.c_str());
+        game_load_init();
+    }
+
+    static void TearDownTestCase()
+    {
+        if (_context)
+            _context.reset();
+    }
+
+    // Hashes the state as the next tick
+    static StateHashNodes UpdateStateHash()
+    {
+        gCurrentTicks++;
+        state_hash_update();
+        const auto* stateHash = state_hash_get(gCurrentTicks);
+        EXPECT_NE(stateHash, nullptr);
+        return stateHash != nullptr ? *stateHash : StateHashNodes{};
+    }
+
+    static std::vector<size_t> GetDifferences(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b)
+    {
+        std::vector<size_t> result;
+        EXPECT_EQ(a.size(), b.size());
+        for (size_t i = 0; i < std::min(a.size(), b.size()); i++)
+        {
+            if (a[i] != b[i])
+                result.push_back(i);
+        }
+        return result;
+    }
+
+private:
+    static std::shared_ptr<IContext> _context;
+};
+
+std::shared_ptr<IContext> StateHashTest::_context;
+
+TEST_F(StateHashTest, UnchangedState)
+{
+    auto before = UpdateStateHash();
+    auto after = UpdateStateHash();
+    EXPECT_EQ(before.Root, after.Root);
+    EXPECT_EQ(before.EntityBlocks, after.EntityBlocks);
+    EXPECT_EQ(before.MapRegions, after.MapRegions);
+}
+
+TEST_F(StateHashTest, HistoryKeepsEarlierTicks)
+{
+    auto before = UpdateStateHash();
+    UpdateStateHash();
+    const auto* stateHash = state_hash_get(before.Tick);
+    ASSERT_NE(stateHash, nullptr);
+    EXPECT_EQ(stateHash->Root, before.Root);
+    EXPECT_EQ(state_hash_get(gCurrentTicks + 1), nullptr);
+}
+
+TEST_F(StateHashTest, ChangedEntityOnlyChangesItsBlock)
+{
+    ASSERT_NE(GetEntityListCount(EntityType::Guest), 0);
+    auto* guest = *EntityList<Guest>().begin();
+
+    auto before = UpdateStateHash();
+    guest->Energy++;
+    auto after = UpdateStateHash();
+    guest->Energy--;
+
+    EXPECT_NE(before.Root, after.Root);
+    const size_t block = guest->sprite_index / STATE_HASH_ENTITY_BLOCK_SIZE;
+    EXPECT_EQ(GetDifferences(before.EntityBlocks, after.EntityBlocks), std::vector<size_t>{ block });
+    EXPECT_TRUE(GetDifferences(before.MapRegions, after.MapRegions).empty());
+
+    // The cached hash has to follow the entity back to its old value
+    auto restored = UpdateStateHash();
+    EXPECT_EQ(before.Root, restored.Root);
+}
+
+TEST_F(StateHashTest, ChangedTileOnlyChangesItsRegion)
+{
+    const TileCoordsXY tile{ 40, 20 };
+    auto* surfaceElement = map_get_surface_element_at(tile.ToCoordsXY());
+    ASSERT_NE(surfaceElement, nullptr);
+    const auto grassLength = surfaceElement->GetGrassLength();
+
+    auto before = UpdateStateHash();
+    surfaceElement->SetGrassLength(grassLength == GRASS_LENGTH_CLEAR_0 ? GRASS_LENGTH_MOWED : GRASS_LENGTH_CLEAR_0);
+    auto after = UpdateStateHash();
+    surfaceElement->SetGrassLength(grassLength);
+
+    const int32_t regionsPerSide = (gMapSize + STATE_HASH_REGION_SIZE - 1) / STATE_HASH_REGION_SIZE;
+    const size_t region = (tile.y / STATE_HASH_REGION_SIZE) * regionsPerSide + tile.x / STATE_HASH_REGION_SIZE;
+    EXPECT_NE(before.Root, after.Root);
+    EXPECT_EQ(GetDifferences(before.MapRegions, after.MapRegions), std::vector<size_t>{ region });
+    EXPECT_TRUE(GetDifferences(before.EntityBlocks, after.EntityBlocks).empty());
+}
+
+TEST_F(StateHashTest, GhostsAreNotHashed)
+{
+    const TileCoordsXY tile{ 40, 20 };
+    auto* surfaceElement = map_get_surface_element_at(tile.ToCoordsXY());
+    ASSERT_NE(surfaceElement, nullptr);
+
+    auto before = UpdateStateHash();
+    // Placed on top of everything else on the tile, which also moves the last element flag
+    auto* ghost = tile_element_insert(
+        { tile.ToCoordsXY(), surfaceElement->GetBaseZ() + 20 * COORDS_Z_STEP }, 0b1111, TileElementType::SmallScenery);
+    ASSERT_NE(ghost, nullptr);
+    ghost->SetGhost(true);
+    auto after = UpdateStateHash();
+    tile_element_remove(ghost);
+
+    EXPECT_EQ(before.Root, after.Root);
+}
@@ -16,6 +16,7 @@
 #include <openrct2/ParkImporter.h>
 #include <openrct2/world/Footpath.h>
 #include <openrct2/world/Map.h>
+#include <openrct2/world/TileElementsView.h>
 
 using namespace OpenRCT2;
 
@@ -171,3 +172,61 @@ TEST_F(TileElementWantsFootpathConnection, MapEdge)
     // The tile in the -X direction is a normal tile and should not be marked as an edge
     EXPECT_FALSE(edges & (1 << 2));
 }
+
+class TileElementTypeIndex : public testing::Test
+{
+protected:
+    static void SetUpTestCase()
+    {
+        std::string parkPath = TestData::GetParkPath("bpb.sv6");
+        gOpenRCT2Headless = true;
+        gOpenRCT2NoGraphics = true;
+        _context = CreateContext();
+        bool initialised = _context->Initialise();
+        ASSERT_TRUE(initialised);
+
+        load_from_sv6(parkPath.c_str());
+        game_load_init();
+        SUCCEED();
+    }
+
+    static void TearDownTestCase()
+    {
+        if (_context)
+            _context.reset();
+    }
+
+private:
+    static std::shared_ptr<IContext> _context;
+};
+
+std::shared_ptr<IContext> TileElementTypeIndex::_context;
+
+TEST_F(TileElementTypeIndex, FirstElementOfType)
+{
+    // The per tile type index must never hide an element that is on the tile
+    const TileElementType types[] = {
+        TileElementType::Surface,  TileElementType::Path, TileElementType::Track,        TileElementType::SmallScenery,
+        TileElementType::Entrance, TileElementType::Wall, TileElementType::LargeScenery, TileElementType::Banner,
+    };
+    for (int32_t y = 0; y < gMapSize; y++)
+    {
+        for (int32_t x = 0; x < gMapSize; x++)
+        {
+            auto loc = TileCoordsXY{ x, y }.ToCoordsXY();
+            for (auto type : types)
+            {
+                TileElement* expected = nullptr;
+                for (auto* tileElement : TileElementsView<TileElement>(loc))
+                {
+                    if (tileElement->GetType() == static_cast<uint8_t>(type))
+                    {
+                        expected = tileElement;
+                        break;
+                    }
+                }
+                EXPECT_EQ(map_get_first_element_of_type_at(loc, type), expected);
+            }
+        }
+    }
+}
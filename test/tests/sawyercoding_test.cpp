@@ -7,13 +7,124 @@
  * OpenRCT2 is licensed under the GNU General Public License version 3.
  *****************************************************************************/
 
+#include <algorithm>
 #include <gtest/gtest.h>
 #include <openrct2/core/MemoryStream.h>
 #include <openrct2/rct12/SawyerChunkReader.h>
 #include <openrct2/util/SawyerCoding.h>
+#include <vector>
 
 constexpr size_t BUFFER_SIZE = 0x600000;
 
+// Byte by byte versions of the encoders, which the vectorised ones have to match exactly
+static std::vector<uint8_t> scalar_encode_rle(const std::vector<uint8_t>& input)
+{
+    std::vector<uint8_t> output;
+    const uint8_t* src = input.data();
+    const uint8_t* end_src = src + input.size();
+    uint8_t count = 0;
+    const uint8_t* src_norm_start = src;
+
+    while (src < end_src - 1)
+    {
+        if ((count && *src == src[1]) || count > 125)
+        {
+            output.push_back(count - 1);
+            output.insert(output.end(), src_norm_start, src_norm_start + count);
+            src_norm_start += count;
+            count = 0;
+        }
+        if (*src == src[1])
+        {
+            for (; (count < 125) && ((src + count) < end_src); count++)
+            {
+                if (*src != src[count])
+                    break;
+            }
+            output.push_back(257 - count);
+            output.push_back(*src);
+            src += count;
+            src_norm_start = src;
+            count = 0;
+        }
+        else
+        {
+            count++;
+            src++;
+        }
+    }
+    if (src == end_src - 1)
+        count++;
+    if (count)
+    {
+        output.push_back(count - 1);
+        output.insert(output.end(), src_norm_start, src_norm_start + count);
+    }
+    return output;
+}
+
+static std::vector<uint8_t> scalar_encode_repeat(const std::vector<uint8_t>& input)
+{
+    std::vector<uint8_t> output;
+    const size_t length = input.size();
+    if (length == 0)
+        return output;
+
+    output.push_back(255);
+    output.push_back(input[0]);
+    for (size_t i = 1; i < length;)
+    {
+        size_t searchIndex = (i < 32) ? 0 : (i - 32);
+        size_t searchEnd = i - 1;
+
+        size_t bestRepeatIndex = 0;
+        size_t bestRepeatCount = 0;
+        for (size_t repeatIndex = searchIndex; repeatIndex <= searchEnd; repeatIndex++)
+        {
+            size_t repeatCount = 0;
+            size_t maxRepeatCount = std::min(std::min(static_cast<size_t>(7), searchEnd - repeatIndex), length - i - 1);
+            for (size_t j = 0; j <= maxRepeatCount; j++)
+            {
+                if (input[repeatIndex + j] != input[i + j])
+                    break;
+                repeatCount++;
+            }
+            if (repeatCount > bestRepeatCount)
+            {
+                bestRepeatIndex = repeatIndex;
+                bestRepeatCount = repeatCount;
+                if (repeatCount == 8)
+                    break;
+            }
+        }
+
+        if (bestRepeatCount == 0)
+        {
+            output.push_back(255);
+            output.push_back(input[i]);
+            i++;
+        }
+        else
+        {
+            output.push_back(static_cast<uint8_t>((bestRepeatCount - 1) | ((32 - (i - bestRepeatIndex)) << 3)));
+            i += bestRepeatCount;
+        }
+    }
+    return output;
+}
+
+static std::vector<uint8_t> scalar_rotate(const std::vector<uint8_t>& input, bool decode)
+{
+    std::vector<uint8_t> output(input.size());
+    uint8_t code = 1;
+    for (size_t i = 0; i < input.size(); i++)
+    {
+        output[i] = decode ? ror8(input[i], code) : rol8(input[i], code);
+        code = (code + 2) % 8;
+    }
+    return output;
+}
+
 class SawyerCodingTest : public testing::Test
 {
 protected:
@@ -53,6 +164,82 @@ protected:
         delete[] encodedDataBuffer;
     }
 
+    static std::vector<uint8_t> make_repetitive_data(size_t size)
+    {
+        // Runs, repeated sequences and random bytes of lengths that do not line up with any block size
+        std::vector<uint8_t> data;
+        for (size_t i = 0; data.size() < size; i++)
+        {
+            auto value = randomdata[i % sizeof(randomdata)];
+            switch (i % 3)
+            {
+                case 0:
+                    data.insert(data.end(), 1 + value % 200, value);
+                    break;
+                case 1:
+                    for (size_t j = 0; j < 1 + value % 50 && data.size() > 40; j++)
+                        data.push_back(data[data.size() - 1 - value % 40]);
+                    break;
+                case 2:
+                    data.insert(data.end(), randomdata, randomdata + 1 + value % 70);
+                    break;
+            }
+        }
+        return data;
+    }
+
+    void test_encode_decode_repetitive(uint8_t encoding_type)
+    {
+        auto data = make_repetitive_data(40000);
+
+        sawyercoding_chunk_header chdr_in;
+        chdr_in.encoding = encoding_type;
+        chdr_in.length = static_cast<uint32_t>(data.size());
+        std::vector<uint8_t> encodedData(BUFFER_SIZE);
+        size_t encodedDataSize = sawyercoding_write_chunk_buffer(encodedData.data(), data.data(), chdr_in);
+
+        OpenRCT2::MemoryStream ms(encodedData.data(), encodedDataSize);
+        SawyerChunkReader reader(&ms);
+        auto chunk = reader.ReadChunk();
+        ASSERT_EQ(chunk->GetLength(), data.size());
+        auto result = memcmp(chunk->GetData(), data.data(), data.size());
+        ASSERT_EQ(result, 0);
+    }
+
+    void test_encode_matches_scalar(uint8_t encoding_type)
+    {
+        // Every length up to a few blocks, to cover all the ways the vector loops can hand over to the scalar tails
+        auto source = make_repetitive_data(4000);
+        for (size_t length = 1; length <= source.size(); length += (length < 100) ? 1 : 97)
+        {
+            std::vector<uint8_t> data(source.begin(), source.begin() + length);
+
+            std::vector<uint8_t> expected;
+            switch (encoding_type)
+            {
+                case CHUNK_ENCODING_RLE:
+                    expected = scalar_encode_rle(data);
+                    break;
+                case CHUNK_ENCODING_RLECOMPRESSED:
+                    expected = scalar_encode_rle(scalar_encode_repeat(data));
+                    break;
+                case CHUNK_ENCODING_ROTATE:
+                    expected = scalar_rotate(data, false);
+                    break;
+            }
+
+            sawyercoding_chunk_header chdr_in;
+            chdr_in.encoding = encoding_type;
+            chdr_in.length = static_cast<uint32_t>(data.size());
+            std::vector<uint8_t> encodedData(BUFFER_SIZE);
+            size_t encodedDataSize = sawyercoding_write_chunk_buffer(encodedData.data(), data.data(), chdr_in);
+
+            ASSERT_EQ(encodedDataSize, sizeof(sawyercoding_chunk_header) + expected.size()) << "length " << length;
+            auto result = memcmp(encodedData.data() + sizeof(sawyercoding_chunk_header), expected.data(), expected.size());
+            ASSERT_EQ(result, 0) << "length " << length;
+        }
+    }
+
     void test_decode(const uint8_t* data, size_t size)
     {
         auto expectedLength = size - sizeof(sawyercoding_chunk_header);
@@ -89,9 +276,51 @@ TEST_F(SawyerCodingTest, write_read_chunk_rotate)
     test_encode_decode(CHUNK_ENCODING_ROTATE);
 }
 
-// Note we only check if provided data decompresses to the same data, not if it compresses the same.
-// The reason for that is we may improve encoding at some point, but the test won't be affected,
-// as we already do a decode test and roundtrip (encode + decode), which validates all uses.
+TEST_F(SawyerCodingTest, write_read_chunk_rle_repetitive)
+{
+    test_encode_decode_repetitive(CHUNK_ENCODING_RLE);
+}
+
+TEST_F(SawyerCodingTest, write_read_chunk_rle_compressed_repetitive)
+{
+    test_encode_decode_repetitive(CHUNK_ENCODING_RLECOMPRESSED);
+}
+
+TEST_F(SawyerCodingTest, write_read_chunk_rotate_repetitive)
+{
+    test_encode_decode_repetitive(CHUNK_ENCODING_ROTATE);
+}
+
+TEST_F(SawyerCodingTest, encode_chunk_rle_matches_scalar)
+{
+    test_encode_matches_scalar(CHUNK_ENCODING_RLE);
+}
+
+TEST_F(SawyerCodingTest, encode_chunk_rle_compressed_matches_scalar)
+{
+    test_encode_matches_scalar(CHUNK_ENCODING_RLECOMPRESSED);
+}
+
+TEST_F(SawyerCodingTest, encode_chunk_rotate_matches_scalar)
+{
+    test_encode_matches_scalar(CHUNK_ENCODING_ROTATE);
+}
+
+TEST_F(SawyerCodingTest, decode_rotate_matches_scalar)
+{
+    auto data = make_repetitive_data(4000);
+    for (size_t length = 1; length <= data.size(); length += (length < 100) ? 1 : 97)
+    {
+        std::vector<uint8_t> input(data.begin(), data.begin() + length);
+        auto expected = scalar_rotate(input, true);
+        std::vector<uint8_t> decoded(length);
+        sawyercoding_decode_rotate(decoded.data(), input.data(), length);
+        ASSERT_EQ(decoded, expected) << "length " << length;
+    }
+}
+
+// The stored samples below are only checked to decompress to the original data. The encoders are checked to
+// produce exactly the output of the byte by byte versions at the top of this file, as well as to roundtrip.
 
 TEST_F(SawyerCodingTest, decode_chunk_none)
 {